@@ -46,6 +46,10 @@ int main() {
     clientOption->timeout = 5000;
     // readConsistency: EventualConsistency or StrongConsistency
     clientOption->readConsistency = vectordb::EventualConsistency;
+    // channelNum: number of connections, calls are spread over them
+    clientOption->channelNum = 4;
+    // lazyConnect: do not block in the constructor, connect on first call or warmup()
+    clientOption->lazyConnect = false;
     // with ClientOption
     RpcClient cli = RpcClient("url", "username", "key", clientOption);
     // without ClientOption
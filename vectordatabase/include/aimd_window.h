@@ -0,0 +1,67 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <chrono>
+
+namespace vectordb {
+
+// 加性增、乘性减(AIMD)的并发窗口, 由ConcurrencyLimiter和IngestRateController共用, 非线程安全, 由调用方加锁
+// 每一轮(窗口大小个)成功响应使窗口加1, 过载信号使窗口按比例缩小;
+// 上次缩小之前发出的请求所带的过载信号不再缩小窗口, 因此一轮请求最多缩小一次
+class AimdWindow {
+  public:
+    // @param initial: 初始窗口, 限制在[minValue, maxValue]内
+    // @param decreaseFactor: 缩小时窗口乘以的比例
+    AimdWindow(double initial, double minValue, double maxValue, double decreaseFactor);
+
+    double value() const {
+        return value_;
+    }
+
+    // 记录一个成功响应
+    // @return: 窗口是否增大
+    bool onSuccess();
+
+    // 记录一个过载信号
+    // @param sendTime: 请求的发送时间
+    // @return: 是否按该信号缩小了窗口, 窗口已为下限或信号来自上次缩小之前发出的请求时返回false
+    bool onOverload(std::chrono::steady_clock::time_point sendTime);
+
+  private:
+    double value_;
+    double min_;
+    double max_;
+    double decreaseFactor_;
+    // 窗口上次变化后的成功响应数
+    int successes_ = 0;
+    std::chrono::steady_clock::time_point lastDecrease_;
+};
+
+}  // namespace vectordb
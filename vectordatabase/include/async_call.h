@@ -0,0 +1,141 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/completion_queue.h>
+#include <google/protobuf/arena.h>
+
+#include "include/rpc_client.h"
+#include "include/channel_pool.h"
+
+namespace vectordb {
+
+// 异步调用的基类, 作为CompletionQueue的tag, 完成后由轮询线程回调并释放
+class AsyncCallBase {
+  public:
+    virtual ~AsyncCallBase() = default;
+    virtual void onComplete(bool ok) = 0;
+};
+
+template <typename Response>
+class AsyncUnaryCall : public AsyncCallBase {
+  public:
+    using Callback = std::function<void(const grpc::Status&, Response&)>;
+
+    // arena为空时响应分配在调用自身的arena上, 随调用一起释放
+    explicit AsyncUnaryCall(Callback done = nullptr, google::protobuf::Arena* arena = nullptr)
+        : response_(google::protobuf::Arena::CreateMessage<Response>(arena != nullptr ? arena : &arena_)),
+          done_(std::move(done)) {}
+
+    void setCallback(Callback done) {
+        done_ = std::move(done);
+    }
+
+    void onComplete(bool ok) override {
+        if (!ok && status_.ok()) {
+            status_ = grpc::Status(grpc::StatusCode::CANCELLED, "completion queue is shutting down");
+        }
+        done_(status_, *response_);
+    }
+
+  private:
+    google::protobuf::Arena arena_;
+
+  public:
+    grpc::ClientContext context_;
+    Response* response_;
+    grpc::Status status_;
+    std::unique_ptr<grpc::ClientAsyncResponseReader<Response>> reader_;
+    // 持有连接池直到调用完成, 连接池可能在调用进行中被关闭或从路由中移除
+    std::shared_ptr<ChannelPool> pool_;
+    ChannelPool::Lease lease_;
+
+  private:
+    Callback done_;
+};
+
+// 对冲调用的共享状态, 由发起线程与各次调用的完成回调共同持有
+template <typename Response>
+struct HedgedCallState {
+    std::mutex mutex;
+    std::condition_variable cv;
+    // 已发出且尚未完成的调用数
+    int pending = 0;
+    // 已有调用成功, 或所有调用均已失败
+    bool finished = false;
+    grpc::Status status;
+    // 各次调用的响应与成功的响应分配在同一arena上, 交换时无需拷贝
+    google::protobuf::Arena arena;
+    Response* response = google::protobuf::Arena::CreateMessage<Response>(&arena);
+    // 尚未完成的调用的context, 在其完成回调中移除, 用于取消落后的调用
+    std::vector<grpc::ClientContext*> contexts;
+};
+
+// 客户端持有的CompletionQueue线程池, 每个线程轮询一个CompletionQueue
+class CompletionQueuePool {
+  public:
+    explicit CompletionQueuePool(int threadNum);
+    ~CompletionQueuePool();
+
+    CompletionQueuePool(const CompletionQueuePool&) = delete;
+    CompletionQueuePool& operator=(const CompletionQueuePool&) = delete;
+
+    // 轮询选择一个CompletionQueue
+    grpc::CompletionQueue* next();
+
+  private:
+    static void poll(grpc::CompletionQueue* cq);
+
+    std::vector<std::unique_ptr<grpc::CompletionQueue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<size_t> next_{0};
+};
+
+// 将回调式异步接口包装为future
+inline std::future<int> toFuture(const std::function<void(AsyncCallback)>& start) {
+    auto promise = std::make_shared<std::promise<int>>();
+    std::future<int> future = promise->get_future();
+    start([promise](int ret) { promise->set_value(ret); });
+    return future;
+}
+
+}  // namespace vectordb
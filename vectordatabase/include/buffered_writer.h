@@ -0,0 +1,121 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "include/rpc_client.h"
+#include "include/types/document.h"
+
+namespace vectordb {
+
+struct BufferedWriterOption {
+    // MaxDocs: flush once this many documents are buffered, default: 100
+    int maxDocs{100};
+    // MaxBytes: flush once the buffered documents reach this serialized size, default: 1MB
+    int64_t maxBytes{1024 * 1024};
+    // MaxDelay: flush documents buffered longer than this (ms), default: 50
+    int maxDelay{50};
+    // MaxInFlight: max number of flushes outstanding at once, default: 4
+    // with more than one, writes of the same document in different flushes may be applied out of order
+    int maxInFlight{4};
+    // BuildIndex: default: true
+    bool buildIndex{true};
+    // Coalesce: how a write is combined with a buffered document of the same id, default: none
+    // combined writes share one document in the request, and their futures complete together
+    CoalescePolicy coalesce{CoalescePolicy::kNone};
+    // Timeout: timeout of each upsert request, default: 5s
+    int timeout{5000};
+};
+
+// 写缓冲: 多个线程写入的文档先在内存中合并, 达到文档数、字节数或时间阈值时通过一次upsert发送
+class BufferedWriter {
+  public:
+    // @param client: 用于发送请求的客户端, 需保持有效直到BufferedWriter析构
+    // @param dbName: 数据库名称
+    // @param collectionName: 集合名称
+    // @param option: 缓冲配置
+    BufferedWriter(RpcClient* client, const std::string& dbName, const std::string& collectionName,
+        const BufferedWriterOption& option = BufferedWriterOption());
+    // 发送剩余文档并等待所有请求完成
+    ~BufferedWriter();
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    // 写入文档, 可在多个线程中调用
+    // @return: 文档所在请求完成时就绪, 0表示成功,非0表示失败
+    std::future<int> write(const Document& document);
+    std::future<int> write(Document&& document);
+
+    // 立即发送缓冲中的文档并等待所有请求完成
+    // @return: 0表示上次flush以来的请求均成功,非0表示存在失败的请求
+    int flush();
+
+  private:
+    struct Batch {
+        olama::UpsertRequest request;
+        std::vector<std::promise<int>> promises;
+        // 文档id在request中的位置, 仅在开启coalesce时使用
+        std::unordered_map<std::string, int> slots;
+    };
+
+    // 将转换后的文档加入缓冲, 达到阈值时发送
+    std::future<int> append(olama::Document* document);
+    // 取出缓冲中的文档, 调用方需持有mutex_
+    std::unique_ptr<Batch> takePending();
+    void send(std::unique_ptr<Batch> batch);
+    void timerLoop();
+
+    RpcClient* client_;
+    std::string dbName_;
+    std::string collectionName_;
+    BufferedWriterOption option_;
+
+    std::mutex mutex_;
+    std::condition_variable timerCv_;
+    std::condition_variable windowCv_;
+    std::unique_ptr<Batch> pending_;
+    int64_t pendingBytes_ = 0;
+    std::chrono::steady_clock::time_point pendingSince_;
+    int inFlight_ = 0;
+    bool failed_ = false;
+    bool stopped_ = false;
+    std::thread timer_;
+};
+
+}  // namespace vectordb
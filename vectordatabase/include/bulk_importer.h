@@ -0,0 +1,215 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+#include "include/import_journal.h"
+#include "include/ingest_rate_controller.h"
+#include "include/rpc_client.h"
+
+namespace vectordb {
+
+enum class VectorFileFormat {
+    // 按扩展名判断: .fvecs/.bvecs/.npy
+    kAuto,
+    // 每行为int32维度 + float32向量
+    kFvecs,
+    // 每行为int32维度 + uint8向量
+    kBvecs,
+    // 二维float32/float64/uint8数组, 按行存储
+    kNpy,
+};
+
+// 只读映射的向量文件, 按行读取, 不将整个文件读入内存
+class VectorFileReader {
+  public:
+    VectorFileReader() = default;
+    ~VectorFileReader();
+
+    VectorFileReader(const VectorFileReader&) = delete;
+    VectorFileReader& operator=(const VectorFileReader&) = delete;
+
+    // @return: 0表示成功,非0表示失败, 失败原因见message()
+    int open(const std::string& path, VectorFileFormat format = VectorFileFormat::kAuto);
+
+    size_t rows() const {
+        return rows_;
+    }
+    size_t dim() const {
+        return dim_;
+    }
+    const std::string& message() const {
+        return message_;
+    }
+
+    // 将第row行追加到vector, float32数据直接整体拷贝, 其他类型逐个转换
+    // @return: 0表示成功, fvecs/bvecs的该行维度与首行不一致时返回-1且不修改vector
+    int appendRow(size_t row, google::protobuf::RepeatedField<float>* vector) const;
+
+  private:
+    enum class ElementType { kFloat32, kFloat64, kUint8 };
+
+    int fail(const std::string& message);
+    int parseNpyHeader();
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    size_t rows_ = 0;
+    size_t dim_ = 0;
+    // 第一行数据的偏移, 及相邻行的间隔
+    size_t offset_ = 0;
+    size_t rowStride_ = 0;
+    // fvecs/bvecs每行数据前有uint32维度
+    bool dimPrefix_ = false;
+    ElementType type_ = ElementType::kFloat32;
+    std::string message_;
+};
+
+// 将JSONL中的一行解析为文档的id及标量字段, 支持的JSON子集及字段类型见JsonLineParser
+// @return: 0表示成功,非0表示失败
+int parseSidecarLine(std::string_view line, const std::string& idField, olama::Document* doc,
+    std::string* message);
+
+struct BulkImportOption {
+    // Format: vector file format, default: by file extension
+    VectorFileFormat format{VectorFileFormat::kAuto};
+    // SidecarPath: JSONL file with the id and fields of each row, line i for row i, default: none
+    // without a sidecar the row number is used as the id
+    std::string sidecarPath;
+    // IdField: name of the id in the sidecar, default: id
+    std::string idField{"id"};
+    // BatchRows: number of rows handed to a worker at a time, default: 1000
+    int batchRows{1000};
+    // BatchBytes: max serialized size of one upsert request, default: 4MB
+    int64_t batchBytes{4 * 1024 * 1024};
+    // WorkerNum: number of threads parsing and serializing rows, default: 4
+    int workerNum{4};
+    // MaxInFlight: max number of upsert requests outstanding at once, default: 8
+    int maxInFlight{8};
+    // AdaptiveInFlight: shrink and regrow the window within [1, MaxInFlight] from server warnings,
+    // throttling errors and latency, default: false
+    bool adaptiveInFlight{false};
+    // BuildIndex: default: true
+    bool buildIndex{true};
+    // Timeout: timeout of each upsert request, default: 10s
+    int timeout{10000};
+    // JournalPath: local progress journal, an interrupted import resumes from it when run again, default: none
+    // batches that were sent but not acknowledged are checked by id and only missing rows are sent again
+    std::string journalPath;
+};
+
+struct BulkImportStats {
+    int64_t rows = 0;
+    int64_t bytes = 0;
+    int64_t requests = 0;
+    int64_t affectedCount = 0;
+    // 日志中已确认的行数, 及续传时按id确认已存在而跳过的行数
+    int64_t resumedRows = 0;
+    int64_t verifiedRows = 0;
+    // 判定为服务端限流的请求数, 及结束时允许同时进行的请求数
+    int64_t throttledRequests = 0;
+    int inFlightLimit = 0;
+    double seconds = 0;
+    double rowsPerSecond = 0;
+    double bytesPerSecond = 0;
+    // 首个失败的原因
+    std::string message;
+};
+
+// 从向量文件及JSONL导入集合: 文件以只读方式映射, 各工作线程按行区间解析并直接构建upsert请求,
+// 同时进行的请求数不超过maxInFlight; 遇到首个错误后停止导入
+// 配置journalPath时, 每批行的所有请求成功后由导入线程写入日志, 再次运行时跳过已确认的批次
+class BulkImporter {
+  public:
+    // @param client: 用于发送请求的客户端
+    // @param dbName: 数据库名称
+    // @param collectionName: 集合名称
+    // @param option: 导入配置
+    BulkImporter(RpcClient* client, const std::string& dbName, const std::string& collectionName,
+        const BulkImportOption& option = BulkImportOption());
+
+    // 导入文件, 返回前等待所有请求完成
+    // @param vectorPath: 向量文件路径
+    // @param stats: 导入统计
+    // @return: 0表示成功,非0表示失败
+    int run(const std::string& vectorPath, BulkImportStats* stats = nullptr);
+
+  private:
+    // 一个工作线程处理的行区间及其在JSONL中的字节区间
+    struct Task {
+        size_t beginRow;
+        size_t endRow;
+        size_t sidecarBegin;
+        size_t sidecarEnd;
+    };
+
+    // 一批行的请求进度, 最后一个请求完成时若均成功则加入待写日志的队列
+    struct TaskProgress;
+
+    void workerLoop(const VectorFileReader* reader, const char* sidecar);
+    int processTask(const Task& task, const VectorFileReader* reader, const char* sidecar);
+    int existingIds(const Task& task, const char* sidecar, std::unordered_set<std::string>* ids);
+    void send(const olama::UpsertRequest& request, int64_t rows, const std::shared_ptr<TaskProgress>& progress);
+    void finishRequest(const std::shared_ptr<TaskProgress>& progress);
+    void writeAcked(std::unique_lock<std::mutex>* lock);
+    void fail(const std::string& message);
+    bool failed();
+    int inFlightLimit() const;
+
+    RpcClient* client_;
+    std::string dbName_;
+    std::string collectionName_;
+    BulkImportOption option_;
+    ImportJournal journal_;
+    std::unique_ptr<IngestRateController> rateController_;
+
+    std::mutex mutex_;
+    std::condition_variable queueNotFull_;
+    std::condition_variable queueNotEmpty_;
+    std::condition_variable windowAvailable_;
+    std::deque<Task> queue_;
+    // 已确认但未写入日志的批次, 由等待windowAvailable_的导入线程写入, 不占用完成队列线程
+    std::deque<std::shared_ptr<TaskProgress>> acked_;
+    bool closed_ = false;
+    bool failed_ = false;
+    int inFlight_ = 0;
+    BulkImportStats stats_;
+};
+
+}  // namespace vectordb
@@ -0,0 +1,143 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "include/ingest_rate_controller.h"
+#include "include/rpc_client.h"
+#include "include/types/document.h"
+
+namespace vectordb {
+
+struct BulkWriterOption {
+    // BatchDocs: number of documents handed to a worker at a time, default: 1000
+    int batchDocs{1000};
+    // BatchBytes: max serialized size of one upsert request, default: 4MB
+    int64_t batchBytes{4 * 1024 * 1024};
+    // WorkerNum: number of threads serializing batches, default: 2
+    int workerNum{2};
+    // MaxInFlight: max number of upsert requests outstanding at once, default: 4
+    int maxInFlight{4};
+    // AdaptiveInFlight: shrink and regrow the window within [1, MaxInFlight] from server warnings,
+    // throttling errors and latency, default: false
+    bool adaptiveInFlight{false};
+    // MaxQueuedBatches: batches waiting for a worker before write() blocks, default: 8
+    int maxQueuedBatches{8};
+    // BuildIndex: default: true
+    bool buildIndex{true};
+    // Coalesce: how documents with the same id inside one batch are combined, default: none
+    CoalescePolicy coalesce{CoalescePolicy::kNone};
+    // Timeout: timeout of each upsert request, default: 10s
+    int timeout{10000};
+};
+
+struct BulkWriterStats {
+    int64_t documents = 0;
+    int64_t bytes = 0;
+    int64_t batches = 0;
+    int64_t failedBatches = 0;
+    int64_t failedDocuments = 0;
+    int64_t affectedCount = 0;
+    // 因与同批次中相同id的文档合并而未单独发送的文档数
+    int64_t coalescedDocuments = 0;
+    // 判定为服务端限流的请求数, 及当前允许同时进行的请求数
+    int64_t throttledBatches = 0;
+    int inFlightLimit = 0;
+    double seconds = 0;
+    double docsPerSecond = 0;
+    double bytesPerSecond = 0;
+    // 首个失败请求的错误信息
+    std::string message;
+};
+
+// 批量导入: 工作线程在已发送的请求等待响应期间序列化后续批次, 同时进行的请求数不超过maxInFlight,
+// 待处理批次达到上限时write()阻塞调用方
+class BulkWriter {
+  public:
+    // @param client: 用于发送请求的客户端, 需保持有效直到close()返回
+    // @param dbName: 数据库名称
+    // @param collectionName: 集合名称
+    // @param option: 导入配置
+    BulkWriter(RpcClient* client, const std::string& dbName, const std::string& collectionName,
+        const BulkWriterOption& option = BulkWriterOption());
+    ~BulkWriter();
+
+    BulkWriter(const BulkWriter&) = delete;
+    BulkWriter& operator=(const BulkWriter&) = delete;
+
+    // 写入文档, 可在多个线程中调用
+    // @return: 0表示成功,已调用close()时返回-1
+    int write(const Document& document);
+    int write(Document&& document);
+    int write(const std::vector<Document>& documents);
+
+    // 发送剩余文档并等待所有请求完成
+    // @param stats: 导入统计
+    // @return: 0表示全部成功,非0表示存在失败的请求
+    int close(BulkWriterStats* stats = nullptr);
+
+    // 当前已完成请求的统计
+    BulkWriterStats stats();
+
+  private:
+    // 将pending_交给工作线程, 队列已满时在lock上等待
+    void enqueuePending(std::unique_lock<std::mutex>* lock);
+    void workerLoop();
+    void send(const olama::UpsertRequest& request);
+    void fillRates(BulkWriterStats* stats) const;
+    int inFlightLimit() const;
+
+    RpcClient* client_;
+    std::string dbName_;
+    std::string collectionName_;
+    BulkWriterOption option_;
+    std::unique_ptr<IngestRateController> rateController_;
+
+    std::mutex mutex_;
+    std::condition_variable queueNotFull_;
+    std::condition_variable queueNotEmpty_;
+    std::condition_variable windowAvailable_;
+    std::deque<std::vector<Document>> queue_;
+    std::vector<Document> pending_;
+    bool closed_ = false;
+    int inFlight_ = 0;
+    BulkWriterStats stats_;
+    std::chrono::steady_clock::time_point start_;
+    std::vector<std::thread> workers_;
+};
+
+}  // namespace vectordb
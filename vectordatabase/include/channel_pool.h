@@ -0,0 +1,124 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/channel.h>
+
+#include "proto/olama.pb.h"
+#include "proto/olama.grpc.pb.h"
+
+namespace vectordb {
+
+enum class ChannelSelectPolicy {
+    // 按顺序轮流使用各连接
+    kRoundRobin,
+    // 选择当前未完成请求最少的连接
+    kLeastOutstanding,
+};
+
+// 到同一服务地址的多连接池, 每个连接使用不同的channel参数创建, 保证不会复用同一个subchannel
+// 可通过ClientOption::channelPool在多个RpcClient之间共享
+class ChannelPool {
+  private:
+    struct Entry {
+        std::shared_ptr<grpc::Channel> channel;
+        std::unique_ptr<olama::SearchEngine::Stub> stub;
+        std::atomic<int64_t> outstanding{0};
+    };
+
+  public:
+    // 一次调用对连接的占用, 析构时释放未完成请求计数
+    class Lease {
+      public:
+        Lease() = default;
+        explicit Lease(Entry* entry) : entry_(entry) {}
+        Lease(Lease&& other) noexcept : entry_(other.entry_) {
+            other.entry_ = nullptr;
+        }
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+
+        olama::SearchEngine::Stub* operator->() const {
+            return entry_->stub.get();
+        }
+        olama::SearchEngine::Stub* stub() const {
+            return entry_ == nullptr ? nullptr : entry_->stub.get();
+        }
+        grpc::Channel* channel() const {
+            return entry_ == nullptr ? nullptr : entry_->channel.get();
+        }
+
+      private:
+        Entry* entry_ = nullptr;
+    };
+
+    // @param url: 服务器地址
+    // @param username: 用户名
+    // @param key: 认证密钥
+    // @param channelNum: 连接数量, 小于1时按1处理
+    // @param reconnectBackoff: 初始重连退避时间(毫秒)
+    // @param policy: 连接选择策略
+    ChannelPool(const std::string& url, const std::string& username, const std::string& key,
+        int channelNum = 1, int reconnectBackoff = 5000,
+        ChannelSelectPolicy policy = ChannelSelectPolicy::kRoundRobin);
+
+    ChannelPool(const ChannelPool&) = delete;
+    ChannelPool& operator=(const ChannelPool&) = delete;
+
+    // 按选择策略获取一个连接
+    Lease acquire();
+
+    // 触发所有连接开始建立, 不等待结果
+    void connect();
+
+    // 等待所有连接建立, 超时返回false
+    bool waitForConnected(int timeout);
+
+    size_t size() const {
+        return entries_.size();
+    }
+
+    // 各连接当前未完成的请求数
+    std::vector<int64_t> outstanding() const;
+
+  private:
+    std::vector<std::unique_ptr<Entry>> entries_;
+    ChannelSelectPolicy policy_;
+    std::atomic<uint64_t> next_{0};
+};
+
+}  // namespace vectordb
@@ -0,0 +1,136 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "include/rpc_client.h"
+
+namespace vectordb {
+
+// 导出的每个文档调用一次, 同一时刻只有一个线程调用
+// 返回非0时停止导出或读取, 此时run和readExportFile返回非0
+using ExportCallback = std::function<int(Document&& document)>;
+
+struct CollectionExportOption {
+    // Filter: only export documents matching this filter, default: none
+    std::string filter;
+    // RangeFilters: scan ranges exported independently, they must not overlap, default: none
+    // when empty, ranges are generated from SplitField, or the collection is exported as one range
+    std::vector<std::string> rangeFilters;
+    // SplitField: uint64 field used to split the collection into SplitCount ranges of [SplitMin, SplitMax]
+    std::string splitField;
+    uint64_t splitMin{0};
+    uint64_t splitMax{0};
+    int splitCount{16};
+    // Parallelism: number of ranges scanned at once, default: 4
+    int parallelism{4};
+    // PageSize: number of documents per query, default: 1000
+    int pageSize{1000};
+    // RetrieveVector: default: true
+    bool retrieveVector{true};
+    // OutputFields: fields to export, default: all
+    std::vector<std::string> outputFields;
+    // Timeout: timeout of each query, default: 10s
+    int timeout{10000};
+};
+
+struct CollectionExportStats {
+    int64_t documents = 0;
+    int64_t pages = 0;
+    int64_t ranges = 0;
+    // 导出到文件时写入的字节数
+    int64_t bytes = 0;
+    double seconds = 0;
+    double docsPerSecond = 0;
+    double bytesPerSecond = 0;
+    // 首个失败的原因
+    std::string message;
+};
+
+// 全量导出集合: 按过滤条件将集合划分为互不重叠的区间, 各区间并行分页查询,
+// 处理当前页时已发出下一页的请求; 每个区间内仍按offset翻页, 区间越小翻页越浅
+class CollectionExporter {
+  public:
+    // @param client: 用于发送请求的客户端
+    // @param dbName: 数据库名称
+    // @param collectionName: 集合名称
+    // @param option: 导出配置
+    CollectionExporter(RpcClient* client, const std::string& dbName, const std::string& collectionName,
+        const CollectionExportOption& option = CollectionExportOption());
+
+    // 导出到回调
+    // @param callback: 每个文档调用一次
+    // @param stats: 导出统计
+    // @return: 0表示成功,非0表示失败或被回调中止
+    int run(const ExportCallback& callback, CollectionExportStats* stats = nullptr);
+
+    // 导出到二进制文件, 可通过readExportFile读取
+    // @param path: 文件路径
+    // @param stats: 导出统计
+    // @return: 0表示成功,非0表示失败
+    int runToFile(const std::string& path, CollectionExportStats* stats = nullptr);
+
+    // 将[min, max]按field均分为count个区间, 返回各区间的过滤条件
+    static std::vector<std::string> splitFilters(const std::string& field, uint64_t min, uint64_t max, int count);
+
+  private:
+    std::vector<std::string> buildRanges() const;
+    void scanRanges(const std::vector<std::string>* ranges, std::atomic<size_t>* next);
+    int scanRange(const std::string& filter);
+    int deliver(std::vector<Document>* documents);
+    void fail(const std::string& message);
+    bool stopped();
+
+    RpcClient* client_;
+    std::string dbName_;
+    std::string collectionName_;
+    CollectionExportOption option_;
+
+    const ExportCallback* callback_ = nullptr;
+    std::mutex deliverMutex_;
+    std::mutex mutex_;
+    bool stopped_ = false;
+    int ret_ = 0;
+    CollectionExportStats stats_;
+};
+
+// 读取CollectionExporter::runToFile生成的文件
+// @param path: 文件路径
+// @param callback: 每个文档调用一次, 返回非0时停止读取
+// @param message: 失败原因
+// @return: 0表示成功读完整个文件,非0表示失败或被回调中止
+int readExportFile(const std::string& path, const ExportCallback& callback, std::string* message = nullptr);
+
+}  // namespace vectordb
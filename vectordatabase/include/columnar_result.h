@@ -0,0 +1,103 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "proto/olama.pb.h"
+#include "include/search_result_view.h"
+
+namespace vectordb {
+
+enum class ColumnType {
+    // 尚未出现该字段
+    kNone,
+    kU64,
+    kDouble,
+    kString,
+};
+
+// 一组结果中某个字段的列, 类型取自首个包含该字段的文档, 类型不同或缺少该字段的文档valid为0
+struct FieldColumn {
+    ColumnType type = ColumnType::kNone;
+    std::vector<uint8_t> valid;
+    std::vector<uint64_t> u64s;
+    std::vector<double> doubles;
+    // 字符串拼接存储, 第i个值为strings[stringOffsets[i], stringOffsets[i + 1])
+    std::string strings;
+    std::vector<uint32_t> stringOffsets;
+
+    std::string_view str(size_t i) const {
+        return std::string_view(strings).substr(stringOffsets[i], stringOffsets[i + 1] - stringOffsets[i]);
+    }
+};
+
+// 列式存储的单个检索向量的结果
+struct ColumnarResultSet {
+    size_t size = 0;
+    // id拼接存储, 第i个id为ids[idOffsets[i], idOffsets[i + 1])
+    std::string ids;
+    std::vector<uint32_t> idOffsets;
+    std::vector<float> scores;
+    // 返回向量时为size * dim的行存矩阵, 否则为空
+    size_t dim = 0;
+    std::vector<float> vectors;
+    // outputFields中各字段的列, 与outputFields顺序相同
+    std::vector<std::string> fieldNames;
+    std::vector<FieldColumn> fields;
+
+    std::string_view id(size_t i) const {
+        return std::string_view(ids).substr(idOffsets[i], idOffsets[i + 1] - idOffsets[i]);
+    }
+
+    FloatSpan vector(size_t i) const {
+        return vectors.empty() ? FloatSpan() : FloatSpan{vectors.data() + i * dim, dim};
+    }
+
+    // 返回名为name的列, 不存在时返回nullptr
+    const FieldColumn* field(const std::string& name) const;
+};
+
+struct ColumnarSearchResult {
+    bool success = false;
+    std::string message;
+    std::string warning;
+    // 每个检索向量一组结果
+    std::vector<ColumnarResultSet> results;
+};
+
+// 一次遍历响应, 将各组结果追加到result->results
+// @param columns: 需要转为列的字段
+void fillColumnarResult(const olama::SearchResponse& response, const std::vector<std::string>& columns,
+    ColumnarSearchResult* result);
+
+}  // namespace vectordb
@@ -0,0 +1,123 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "include/aimd_window.h"
+
+namespace vectordb {
+
+// 按database/collection的自适应并发限制(AIMD): 请求成功时缓慢提高并发上限,
+// 出现超时/过载错误或延迟超过阈值时按比例降低上限, 一轮请求最多降低一次
+struct ConcurrencyLimitOption {
+    // 是否开启, 默认关闭
+    bool enabled = false;
+    int initialLimit = 20;
+    int minLimit = 1;
+    int maxLimit = 500;
+    // 过载时上限的缩减比例
+    double backoffRatio = 0.9;
+    // 延迟阈值(毫秒), 超过视为过载, 0表示仅根据错误判断
+    int latencyThreshold = 0;
+    // 最大排队等待请求数, 超过后直接拒绝
+    int maxQueue = 1000;
+};
+
+struct ConcurrencyLimiterStats {
+    // 当前并发上限
+    double limit = 0;
+    // 执行中的请求数
+    int64_t inFlight = 0;
+    // 排队等待的请求数
+    int64_t queued = 0;
+    // 获得许可的请求数
+    uint64_t accepted = 0;
+    // 因排队超时或队列已满被拒绝的请求数
+    uint64_t rejected = 0;
+    // 被判定为过载的请求数
+    uint64_t overloaded = 0;
+};
+
+class ConcurrencyLimiter {
+  public:
+    explicit ConcurrencyLimiter(const ConcurrencyLimitOption& option);
+
+    // 在deadline前获取执行许可, 失败返回false
+    bool acquire(std::chrono::system_clock::time_point deadline);
+
+    // 不等待, 立即尝试获取执行许可
+    bool tryAcquire();
+
+    // 释放许可, 并根据本次请求是否过载及延迟调整并发上限
+    // @param start: 请求获得许可的时间, 早于上次降低上限的请求不再降低上限
+    void release(bool overloaded, std::chrono::steady_clock::time_point start);
+
+    ConcurrencyLimiterStats stats();
+
+  private:
+    bool hasSlot() const {
+        return inFlight_ < static_cast<int64_t>(limit_.value());
+    }
+
+    ConcurrencyLimitOption option_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    AimdWindow limit_;
+    int64_t inFlight_ = 0;
+    int64_t queued_ = 0;
+    uint64_t accepted_ = 0;
+    uint64_t rejected_ = 0;
+    uint64_t overloaded_ = 0;
+};
+
+// 以database/collection为键的ConcurrencyLimiter集合
+class ConcurrencyLimiterGroup {
+  public:
+    explicit ConcurrencyLimiterGroup(const ConcurrencyLimitOption& option) : option_(option) {}
+
+    ConcurrencyLimiter* get(const std::string& key);
+
+    std::map<std::string, ConcurrencyLimiterStats> stats();
+
+  private:
+    ConcurrencyLimitOption option_;
+    std::shared_mutex mutex_;
+    std::unordered_map<std::string, std::unique_ptr<ConcurrencyLimiter>> limiters_;
+};
+
+}  // namespace vectordb
@@ -0,0 +1,102 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <google/protobuf/arena.h>
+
+#include "proto/olama.pb.h"
+
+namespace vectordb {
+
+// 直接构建olama::UpsertRequest, 省去Document及其字段表的中间表示, 构建结果通过RpcClient::upsert(request)发送
+// 用法: builder.addDocument("id").setVector(data, dim).addFieldStr("name", "value");
+class DocumentBatchBuilder {
+  public:
+    // @param dbName: 数据库名称
+    // @param collectionName: 集合名称
+    // @param buildIndex: 是否构建索引
+    // @param arena: 非空时请求分配在arena上, arena需在builder及请求使用完毕前保持有效
+    DocumentBatchBuilder(const std::string& dbName, const std::string& collectionName, bool buildIndex = true,
+        google::protobuf::Arena* arena = nullptr);
+    ~DocumentBatchBuilder();
+
+    DocumentBatchBuilder(const DocumentBatchBuilder&) = delete;
+    DocumentBatchBuilder& operator=(const DocumentBatchBuilder&) = delete;
+
+    // 开始一个新文档, 之后的set/add调用作用于该文档
+    // 在第一次addDocument之前调用set/add不修改请求, 只记录错误, 见status()
+    DocumentBatchBuilder& addDocument(const std::string& id);
+    DocumentBatchBuilder& setVector(const float* data, size_t dim);
+    DocumentBatchBuilder& setVector(const std::vector<float>& vector);
+    DocumentBatchBuilder& addFieldStr(const std::string& name, const std::string& value);
+    DocumentBatchBuilder& addFieldStr(const std::string& name, std::string&& value);
+    DocumentBatchBuilder& addFieldU64(const std::string& name, uint64_t value);
+    DocumentBatchBuilder& addFieldDouble(const std::string& name, double value);
+    DocumentBatchBuilder& addFieldStrArr(const std::string& name, const std::vector<std::string>& value);
+
+    // 已添加的文档数
+    size_t size() const;
+
+    // 请求序列化后的字节数, 可用于在超过上限前发送
+    size_t byteSize() const;
+
+    const olama::UpsertRequest& request() const {
+        return *request_;
+    }
+
+    // 构建过程中是否出错, 出错后应丢弃本批请求
+    // @return: 0表示成功,非0表示失败, 失败原因见message()
+    int status() const {
+        return message_.empty() ? 0 : -1;
+    }
+    const std::string& message() const {
+        return message_;
+    }
+
+    // 清除已添加的文档及记录的错误, 保留database/collection等请求参数
+    void clear();
+
+  private:
+    // 当前文档, 尚未调用addDocument时记录错误并返回nullptr
+    olama::Document* current(const char* method);
+
+    google::protobuf::Arena* arena_;
+    olama::UpsertRequest* request_;
+    size_t headerSize_;
+    // 除当前文档外已添加文档的编码长度之和
+    size_t finishedSize_ = 0;
+    // 第一个错误
+    std::string message_;
+};
+
+}  // namespace vectordb
@@ -0,0 +1,74 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace vectordb {
+
+// 只读请求(search/query/count)的对冲策略: 首个请求在delay内未返回时, 发送一份相同的请求,
+// 先成功返回的结果生效, 另一个请求通过ClientContext::TryCancel取消
+struct HedgingPolicy {
+    // 是否开启对冲, 默认关闭
+    bool enabled = false;
+    // 发送对冲请求前的等待时间(毫秒)
+    int delay = 50;
+    // 是否根据观测到的延迟分位数自适应调整等待时间, 样本不足minSamples时使用delay
+    bool adaptive = false;
+    double percentile = 0.95;
+    int minSamples = 100;
+};
+
+// 固定窗口的延迟统计, 用于估计延迟分位数
+class LatencyTracker {
+  public:
+    explicit LatencyTracker(size_t capacity = 1024);
+
+    // 记录一次请求延迟(微秒)
+    void add(int64_t latencyUs);
+
+    // 返回窗口内样本的分位数(微秒), 样本数不足minSamples时返回-1
+    int64_t percentile(double p, size_t minSamples = 1);
+
+    size_t sampleCount();
+
+  private:
+    std::mutex mutex_;
+    std::vector<int64_t> samples_;
+    size_t capacity_;
+    size_t next_ = 0;
+    // 分位数缓存, 每新增refreshInterval个样本重新计算一次
+    double cachedP_ = -1;
+    int64_t cachedValue_ = -1;
+    size_t addsSinceRefresh_ = 0;
+};
+
+}  // namespace vectordb
@@ -28,7 +28,9 @@
 
 #pragma once
 
+#include <deque>
 #include <string>
+#include <vector>
 
 #include "proto/olama.pb.h"
 #include "proto/olama.grpc.pb.h"
@@ -39,6 +41,22 @@ namespace vectordb {
 
 void toCollection(const olama::CreateCollectionRequest& collectionItem, Collection* collection);
 void convertField2Proto(const Field& field, olama::Field* protoField);
+// 将字符串及字符串数组移动到protoField, 调用后field中的字符串为空
+void convertField2Proto(Field&& field, olama::Field* protoField);
 void convertProto2Field(const olama::Field& protoField, Field* field);
+// 将dim个连续的float追加到vector, 一次预留空间后整体拷贝
+void copyVector2Proto(const float* data, size_t dim, google::protobuf::RepeatedField<float>* vector);
+void convertDocument2Proto(const Document& doc, olama::Document* protoDoc);
+void convertDocument2Proto(Document&& doc, olama::Document* protoDoc);
+// 文档在UpsertRequest中的编码长度: tag + 长度前缀 + 文档内容
+size_t encodedDocumentSize(const olama::Document& protoDoc);
+// 按policy合并相同id的文档, 返回需写入的文档, 各id保持首次出现的位置
+// 合并字段产生的新文档存放在merged中, 需与返回值同时保持有效
+std::vector<const Document*> coalesceDocuments(const std::vector<Document>& documents, CoalescePolicy policy,
+    std::deque<Document>* merged);
+// 同coalesceDocuments, 合并字段时直接将被覆盖文档的字段移动到最后一次写入的文档中
+std::vector<Document*> coalesceOwnedDocuments(std::vector<Document>* documents, CoalescePolicy policy);
+// 将earlier中未被latest覆盖的字段合并到latest, latest的vector为空时沿用earlier的vector
+void mergeDocumentFields(const olama::Document& earlier, olama::Document* latest);
 
 }  // namespace vectordb
@@ -0,0 +1,91 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace vectordb {
+
+// 导入进度日志: 逐行追加已开始发送(S)及已确认(A)的行区间, 用于中断后从已确认的位置续传
+// 格式: "source <描述>" / "S <beginRow> <endRow>" / "A <beginRow> <endRow> <affectedCount>"
+class ImportJournal {
+  public:
+    ImportJournal() = default;
+    ~ImportJournal();
+
+    ImportJournal(const ImportJournal&) = delete;
+    ImportJournal& operator=(const ImportJournal&) = delete;
+
+    // 打开或创建日志, 日志已存在时加载进度, 并校验其数据源与source一致
+    // @param path: 日志文件路径
+    // @param source: 数据源描述, 如文件路径及行数
+    // @return: 0表示成功,非0表示失败, 失败原因见message()
+    int open(const std::string& path, const std::string& source);
+    void close();
+
+    // 区间内的行是否均已确认
+    bool acked(size_t beginRow, size_t endRow) const;
+    // 区间内是否有行已开始发送但未确认, 这些行可能已部分写入
+    bool started(size_t beginRow, size_t endRow) const;
+
+    // 记录区间已开始发送, 需在发送首个请求前调用
+    int markStarted(size_t beginRow, size_t endRow);
+    // 记录区间内的请求均已成功, 写入后同步到磁盘
+    int markAcked(size_t beginRow, size_t endRow, int64_t affectedCount);
+
+    // 已确认的行数及affectedCount之和
+    int64_t ackedRows() const;
+    int64_t affectedCount() const;
+
+    // 最近一次失败的原因, 其他线程可能同时写入, 因此返回副本
+    std::string message() const;
+
+  private:
+    using RangeMap = std::map<size_t, size_t>;
+
+    static void insertRange(RangeMap* ranges, size_t beginRow, size_t endRow);
+    static bool covers(const RangeMap& ranges, size_t beginRow, size_t endRow);
+    static bool overlaps(const RangeMap& ranges, size_t beginRow, size_t endRow);
+    int append(const std::string& line);
+
+    mutable std::mutex mutex_;
+    FILE* file_ = nullptr;
+    // 合并后的区间, beginRow -> endRow
+    RangeMap acked_;
+    RangeMap started_;
+    int64_t affectedCount_ = 0;
+    std::string message_;
+};
+
+}  // namespace vectordb
@@ -0,0 +1,95 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+#include "include/aimd_window.h"
+#include "include/types/document.h"
+
+namespace vectordb {
+
+struct IngestRateOption {
+    // MinInFlight/MaxInFlight: bounds of the upsert window, default: 1/16
+    int minInFlight{1};
+    int maxInFlight{16};
+    // InitialInFlight: window before any response is seen, default: 4
+    int initialInFlight{4};
+    // DecreaseFactor: window multiplier on a throttle signal, default: 0.5
+    double decreaseFactor{0.5};
+    // LatencyFactor: latency EWMA above LatencyFactor * baseline counts as a throttle signal, 0 disables, default: 2
+    double latencyFactor{2.0};
+};
+
+struct IngestRateStats {
+    int window = 0;
+    // 判定为限流的响应数, 及窗口缩小、增大的次数
+    int64_t throttled = 0;
+    int64_t decreases = 0;
+    int64_t increases = 0;
+    double latencyMs = 0;
+    double baselineMs = 0;
+};
+
+// 写入速率控制: 按AIMD调整同时进行的upsert请求数
+// 服务端警告、限流类错误或延迟相对基线明显升高时窗口按比例缩小, 其余成功响应使窗口每轮增加1
+// 缩小窗口前发出的请求所带的信号不再缩小窗口, 因此一轮请求最多缩小一次
+class IngestRateController {
+  public:
+    explicit IngestRateController(const IngestRateOption& option = IngestRateOption());
+
+    // 当前允许同时进行的请求数
+    int window() const;
+
+    // 记录一个请求的结果
+    // @param ret: 请求的返回值
+    // @param result: 请求的结果
+    // @param sendTime: 请求的发送时间
+    // @return: 是否判定为限流
+    bool onResponse(int ret, const UpsertDocumentResult& result, std::chrono::steady_clock::time_point sendTime);
+
+    // 结果是否表示服务端处于写入压力下: 带有警告, 或gRPC状态为RESOURCE_EXHAUSTED/UNAVAILABLE/DEADLINE_EXCEEDED,
+    // 或服务端错误信息表明请求被限流
+    static bool throttled(int ret, const UpsertDocumentResult& result);
+
+    IngestRateStats stats() const;
+
+  private:
+    IngestRateOption option_;
+    mutable std::mutex mutex_;
+    AimdWindow window_;
+    double latencyUs_ = 0;
+    double baselineUs_ = 0;
+    int64_t samples_ = 0;
+    IngestRateStats stats_;
+};
+
+}  // namespace vectordb
@@ -0,0 +1,72 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "proto/olama.pb.h"
+
+namespace vectordb {
+
+// 只支持JSONL sidecar所需的子集: 单层对象, 值为字符串、数字、布尔、null或字符串数组
+// 字符串、非负整数、浮点数、字符串数组分别对应val_str/val_u64/val_double/val_str_arr, true/false按1/0处理, null被忽略
+class JsonLineParser {
+  public:
+    explicit JsonLineParser(std::string_view text) : p_(text.data()), end_(text.data() + text.size()) {}
+
+    // 将整行解析为文档的id及标量字段, 每个对象只能解析一次
+    // @param idField: 作为文档id的字段名, 值为字符串或非负整数
+    // @return: 0表示成功,非0表示失败, 失败原因见message()
+    int parse(const std::string& idField, olama::Document* doc);
+
+    const std::string& message() const {
+        return message_;
+    }
+
+  private:
+    int fail(const std::string& message);
+    void skipSpace();
+    bool consume(char c);
+    bool consumeLiteral(const char* literal);
+    int parseHex4(uint32_t* value);
+    int parseString(std::string* out);
+    // 返回数字的原始文本, 由调用方决定按整数还是浮点数解释
+    int scanNumber(std::string* token, bool* isInteger);
+    int parseId(std::string* id);
+    int parseValue(olama::Field* field, bool* isNull);
+    int parseStringArray(google::protobuf::RepeatedPtrField<std::string>* out);
+
+    const char* p_;
+    const char* end_;
+    std::string message_;
+};
+
+}  // namespace vectordb
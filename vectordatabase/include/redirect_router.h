@@ -0,0 +1,84 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "include/channel_pool.h"
+
+namespace vectordb {
+
+// 根据响应中的redirect字段学习各集合的目标节点, 后续请求直接发往该节点, 省去服务端转发
+// 每个目标节点使用独立的连接池, 请求出错时清除对应集合的路由
+class RedirectRouter {
+  public:
+    // @param url: 默认服务地址, 指向该地址的redirect会被忽略
+    // @param username: 用户名
+    // @param key: 认证密钥
+    // @param channelNum: 每个目标节点的连接数
+    // @param reconnectBackoff: 初始重连退避时间(毫秒)
+    // @param policy: 连接选择策略
+    RedirectRouter(const std::string& url, const std::string& username, const std::string& key,
+        int channelNum, int reconnectBackoff, ChannelSelectPolicy policy);
+
+    // 返回集合当前路由到的连接池, 没有路由时返回nullptr
+    std::shared_ptr<ChannelPool> route(const std::string& collectionKey);
+
+    // 记录集合的redirect目标
+    void learn(const std::string& collectionKey, const std::string& redirect);
+
+    // 清除集合的路由
+    void invalidate(const std::string& collectionKey);
+
+    // 清除所有路由并释放连接池
+    void clear();
+
+    // 当前路由表, 键为database/collection, 值为目标节点
+    std::map<std::string, std::string> routes();
+
+  private:
+    static std::string normalize(const std::string& target);
+
+    std::string defaultTarget_;
+    std::string username_;
+    std::string key_;
+    int channelNum_;
+    int reconnectBackoff_;
+    ChannelSelectPolicy policy_;
+
+    std::shared_mutex mutex_;
+    std::unordered_map<std::string, std::string> routes_;
+    std::unordered_map<std::string, std::shared_ptr<ChannelPool>> pools_;
+};
+
+}  // namespace vectordb
@@ -0,0 +1,56 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "include/types/document.h"
+
+namespace vectordb {
+
+// 距离计算函数, 首次调用时按CPU支持的指令集选择AVX-512/AVX2/NEON或标量实现
+float l2Squared(const float* a, const float* b, size_t dim);
+float innerProduct(const float* a, const float* b, size_t dim);
+
+// 当前使用的实现: "avx512", "avx2", "neon"或"scalar"
+const char* distanceKernelName();
+
+// 是否支持以该度量重排, 支持L2/IP/COSINE
+bool rerankMetricSupported(const std::string& metricType);
+
+// 以query与文档向量的精确距离重新计算score, 排序后保留前limit个
+// 缺少向量或维度不符的文档保持原有顺序排在之后
+// @param metricType: L2/IP/COSINE
+// @return: 0表示成功, 度量不受支持时返回-1且不修改documents
+int rerankDocuments(const float* query, size_t dim, const std::string& metricType, size_t limit,
+    std::vector<Document>* documents);
+
+}  // namespace vectordb
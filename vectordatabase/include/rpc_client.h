@@ -32,6 +32,8 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <functional>
+#include <future>
 #include <utility>
 #include <stdexcept>
 
@@ -47,6 +49,15 @@
 #include "include/types/database.h"
 #include "include/types/document.h"
 #include "include/types/index.h"
+#include "include/channel_pool.h"
+#include "include/hedging.h"
+#include "include/concurrency_limiter.h"
+#include "include/redirect_router.h"
+#include "include/search_batcher.h"
+#include "include/search_cache.h"
+#include "include/semantic_cache.h"
+#include "include/search_result_view.h"
+#include "include/columnar_result.h"
 
 namespace vectordb {
 
@@ -55,9 +66,59 @@ struct ClientOption {
     int timeout{5000};
     // ReadConsistency: default: EventualConsistency
     std::string readConsistency{EventualConsistency};
+    // AsyncThreadNum: number of completion queue threads serving async calls, default: 2
+    int asyncThreadNum{2};
+    // ChannelNum: number of independent connections to the server, default: 1
+    int channelNum{1};
+    // ChannelSelectPolicy: how calls are spread over the connections, default: round robin
+    ChannelSelectPolicy channelSelectPolicy{ChannelSelectPolicy::kRoundRobin};
+    // ChannelPool: shared connection pool, overrides channelNum/channelSelectPolicy when set
+    std::shared_ptr<ChannelPool> channelPool;
+    // Hedging: hedged requests for search/query/count, disabled by default
+    HedgingPolicy hedging;
+    // ConcurrencyLimit: adaptive per-collection in-flight limit, disabled by default
+    ConcurrencyLimitOption concurrencyLimit;
+    // LazyConnect: return from the constructor without waiting for the connection, default: false
+    // the first call (or warmup()) establishes the connection
+    bool lazyConnect{false};
+    // RedirectRouting: send requests for a collection directly to the node named in the
+    // redirect field of its previous response, default: false
+    bool redirectRouting{false};
+    // MaxBatchBytes: upsert requests larger than this are split into several requests,
+    // 0 disables splitting, default: 8MB (the connection limit is 16MB)
+    int64_t maxBatchBytes{8 * 1024 * 1024};
+    // MaxBatchParallelism: max number of split upsert requests in flight at once, default: 4
+    int maxBatchParallelism{4};
+    // SearchBatching: merge concurrent single-vector searches with the same parameters into one request,
+    // disabled by default; merged searches are not hedged
+    SearchBatchingPolicy searchBatching;
+    // SearchCache: client-side LRU cache of search results, invalidated by this client's writes to the collection,
+    // disabled by default; writes from other clients are only reflected after the ttl
+    SearchCachePolicy searchCache;
+    // SemanticCache: serve single-vector searches from the results of a recent search whose vector is within
+    // a cosine/L2 threshold and whose other parameters are equal, disabled by default
+    SemanticCachePolicy semanticCache;
 };
 
+struct WarmupResult {
+    bool success;
+    std::string message;
+    // 预热失败的集合, 格式为database/collection
+    std::vector<std::string> failedCollections;
+};
+
+// 异步调用完成回调, 参数与同步接口的返回值一致: 0表示成功,非0表示失败
+// 回调在客户端的CompletionQueue线程中执行, 不应长时间阻塞
+using AsyncCallback = std::function<void(int)>;
+
+class CompletionQueuePool;
+
 class RpcClient {
+    // 批量写入在自身的发送线程中调用sendUpsert, 可阻塞等待并发额度
+    friend class BulkWriter;
+    friend class BufferedWriter;
+    friend class BulkImporter;
+
   public:
     // 构造函数
     // @param url: 服务器地址
@@ -66,6 +127,7 @@ class RpcClient {
     // @param option: 客户端配置选项,可选参数
     RpcClient(const std::string& url, const std::string& username, const std::string& key,
         const ClientOption* option = nullptr);
+    ~RpcClient();
 
     // 设置超时时间
     // @param timeout: 超时时间(毫秒)
@@ -74,6 +136,19 @@ class RpcClient {
     // 关闭连接
     void closeConnection();
 
+    // 在后台建立所有连接
+    // @param timeout: 超时时间(毫秒)
+    // @return: 所有连接在超时前建立完成时为true
+    std::future<bool> warmup(int timeout = 5000);
+
+    // 建立连接, 并对给定集合并行发送describeCollection请求预热服务端路由及缓存
+    // @param collections: 需预热的集合列表, 每项为(database, collection)
+    // @param result: 预热结果, 需保持有效直到future就绪
+    // @param timeout: 单个请求的超时时间(毫秒)
+    // @return: 0表示全部成功,非0表示失败
+    std::future<int> warmup(const std::vector<std::pair<std::string, std::string>>& collections,
+        WarmupResult* result, int timeout = 5000);
+
     // 创建数据库
     // @param dbName: 数据库名称
     // @param result: 创建结果
@@ -143,7 +218,7 @@ class RpcClient {
     int dropCollection(const std::string& dbName, const std::string& collectionName,
         DropCollectionResult* result = nullptr, int timeout = 1000);
 
-    // 插入或更新文档
+    // 插入或更新文档, 序列化后超过ClientOption::maxBatchBytes时拆分为多个请求并行发送
     // @param dbName: 数据库名称
     // @param collectionName: 集合名称
     // @param documents: 要插入或更新的文档列表
@@ -154,6 +229,31 @@ class RpcClient {
     int upsert(const std::string& dbName, const std::string& collectionName, const std::vector<Document>& documents,
         const UpsertDocumentParams* params = nullptr, UpsertDocumentResult* result = nullptr, int timeout = 1000);
 
+    // 同上, 文档中的id、字符串字段被移动到请求中而不是拷贝
+    int upsert(const std::string& dbName, const std::string& collectionName, std::vector<Document>&& documents,
+        const UpsertDocumentParams* params = nullptr, UpsertDocumentResult* result = nullptr, int timeout = 1000);
+
+    // 使用连续存储的向量矩阵插入或更新文档, 不支持coalesce
+    // @param dbName: 数据库名称
+    // @param collectionName: 集合名称
+    // @param ids: 文档ID列表, ids[i]对应vectors的第i行, 可传入std::vector或指针加个数
+    // @param vectors: 向量矩阵
+    // @param fields: 各文档的标量字段,可选参数,非空时行数需与vectors一致
+    // @param params: 插入参数
+    // @param result: 插入结果
+    // @param timeout: 超时时间(毫秒),默认1000ms
+    // @return: 0表示成功,非0表示失败
+    int upsert(const std::string& dbName, const std::string& collectionName, IdSpan ids,
+        const VectorMatrixView& vectors, const std::vector<std::unordered_map<std::string, Field>>* fields = nullptr,
+        const UpsertDocumentParams* params = nullptr, UpsertDocumentResult* result = nullptr, int timeout = 1000);
+
+    // 发送已构建好的upsert请求, 请求不会被拆分
+    // @param request: upsert请求
+    // @param result: 插入结果
+    // @param timeout: 超时时间(毫秒),默认1000ms
+    // @return: 0表示成功,非0表示失败
+    int upsert(const olama::UpsertRequest& request, UpsertDocumentResult* result = nullptr, int timeout = 1000);
+
     // 查询文档
     // @param dbName: 数据库名称
     // @param collectionName: 集合名称
@@ -179,6 +279,48 @@ class RpcClient {
         const std::vector<std::string>& documentIds, const std::vector<std::vector<float>>& vectors,
         const std::map<std::string, std::vector<std::string>>& text,
         const SearchDocumentParams* params = nullptr, SearchDocumentResult* result = nullptr, int timeout = 1000);
+
+    // 使用连续存储的向量矩阵搜索, 每行为一个检索向量
+    // @param dbName: 数据库名称
+    // @param collectionName: 集合名称
+    // @param vectors: 向量矩阵
+    // @param params: 搜索参数
+    // @param result: 搜索结果
+    // @param timeout: 超时时间(毫秒),默认1000ms
+    // @return: 0表示成功,非0表示失败
+    int search(const std::string& dbName, const std::string& collectionName, const VectorMatrixView& vectors,
+        const SearchDocumentParams* params, SearchDocumentResult* result, int timeout = 1000);
+
+    // 发送已构建好的搜索请求
+    // @param request: 搜索请求
+    // @param result: 搜索结果
+    // @param timeout: 超时时间(毫秒),默认1000ms
+    // @return: 0表示成功,非0表示失败
+    int search(const olama::SearchRequest& request, SearchDocumentResult* result, int timeout = 1000);
+
+    // 使用向量矩阵搜索, 结果以SearchResultView返回, 不转换为Document; 不使用检索结果缓存及合并, 设置params->rerank时返回-1
+    // @param dbName: 数据库名称
+    // @param collectionName: 集合名称
+    // @param vectors: 向量矩阵
+    // @param params: 搜索参数
+    // @param result: 搜索结果视图, 之前的结果被释放
+    // @param timeout: 超时时间(毫秒),默认1000ms
+    // @return: 0表示成功,非0表示失败
+    int search(const std::string& dbName, const std::string& collectionName, const VectorMatrixView& vectors,
+        const SearchDocumentParams* params, SearchResultView* result, int timeout = 1000);
+    int search(const olama::SearchRequest& request, SearchResultView* result, int timeout = 1000);
+
+    // 使用向量矩阵搜索, 结果按列存储, outputFields中的字段转为类型化的列; 不使用检索结果缓存及合并, 设置params->rerank时返回-1
+    // @param dbName: 数据库名称
+    // @param collectionName: 集合名称
+    // @param vectors: 向量矩阵
+    // @param params: 搜索参数
+    // @param result: 列式搜索结果, 追加到result->results
+    // @param timeout: 超时时间(毫秒),默认1000ms
+    // @return: 0表示成功,非0表示失败
+    int search(const std::string& dbName, const std::string& collectionName, const VectorMatrixView& vectors,
+        const SearchDocumentParams* params, ColumnarSearchResult* result, int timeout = 1000);
+    int search(const olama::SearchRequest& request, ColumnarSearchResult* result, int timeout = 1000);
     
     // 删除文档
     // @param dbName: 数据库名称
@@ -215,9 +357,257 @@ class RpcClient {
     int rebuildIndex(const std::string& dbName, const std::string& collectionName,
         const RebuildIndexParams* params, RebuildIndexResult* result = nullptr, int timeout = 1000);
 
+    // 异步接口: 请求在调用返回前完成序列化, documents/params调用后即可释放,
+    // result需保持有效直到future就绪或callback被调用
+    std::future<int> createDatabaseAsync(const std::string& dbName, CreateDatabaseResult* result,
+        int timeout = 1000);
+    void createDatabaseAsync(const std::string& dbName, CreateDatabaseResult* result,
+        AsyncCallback callback, int timeout = 1000);
+
+    std::future<int> listDatabasesAsync(ListDatabaseResult* result, int timeout = 1000);
+    void listDatabasesAsync(ListDatabaseResult* result, AsyncCallback callback, int timeout = 1000);
+
+    std::future<int> dropDatabaseAsync(const std::string& dbName, DropDatabaseResult* result,
+        int timeout = 1000);
+    void dropDatabaseAsync(const std::string& dbName, DropDatabaseResult* result,
+        AsyncCallback callback, int timeout = 1000);
+
+    std::future<int> createCollectionAsync(const std::string& dbName, const std::string& collectionName,
+        uint32_t shardNum, uint32_t replicaNum, const std::string& description, const Indexes& indexes,
+        const CreateCollectionParams* params, CreateCollectionResult* result, int timeout = 1000);
+    void createCollectionAsync(const std::string& dbName, const std::string& collectionName,
+        uint32_t shardNum, uint32_t replicaNum, const std::string& description, const Indexes& indexes,
+        const CreateCollectionParams* params, CreateCollectionResult* result,
+        AsyncCallback callback, int timeout = 1000);
+
+    std::future<int> listCollectionsAsync(const std::string& dbName, ListCollectionResult* result,
+        int timeout = 1000);
+    void listCollectionsAsync(const std::string& dbName, ListCollectionResult* result,
+        AsyncCallback callback, int timeout = 1000);
+
+    std::future<int> describeCollectionAsync(const std::string& dbName, const std::string& collectionName,
+        DescribeCollectionResult* result, int timeout = 1000);
+    void describeCollectionAsync(const std::string& dbName, const std::string& collectionName,
+        DescribeCollectionResult* result, AsyncCallback callback, int timeout = 1000);
+
+    std::future<int> truncateCollectionAsync(const std::string& dbName, const std::string& collectionName,
+        TruncateCollectionResult* result, int timeout = 1000);
+    void truncateCollectionAsync(const std::string& dbName, const std::string& collectionName,
+        TruncateCollectionResult* result, AsyncCallback callback, int timeout = 1000);
+
+    std::future<int> dropCollectionAsync(const std::string& dbName, const std::string& collectionName,
+        DropCollectionResult* result, int timeout = 1000);
+    void dropCollectionAsync(const std::string& dbName, const std::string& collectionName,
+        DropCollectionResult* result, AsyncCallback callback, int timeout = 1000);
+
+    std::future<int> upsertAsync(const std::string& dbName, const std::string& collectionName,
+        const std::vector<Document>& documents, const UpsertDocumentParams* params, UpsertDocumentResult* result,
+        int timeout = 1000);
+    void upsertAsync(const std::string& dbName, const std::string& collectionName,
+        const std::vector<Document>& documents, const UpsertDocumentParams* params, UpsertDocumentResult* result,
+        AsyncCallback callback, int timeout = 1000);
+
+    std::future<int> upsertAsync(const std::string& dbName, const std::string& collectionName,
+        std::vector<Document>&& documents, const UpsertDocumentParams* params, UpsertDocumentResult* result,
+        int timeout = 1000);
+    void upsertAsync(const std::string& dbName, const std::string& collectionName,
+        std::vector<Document>&& documents, const UpsertDocumentParams* params, UpsertDocumentResult* result,
+        AsyncCallback callback, int timeout = 1000);
+
+    std::future<int> upsertAsync(const std::string& dbName, const std::string& collectionName,
+        IdSpan ids, const VectorMatrixView& vectors,
+        const std::vector<std::unordered_map<std::string, Field>>* fields, const UpsertDocumentParams* params,
+        UpsertDocumentResult* result, int timeout = 1000);
+    void upsertAsync(const std::string& dbName, const std::string& collectionName,
+        IdSpan ids, const VectorMatrixView& vectors,
+        const std::vector<std::unordered_map<std::string, Field>>* fields, const UpsertDocumentParams* params,
+        UpsertDocumentResult* result, AsyncCallback callback, int timeout = 1000);
+
+    std::future<int> upsertAsync(const olama::UpsertRequest& request, UpsertDocumentResult* result,
+        int timeout = 1000);
+    void upsertAsync(const olama::UpsertRequest& request, UpsertDocumentResult* result, AsyncCallback callback,
+        int timeout = 1000);
+
+    std::future<int> queryAsync(const std::string& dbName, const std::string& collectionName,
+        const std::vector<std::string>& documentIds, const QueryDocumentParams* params, QueryDocumentResult* result,
+        int timeout = 1000);
+    void queryAsync(const std::string& dbName, const std::string& collectionName,
+        const std::vector<std::string>& documentIds, const QueryDocumentParams* params, QueryDocumentResult* result,
+        AsyncCallback callback, int timeout = 1000);
+
+    std::future<int> searchAsync(const std::string& dbName, const std::string& collectionName,
+        const std::vector<std::string>& documentIds, const std::vector<std::vector<float>>& vectors,
+        const std::map<std::string, std::vector<std::string>>& text,
+        const SearchDocumentParams* params, SearchDocumentResult* result, int timeout = 1000);
+    void searchAsync(const std::string& dbName, const std::string& collectionName,
+        const std::vector<std::string>& documentIds, const std::vector<std::vector<float>>& vectors,
+        const std::map<std::string, std::vector<std::string>>& text,
+        const SearchDocumentParams* params, SearchDocumentResult* result, AsyncCallback callback, int timeout = 1000);
+
+    std::future<int> searchAsync(const std::string& dbName, const std::string& collectionName,
+        const VectorMatrixView& vectors, const SearchDocumentParams* params, SearchDocumentResult* result,
+        int timeout = 1000);
+    void searchAsync(const std::string& dbName, const std::string& collectionName,
+        const VectorMatrixView& vectors, const SearchDocumentParams* params, SearchDocumentResult* result,
+        AsyncCallback callback, int timeout = 1000);
+
+    std::future<int> searchAsync(const olama::SearchRequest& request, SearchDocumentResult* result,
+        int timeout = 1000);
+    // SearchResultView的响应直接解析到其arena上
+    std::future<int> searchAsync(const std::string& dbName, const std::string& collectionName,
+        const VectorMatrixView& vectors, const SearchDocumentParams* params, SearchResultView* result,
+        int timeout = 1000);
+    void searchAsync(const std::string& dbName, const std::string& collectionName,
+        const VectorMatrixView& vectors, const SearchDocumentParams* params, SearchResultView* result,
+        AsyncCallback callback, int timeout = 1000);
+    std::future<int> searchAsync(const olama::SearchRequest& request, SearchResultView* result,
+        int timeout = 1000);
+    void searchAsync(const olama::SearchRequest& request, SearchResultView* result, AsyncCallback callback,
+        int timeout = 1000);
+
+    std::future<int> searchAsync(const std::string& dbName, const std::string& collectionName,
+        const VectorMatrixView& vectors, const SearchDocumentParams* params, ColumnarSearchResult* result,
+        int timeout = 1000);
+    void searchAsync(const std::string& dbName, const std::string& collectionName,
+        const VectorMatrixView& vectors, const SearchDocumentParams* params, ColumnarSearchResult* result,
+        AsyncCallback callback, int timeout = 1000);
+    std::future<int> searchAsync(const olama::SearchRequest& request, ColumnarSearchResult* result,
+        int timeout = 1000);
+    void searchAsync(const olama::SearchRequest& request, ColumnarSearchResult* result, AsyncCallback callback,
+        int timeout = 1000);
+    void searchAsync(const olama::SearchRequest& request, SearchDocumentResult* result, AsyncCallback callback,
+        int timeout = 1000);
+
+    std::future<int> deleAsync(const std::string& dbName, const std::string& collectionName,
+        const DeleteDocumentParams* param, DeleteDocumentResult* result, int timeout = 1000);
+    void deleAsync(const std::string& dbName, const std::string& collectionName,
+        const DeleteDocumentParams* param, DeleteDocumentResult* result, AsyncCallback callback, int timeout = 1000);
+
+    std::future<int> updateAsync(const std::string& dbName, const std::string& collectionName,
+        const UpdateDocumentParams* param, UpdateDocumentResult* result, int timeout = 1000);
+    void updateAsync(const std::string& dbName, const std::string& collectionName,
+        const UpdateDocumentParams* param, UpdateDocumentResult* result, AsyncCallback callback, int timeout = 1000);
+
+    std::future<int> countAsync(const std::string& dbName, const std::string& collectionName,
+        const Filter* filter, CountResult* result, int timeout = 1000);
+    void countAsync(const std::string& dbName, const std::string& collectionName,
+        const Filter* filter, CountResult* result, AsyncCallback callback, int timeout = 1000);
+
+    std::future<int> rebuildIndexAsync(const std::string& dbName, const std::string& collectionName,
+        const RebuildIndexParams* params, RebuildIndexResult* result, int timeout = 1000);
+    void rebuildIndexAsync(const std::string& dbName, const std::string& collectionName,
+        const RebuildIndexParams* params, RebuildIndexResult* result, AsyncCallback callback, int timeout = 1000);
+
+    // 获取各database/collection的并发限制统计, 仅在开启ClientOption::concurrencyLimit时有数据
+    std::map<std::string, ConcurrencyLimiterStats> getConcurrencyLimiterStats();
+
+    // 获取已学习的redirect路由, 键为database/collection, 值为目标节点, 仅在开启ClientOption::redirectRouting时有数据
+    std::map<std::string, std::string> getRedirectRoutes();
+
+    // 获取单向量检索的合并统计, 仅在开启ClientOption::searchBatching时有数据
+    SearchBatchStats getSearchBatchStats();
+
+    // 获取检索结果缓存的统计, 仅在开启ClientOption::searchCache时有数据
+    SearchCacheStats getSearchCacheStats();
+    // 获取近似检索结果缓存的统计, 仅在开启ClientOption::semanticCache时有数据
+    SemanticCacheStats getSemanticCacheStats();
+    // 清空检索结果缓存及近似检索结果缓存
+    void clearSearchCache();
+
   private:
-    std::shared_ptr<grpc::Channel> grpcChannel_;
-    std::unique_ptr<olama::SearchEngine::Stub> stub_;
+    template <typename Request, typename Response>
+    using UnaryMethod = grpc::Status (olama::SearchEngine::Stub::*)(grpc::ClientContext*, const Request&, Response*);
+
+    template <typename Request, typename Response>
+    using PrepareAsyncMethod = std::unique_ptr<grpc::ClientAsyncResponseReader<Response>>
+        (olama::SearchEngine::Stub::*)(grpc::ClientContext*, const Request&, grpc::CompletionQueue*);
+
+    // 从连接池选择连接发起同步一元调用
+    template <typename Request, typename Response>
+    grpc::Status invoke(UnaryMethod<Request, Response> method, const Request& request, Response* response,
+        int timeout);
+
+    // 发起带对冲的只读调用, 先成功的调用生效, 其余调用被取消
+    template <typename Request, typename Response>
+    grpc::Status invokeHedged(PrepareAsyncMethod<Request, Response> method, const Request& request,
+        Response* response, int timeout, LatencyTracker* tracker);
+
+    // 在CompletionQueue上发起一元调用, done在CompletionQueue线程中执行
+    // arena非空时响应分配在arena上, 可在done返回后继续使用
+    // 开启并发限制时, waitForSlot为false则无可用额度立即失败; 为true则阻塞调用方直到获得额度或超时,
+    // 仅用于允许阻塞的调用线程, 不能在CompletionQueue线程中使用
+    template <typename Request, typename Response>
+    void invokeAsync(PrepareAsyncMethod<Request, Response> method, const Request& request, int timeout,
+        std::function<void(const grpc::Status&, Response&)> done, google::protobuf::Arena* arena = nullptr,
+        bool waitForSlot = false);
+
+    // 发送单个upsert请求, waitForSlot含义同invokeAsync
+    // 批量写入器的发送线程可以阻塞, 以waitForSlot为true调用, 开启并发限制时与同步写入一样在超时前等待额度
+    void sendUpsert(const olama::UpsertRequest& request, UpsertDocumentResult* result, AsyncCallback callback,
+        int timeout, bool waitForSlot);
+
+    struct UpsertBatchState;
+
+    // 发送拆分后的upsert请求, 最多maxBatchParallelism个子请求同时进行, 合并各子请求的affectedCount
+    void upsertBatches(std::vector<olama::UpsertRequest>&& requests, UpsertDocumentResult* result,
+        AsyncCallback callback, int timeout);
+    void sendUpsertBatch(const std::shared_ptr<UpsertBatchState>& state);
+    // 同步发送拆分后的upsert请求, 由调用线程逐个发出子请求, 与单个请求的同步写入一样可等待并发额度
+    int sendUpsertRequests(std::vector<olama::UpsertRequest>&& requests, UpsertDocumentResult* result, int timeout);
+
+    // 将单向量检索交给searchBatcher_, 与参数相同的其他检索合并发送
+    void submitBatchedSearch(const std::string& dbName, const std::string& collectionName, const float* vector,
+        size_t dim, const SearchDocumentParams* params, SearchDocumentResult* result, AsyncCallback callback,
+        int timeout);
+
+    // 查询检索结果缓存及近似检索结果缓存, 命中时将结果追加到result并返回true;
+    // 未命中时fillCache为检索完成后以返回值调用的写入缓存回调, 未开启缓存时为空
+    bool lookupSearchCache(const olama::SearchRequest& request, SearchDocumentResult* result,
+        AsyncCallback* fillCache);
+
+    // 不经过检索结果缓存直接发送检索请求
+    void sendSearchAsync(const olama::SearchRequest& request, SearchDocumentResult* result, AsyncCallback callback,
+        int timeout);
+
+    // 集合写操作开始及完成时调用, 使检索结果缓存及近似检索结果缓存中该集合的结果失效
+    void invalidateSearchCache(const std::string& dbName, const std::string& collectionName) {
+        if (searchCache_) {
+            searchCache_->invalidate(dbName, collectionName);
+        }
+        if (semanticCache_) {
+            semanticCache_->invalidate(dbName, collectionName);
+        }
+    }
+    void invalidateSearchCache(const std::string& dbName) {
+        if (searchCache_) {
+            searchCache_->invalidate(dbName);
+        }
+        if (semanticCache_) {
+            semanticCache_->invalidate(dbName);
+        }
+    }
+
+    // 是否有按集合区分的策略需要计算collectionKey
+    bool keyedByCollection() const {
+        return option_.concurrencyLimit.enabled || router_ != nullptr;
+    }
+
+    // 选择请求使用的连接池, 集合存在redirect路由时使用路由到的节点
+    std::shared_ptr<ChannelPool> selectPool(const std::string& key, bool* routed);
+
+    // 根据调用结果更新集合的redirect路由, 路由后的请求失败时清除路由
+    void updateRoute(const std::string& key, bool routed, bool failed, const std::string& redirect);
+
+    std::shared_ptr<ChannelPool> channelPool_;
+    LatencyTracker searchLatency_;
+    LatencyTracker queryLatency_;
+    LatencyTracker countLatency_;
+    std::unique_ptr<ConcurrencyLimiterGroup> limiters_;
+    std::unique_ptr<RedirectRouter> router_;
+    std::unique_ptr<SearchResultCache> searchCache_;
+    std::unique_ptr<SemanticSearchCache> semanticCache_;
+    std::unique_ptr<CompletionQueuePool> cqPool_;
+    std::unique_ptr<SearchBatcher> searchBatcher_;
     ClientOption option_;
     std::string url_;
     std::string username_;
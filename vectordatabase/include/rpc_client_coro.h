@@ -0,0 +1,296 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// C++20协程接口, 仅在C++20及以上且支持<coroutine>时可用, 需在使用方以C++20编译
+#if __cplusplus >= 202002L && __has_include(<coroutine>)
+
+#include <atomic>
+#include <coroutine>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "include/rpc_client.h"
+
+namespace vectordb {
+
+// 协程恢复执行器: 接收待恢复的协程句柄, 由使用方决定在哪个线程resume
+// 为空时直接在完成RPC的CompletionQueue线程上resume, 不产生额外的线程切换
+using CoroExecutor = std::function<void(std::coroutine_handle<>)>;
+
+// 单次RPC的awaitable, co_await的结果与同步接口的返回值一致: 0表示成功,非0表示失败
+// 构造时即发起调用, 未被co_await的awaitable不会取消调用
+class RpcAwaitable {
+  public:
+    using Starter = std::function<void(AsyncCallback)>;
+
+    // executor按值保存, 调用完成前CoroRpcClient被销毁时仍然有效
+    RpcAwaitable(const Starter& start, CoroExecutor executor) : state_(std::make_shared<State>()) {
+        state_->executor = std::move(executor);
+        start([state = state_](int ret) {
+            state->ret = ret;
+            // await_suspend已先置位时由回调恢复协程; 否则调用同步完成, 由await_suspend返回false继续执行
+            if (state->done.exchange(true, std::memory_order_acq_rel)) {
+                if (state->executor) {
+                    state->executor(state->handle);
+                } else {
+                    state->handle.resume();
+                }
+            }
+        });
+    }
+
+    bool await_ready() const noexcept {
+        return state_->done.load(std::memory_order_acquire);
+    }
+
+    // 调用已完成时返回false, 协程不挂起直接继续执行, 避免在回调内恢复协程造成栈的无限增长
+    bool await_suspend(std::coroutine_handle<> handle) noexcept {
+        state_->handle = handle;
+        return !state_->done.exchange(true, std::memory_order_acq_rel);
+    }
+
+    int await_resume() const noexcept {
+        return state_->ret;
+    }
+
+  private:
+    // 由awaitable及完成回调共同持有, awaitable先于调用完成被销毁时仍然有效
+    struct State {
+        std::atomic<bool> done{false};
+        int ret = -1;
+        std::coroutine_handle<> handle;
+        CoroExecutor executor;
+    };
+
+    std::shared_ptr<State> state_;
+};
+
+// RpcClient的协程包装, 与RpcClient的各个异步接口一一对应
+// 调用包装函数时即发起调用并完成参数的序列化, 之后参数即可释放;
+// result需在co_await期间保持有效, 通常为协程内的局部变量
+// 用法: int ret = co_await coClient.search(dbName, collectionName, {}, vectors, {}, &params, &result);
+class CoroRpcClient {
+  public:
+    explicit CoroRpcClient(RpcClient* client, CoroExecutor executor = nullptr)
+        : client_(client), executor_(std::move(executor)) {}
+
+    RpcAwaitable createDatabase(const std::string& dbName, CreateDatabaseResult* result, int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->createDatabaseAsync(dbName, result, std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable listDatabases(ListDatabaseResult* result, int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->listDatabasesAsync(result, std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable dropDatabase(const std::string& dbName, DropDatabaseResult* result, int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->dropDatabaseAsync(dbName, result, std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable createCollection(const std::string& dbName, const std::string& collectionName,
+        uint32_t shardNum, uint32_t replicaNum, const std::string& description, const Indexes& indexes,
+        const CreateCollectionParams* params = nullptr, CreateCollectionResult* result = nullptr,
+        int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->createCollectionAsync(dbName, collectionName, shardNum, replicaNum, description, indexes,
+                params, result, std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable listCollections(const std::string& dbName, ListCollectionResult* result, int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->listCollectionsAsync(dbName, result, std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable describeCollection(const std::string& dbName, const std::string& collectionName,
+        DescribeCollectionResult* result, int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->describeCollectionAsync(dbName, collectionName, result, std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable truncateCollection(const std::string& dbName, const std::string& collectionName,
+        TruncateCollectionResult* result, int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->truncateCollectionAsync(dbName, collectionName, result, std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable dropCollection(const std::string& dbName, const std::string& collectionName,
+        DropCollectionResult* result, int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->dropCollectionAsync(dbName, collectionName, result, std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable upsert(const std::string& dbName, const std::string& collectionName,
+        const std::vector<Document>& documents, const UpsertDocumentParams* params,
+        UpsertDocumentResult* result, int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->upsertAsync(dbName, collectionName, documents, params, result, std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable upsert(const std::string& dbName, const std::string& collectionName,
+        std::vector<Document>&& documents, const UpsertDocumentParams* params,
+        UpsertDocumentResult* result, int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->upsertAsync(dbName, collectionName, std::move(documents), params, result, std::move(cb),
+                timeout);
+        });
+    }
+
+    RpcAwaitable upsert(const std::string& dbName, const std::string& collectionName, IdSpan ids,
+        const VectorMatrixView& vectors, const std::vector<std::unordered_map<std::string, Field>>* fields,
+        const UpsertDocumentParams* params, UpsertDocumentResult* result, int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->upsertAsync(dbName, collectionName, ids, vectors, fields, params, result, std::move(cb),
+                timeout);
+        });
+    }
+
+    RpcAwaitable upsert(const olama::UpsertRequest& request, UpsertDocumentResult* result, int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->upsertAsync(request, result, std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable query(const std::string& dbName, const std::string& collectionName,
+        const std::vector<std::string>& documentIds, const QueryDocumentParams* params,
+        QueryDocumentResult* result, int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->queryAsync(dbName, collectionName, documentIds, params, result, std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable search(const std::string& dbName, const std::string& collectionName,
+        const std::vector<std::string>& documentIds, const std::vector<std::vector<float>>& vectors,
+        const std::map<std::string, std::vector<std::string>>& text,
+        const SearchDocumentParams* params, SearchDocumentResult* result, int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->searchAsync(dbName, collectionName, documentIds, vectors, text, params, result,
+                std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable search(const std::string& dbName, const std::string& collectionName,
+        const VectorMatrixView& vectors, const SearchDocumentParams* params, SearchDocumentResult* result,
+        int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->searchAsync(dbName, collectionName, vectors, params, result, std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable search(const olama::SearchRequest& request, SearchDocumentResult* result, int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->searchAsync(request, result, std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable search(const std::string& dbName, const std::string& collectionName,
+        const VectorMatrixView& vectors, const SearchDocumentParams* params, SearchResultView* result,
+        int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->searchAsync(dbName, collectionName, vectors, params, result, std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable search(const olama::SearchRequest& request, SearchResultView* result, int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->searchAsync(request, result, std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable search(const std::string& dbName, const std::string& collectionName,
+        const VectorMatrixView& vectors, const SearchDocumentParams* params, ColumnarSearchResult* result,
+        int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->searchAsync(dbName, collectionName, vectors, params, result, std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable search(const olama::SearchRequest& request, ColumnarSearchResult* result, int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->searchAsync(request, result, std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable dele(const std::string& dbName, const std::string& collectionName,
+        const DeleteDocumentParams* param, DeleteDocumentResult* result, int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->deleAsync(dbName, collectionName, param, result, std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable update(const std::string& dbName, const std::string& collectionName,
+        const UpdateDocumentParams* param, UpdateDocumentResult* result, int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->updateAsync(dbName, collectionName, param, result, std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable count(const std::string& dbName, const std::string& collectionName,
+        const Filter* filter, CountResult* result, int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->countAsync(dbName, collectionName, filter, result, std::move(cb), timeout);
+        });
+    }
+
+    RpcAwaitable rebuildIndex(const std::string& dbName, const std::string& collectionName,
+        const RebuildIndexParams* params, RebuildIndexResult* result, int timeout = 1000) {
+        return wrap([&](AsyncCallback cb) {
+            client_->rebuildIndexAsync(dbName, collectionName, params, result, std::move(cb), timeout);
+        });
+    }
+
+  private:
+    // start在RpcAwaitable构造时即被调用, 可以按引用捕获包装函数的参数
+    RpcAwaitable wrap(const RpcAwaitable::Starter& start) const {
+        return RpcAwaitable(start, executor_);
+    }
+
+    RpcClient* client_;
+    CoroExecutor executor_;
+};
+
+}  // namespace vectordb
+
+#endif  // __cplusplus >= 202002L && __has_include(<coroutine>)
@@ -0,0 +1,239 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <utility>
+
+#include "include/rpc_client.h"
+#include "include/async_call.h"
+#include "include/channel_pool.h"
+#include "include/concurrency_limiter.h"
+#include "include/redirect_router.h"
+
+namespace vectordb {
+
+// 请求所属的database/collection, 用于并发限制、redirect路由等按集合区分的策略
+template <typename Request>
+std::string collectionKey(const Request& request) {
+    return request.database() + "/" + request.collection();
+}
+
+inline std::string collectionKey(const olama::DatabaseRequest& request) {
+    return request.database();
+}
+
+inline std::string collectionKey(const olama::ListCollectionsRequest& request) {
+    return request.database();
+}
+
+inline bool isOverloaded(const grpc::Status& status) {
+    return status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED ||
+        status.error_code() == grpc::StatusCode::RESOURCE_EXHAUSTED ||
+        status.error_code() == grpc::StatusCode::UNAVAILABLE;
+}
+
+inline int64_t elapsedUs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+inline grpc::Status concurrencyLimitExceeded(const std::string& key) {
+    return grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "client concurrency limit exceeded for " + key);
+}
+
+template <typename Request, typename Response>
+grpc::Status RpcClient::invoke(UnaryMethod<Request, Response> method, const Request& request,
+    Response* response, int timeout) {
+    if (!channelPool_) {
+        return grpc::Status(grpc::StatusCode::UNAVAILABLE, "connection is closed");
+    }
+    std::chrono::system_clock::time_point deadline = std::chrono::system_clock::now() +
+        std::chrono::milliseconds(timeout);
+    std::string key = keyedByCollection() ? collectionKey(request) : std::string();
+    ConcurrencyLimiter* limiter = nullptr;
+    if (option_.concurrencyLimit.enabled) {
+        limiter = limiters_->get(key);
+        if (!limiter->acquire(deadline)) {
+            return concurrencyLimitExceeded(key);
+        }
+    }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    bool routed = false;
+    std::shared_ptr<ChannelPool> pool = selectPool(key, &routed);
+    ChannelPool::Lease lease = pool->acquire();
+    grpc::ClientContext context;
+    context.set_deadline(deadline);
+    grpc::Status status = (lease.stub()->*method)(&context, request, response);
+    if (limiter != nullptr) {
+        limiter->release(isOverloaded(status), start);
+    }
+    if (router_) {
+        updateRoute(key, routed, !status.ok() || response->code() != 0, response->redirect());
+    }
+    return status;
+}
+
+template <typename Request, typename Response>
+void RpcClient::invokeAsync(PrepareAsyncMethod<Request, Response> method, const Request& request, int timeout,
+    std::function<void(const grpc::Status&, Response&)> done, google::protobuf::Arena* arena, bool waitForSlot) {
+    if (!channelPool_) {
+        Response response;
+        done(grpc::Status(grpc::StatusCode::UNAVAILABLE, "connection is closed"), response);
+        return;
+    }
+    std::chrono::system_clock::time_point deadline = std::chrono::system_clock::now() +
+        std::chrono::milliseconds(timeout);
+    std::string key = keyedByCollection() ? collectionKey(request) : std::string();
+    // 异步调用默认不阻塞调用方排队等待, 无可用并发额度时立即失败
+    if (option_.concurrencyLimit.enabled) {
+        ConcurrencyLimiter* limiter = limiters_->get(key);
+        if (waitForSlot ? !limiter->acquire(deadline) : !limiter->tryAcquire()) {
+            Response response;
+            done(concurrencyLimitExceeded(key), response);
+            return;
+        }
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        done = [limiter, start, done = std::move(done)](const grpc::Status& status, Response& response) {
+            limiter->release(isOverloaded(status), start);
+            done(status, response);
+        };
+    }
+    bool routed = false;
+    std::shared_ptr<ChannelPool> pool = selectPool(key, &routed);
+    if (router_) {
+        done = [this, key, routed, done = std::move(done)](const grpc::Status& status, Response& response) {
+            updateRoute(key, routed, !status.ok() || response.code() != 0, response.redirect());
+            done(status, response);
+        };
+    }
+    auto* call = new AsyncUnaryCall<Response>(std::move(done), arena);
+    call->pool_ = std::move(pool);
+    call->lease_ = call->pool_->acquire();
+    call->context_.set_deadline(deadline);
+    call->reader_ = (call->lease_.stub()->*method)(&call->context_, request, cqPool_->next());
+    call->reader_->StartCall();
+    call->reader_->Finish(call->response_, &call->status_, call);
+}
+
+template <typename Request, typename Response>
+grpc::Status RpcClient::invokeHedged(PrepareAsyncMethod<Request, Response> method, const Request& request,
+    Response* response, int timeout, LatencyTracker* tracker) {
+    if (!channelPool_) {
+        return grpc::Status(grpc::StatusCode::UNAVAILABLE, "connection is closed");
+    }
+    const HedgingPolicy& policy = option_.hedging;
+    std::chrono::system_clock::time_point deadline = std::chrono::system_clock::now() +
+        std::chrono::milliseconds(timeout);
+    std::string key = keyedByCollection() ? collectionKey(request) : std::string();
+    // 对冲请求的多次发送共用一个并发额度
+    ConcurrencyLimiter* limiter = nullptr;
+    if (option_.concurrencyLimit.enabled) {
+        limiter = limiters_->get(key);
+        if (!limiter->acquire(deadline)) {
+            return concurrencyLimitExceeded(key);
+        }
+    }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    auto state = std::make_shared<HedgedCallState<Response>>();
+    bool routed = false;
+    std::shared_ptr<ChannelPool> pool = selectPool(key, &routed);
+
+    auto issue = [&]() {
+        auto* call = new AsyncUnaryCall<Response>(nullptr, &state->arena);
+        grpc::ClientContext* context = &call->context_;
+        call->setCallback([state, context, start, tracker](const grpc::Status& status, Response& resp) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->contexts.erase(std::find(state->contexts.begin(), state->contexts.end(), context));
+            --state->pending;
+            if (!state->finished) {
+                state->status = status;
+                if (status.ok()) {
+                    // 从首次发送开始计时: 按各自发送时间记录时对冲请求胜出后显得更快, 等待时间会越来越短
+                    tracker->add(elapsedUs(start));
+                    state->response->Swap(&resp);
+                    state->finished = true;
+                    for (grpc::ClientContext* other : state->contexts) {
+                        other->TryCancel();
+                    }
+                } else if (state->pending == 0) {
+                    state->finished = true;
+                }
+                state->cv.notify_all();
+            }
+        });
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (state->finished) {
+                delete call;
+                return;
+            }
+            state->contexts.push_back(context);
+            ++state->pending;
+        }
+        call->pool_ = pool;
+        call->lease_ = pool->acquire();
+        call->context_.set_deadline(deadline);
+        call->reader_ = (call->lease_.stub()->*method)(&call->context_, request, cqPool_->next());
+        call->reader_->StartCall();
+        call->reader_->Finish(call->response_, &call->status_, call);
+    };
+
+    int64_t delayUs = static_cast<int64_t>(policy.delay) * 1000;
+    if (policy.adaptive) {
+        int64_t observed = tracker->percentile(policy.percentile, policy.minSamples);
+        if (observed > 0) {
+            delayUs = observed;
+        }
+    }
+
+    issue();
+    std::unique_lock<std::mutex> lock(state->mutex);
+    if (!state->cv.wait_for(lock, std::chrono::microseconds(delayUs), [&state] { return state->finished; })) {
+        if (std::chrono::system_clock::now() < deadline) {
+            lock.unlock();
+            issue();
+            lock.lock();
+        }
+    }
+    state->cv.wait(lock, [&state] { return state->finished; });
+    response->Swap(state->response);
+    grpc::Status status = state->status;
+    lock.unlock();
+    if (limiter != nullptr) {
+        limiter->release(isOverloaded(status), start);
+    }
+    if (router_) {
+        updateRoute(key, routed, !status.ok() || response->code() != 0, response->redirect());
+    }
+    return status;
+}
+
+}  // namespace vectordb
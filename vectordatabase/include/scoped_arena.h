@@ -0,0 +1,73 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <cstddef>
+
+#include <google/protobuf/arena.h>
+
+namespace vectordb {
+
+// 单次调用的请求、响应消息所用的arena, 调用结束时整体释放
+// 每个线程缓存一块初始内存供arena复用, 并按历史用量增长; 同一线程中嵌套的调用使用独立分配的内存
+// 内存开销: 每个发起过调用的线程(包括调用方线程和CompletionQueue线程)常驻一块64KB到kMaxCachedBlockSize的缓存,
+// 连续kShrinkAfterCalls次调用用量都不到其1/4时缩小; 线程不再发起调用时可调用releaseThreadCache()立即释放
+class ScopedArena {
+  public:
+    ScopedArena();
+    ~ScopedArena();
+
+    ScopedArena(const ScopedArena&) = delete;
+    ScopedArena& operator=(const ScopedArena&) = delete;
+
+    template <typename Message>
+    Message& create() {
+        return *google::protobuf::Arena::CreateMessage<Message>(&arena_);
+    }
+
+    google::protobuf::Arena* get() {
+        return &arena_;
+    }
+
+    // 释放当前线程缓存的内存块, 之后本线程的调用重新从初始大小开始缓存
+    static void releaseThreadCache();
+
+    // 线程缓存内存块的上限, 更大的调用超出部分由arena按需分配
+    static constexpr size_t kMaxCachedBlockSize = 1024 * 1024;
+    // 连续多少次调用用量不到缓存块的1/4时缩小缓存块
+    static constexpr int kShrinkAfterCalls = 64;
+
+  private:
+    static google::protobuf::ArenaOptions borrowOptions(bool* borrowed);
+
+    bool borrowed_ = false;
+    google::protobuf::Arena arena_;
+};
+
+}  // namespace vectordb
@@ -0,0 +1,111 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "proto/olama.pb.h"
+#include "include/types/document.h"
+
+namespace vectordb {
+
+// 单向量检索的合并策略: 短时间内参数相同(集合、过滤条件、limit、检索参数等)的单向量检索
+// 合并为一个SearchRequest发送, 服务端按向量顺序返回的结果再分发给各调用方
+struct SearchBatchingPolicy {
+    // 是否开启合并, 默认关闭
+    bool enabled = false;
+    // 一个请求最多合并的检索数, 达到后立即发送
+    int maxBatch = 32;
+    // 首个检索加入后最多等待的时间(微秒)
+    int maxDelayUs = 500;
+};
+
+struct SearchBatchStats {
+    int64_t searches = 0;
+    int64_t batches = 0;
+};
+
+class SearchBatcher {
+  public:
+    // 发送合并后的请求, 完成时以返回值调用done
+    using SendFunction = std::function<void(const olama::SearchRequest& request, int timeout,
+        SearchDocumentResult* result, std::function<void(int)> done)>;
+
+    SearchBatcher(const SearchBatchingPolicy& policy, SendFunction send);
+    // 立即发送未满的批次并等待所有请求完成
+    ~SearchBatcher();
+
+    SearchBatcher(const SearchBatcher&) = delete;
+    SearchBatcher& operator=(const SearchBatcher&) = delete;
+
+    // 加入一个单向量检索, callback在请求完成后调用, result中追加该向量的检索结果
+    // @param shape: 不含向量的检索请求, shape及timeout均相同的检索才会合并
+    // @param vector: 检索向量
+    // @param dim: 向量维度
+    void submit(const olama::SearchRequest& shape, const float* vector, size_t dim, int timeout,
+        SearchDocumentResult* result, std::function<void(int)> callback);
+
+    SearchBatchStats stats();
+
+  private:
+    struct Batch {
+        olama::SearchRequest request;
+        int timeout = 0;
+        std::vector<SearchDocumentResult*> results;
+        std::vector<std::function<void(int)>> callbacks;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    void send(std::unique_ptr<Batch> batch);
+    void timerLoop();
+
+    SearchBatchingPolicy policy_;
+    SendFunction send_;
+
+    std::mutex mutex_;
+    std::condition_variable timerCv_;
+    std::condition_variable idleCv_;
+    // 请求形状 -> 等待发送的批次
+    std::unordered_map<std::string, std::unique_ptr<Batch>> pending_;
+    int inFlight_ = 0;
+    bool stopped_ = false;
+    SearchBatchStats stats_;
+    std::thread timer_;
+};
+
+}  // namespace vectordb
@@ -0,0 +1,144 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "proto/olama.pb.h"
+#include "include/types/document.h"
+
+namespace vectordb {
+
+// 检索结果缓存策略: 以完整的SearchRequest(集合、向量、过滤条件、limit、检索参数等)为key,
+// 按LRU淘汰; 同一客户端对集合的写操作(upsert/update/dele/truncate/drop)会使该集合的缓存失效
+struct SearchCachePolicy {
+    // 是否开启缓存, 默认关闭
+    bool enabled = false;
+    // 缓存占用内存上限(字节), 按key及结果文档估算
+    size_t maxBytes = 64 << 20;
+    // 缓存有效期(毫秒), 0表示不过期
+    int ttl = 60000;
+    // 分片数, 每个分片独立加锁
+    int shards = 16;
+};
+
+struct SearchCacheStats {
+    int64_t hits = 0;
+    int64_t misses = 0;
+    int64_t inserts = 0;
+    // 因超出内存上限被淘汰、因过期或集合版本变化被丢弃的条目数
+    int64_t evictions = 0;
+    int64_t expirations = 0;
+    int64_t invalidations = 0;
+    int64_t entries = 0;
+    int64_t bytes = 0;
+};
+
+// 集合的缓存版本号, 集合或所在库有写操作时增加, 版本号不同的缓存结果不再命中
+class CollectionVersions {
+  public:
+    uint64_t version(const std::string& dbName, const std::string& collectionName);
+    void bump(const std::string& dbName, const std::string& collectionName);
+    void bump(const std::string& dbName);
+
+  private:
+    std::mutex mutex_;
+    // "库/集合" -> 版本号, 及库 -> 版本号; 集合的有效版本为两者之和
+    std::unordered_map<std::string, uint64_t> collections_;
+    std::unordered_map<std::string, uint64_t> databases_;
+};
+
+class SearchResultCache {
+  public:
+    explicit SearchResultCache(const SearchCachePolicy& policy);
+
+    SearchResultCache(const SearchResultCache&) = delete;
+    SearchResultCache& operator=(const SearchResultCache&) = delete;
+
+    // 返回请求的缓存key
+    static std::string key(const olama::SearchRequest& request);
+
+    // 返回集合当前的版本号, 发送检索前获取, 与结果一同传给insert
+    uint64_t version(const std::string& dbName, const std::string& collectionName);
+
+    // 命中时将缓存的结果追加到result并返回true
+    bool lookup(const std::string& key, const std::string& dbName, const std::string& collectionName,
+        SearchDocumentResult* result);
+
+    // 缓存一次检索的结果
+    // @param version: 发送检索前通过version()获取的版本号, 期间集合有写操作时结果不会再被命中
+    // @param documents: 该请求各向量的检索结果
+    void insert(const std::string& key, const std::string& dbName, const std::string& collectionName,
+        uint64_t version, std::vector<std::vector<Document>> documents, const std::string& warning);
+
+    // 写操作开始及完成时各调用一次, 使集合已缓存及正在检索的结果失效
+    void invalidate(const std::string& dbName, const std::string& collectionName);
+    // 使库下所有集合的缓存失效
+    void invalidate(const std::string& dbName);
+
+    void clear();
+
+    SearchCacheStats stats();
+
+  private:
+    struct Entry {
+        std::string key;
+        uint64_t version = 0;
+        std::chrono::steady_clock::time_point expire;
+        size_t bytes = 0;
+        std::vector<std::vector<Document>> documents;
+        std::string warning;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        // 表头为最近使用的条目
+        std::list<Entry> lru;
+        std::unordered_map<std::string, std::list<Entry>::iterator> index;
+        size_t bytes = 0;
+        SearchCacheStats stats;
+    };
+
+    Shard& shard(const std::string& key);
+    void erase(Shard& shard, std::list<Entry>::iterator it);
+
+    SearchCachePolicy policy_;
+    size_t shardBytes_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    CollectionVersions versions_;
+};
+
+}  // namespace vectordb
@@ -0,0 +1,149 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <google/protobuf/arena.h>
+
+#include "proto/olama.pb.h"
+#include "include/types/document.h"
+
+namespace vectordb {
+
+class RpcClient;
+
+// 只读的连续float数组视图, 不持有数据
+struct FloatSpan {
+    const float* data = nullptr;
+    size_t size = 0;
+
+    const float* begin() const {
+        return data;
+    }
+
+    const float* end() const {
+        return data + size;
+    }
+
+    bool empty() const {
+        return size == 0;
+    }
+
+    float operator[](size_t i) const {
+        return data[i];
+    }
+};
+
+// SearchResponse中单个文档的只读视图, 不拷贝id、向量, 字段在访问时才转换
+class DocumentView {
+  public:
+    explicit DocumentView(const olama::Document& document) : document_(&document) {}
+
+    std::string_view id() const {
+        return document_->id();
+    }
+
+    float score() const {
+        return document_->score();
+    }
+
+    FloatSpan vector() const {
+        return {document_->vector().data(), static_cast<size_t>(document_->vector_size())};
+    }
+
+    bool hasField(const std::string& name) const {
+        return document_->fields().count(name) > 0;
+    }
+
+    // 转换名为name的字段, 字段不存在时返回false
+    bool field(const std::string& name, Field* field) const;
+
+    // 转换为Document, 拷贝id、向量及全部字段
+    Document toDocument() const;
+
+    const olama::Document& proto() const {
+        return *document_;
+    }
+
+  private:
+    const olama::Document* document_;
+};
+
+// 检索结果的只读视图: 持有arena上的SearchResponse, 按需访问其中的文档, 不逐个转换为Document.
+// 再次用于检索时之前的结果被释放, 从中取得的DocumentView、string_view及FloatSpan随之失效
+class SearchResultView {
+  public:
+    bool success = false;
+    std::string message;
+
+    SearchResultView() = default;
+    SearchResultView(SearchResultView&&) = default;
+    SearchResultView& operator=(SearchResultView&&) = default;
+
+    std::string_view warning() const {
+        return response_ ? std::string_view(response_->warning()) : std::string_view();
+    }
+
+    // 结果集数量, 与检索向量数相同
+    size_t size() const {
+        return response_ ? response_->results_size() : 0;
+    }
+
+    // 第query个结果集中的文档数
+    size_t size(size_t query) const {
+        return response_->results(query).documents_size();
+    }
+
+    DocumentView document(size_t query, size_t index) const {
+        return DocumentView(response_->results(query).documents(index));
+    }
+
+    // 转换为SearchDocumentResult, 结果追加到result->documents
+    void toResult(SearchDocumentResult* result) const;
+
+    // 未检索或检索失败时为空
+    const olama::SearchResponse* response() const {
+        return response_;
+    }
+
+  private:
+    friend class RpcClient;
+
+    // 释放之前的结果, 返回新响应所用的arena
+    google::protobuf::Arena* reset();
+
+    std::unique_ptr<google::protobuf::Arena> arena_;
+    olama::SearchResponse* response_ = nullptr;
+};
+
+}  // namespace vectordb
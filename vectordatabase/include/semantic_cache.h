@@ -0,0 +1,165 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "proto/olama.pb.h"
+#include "include/search_cache.h"
+#include "include/types/document.h"
+
+namespace vectordb {
+
+enum class SemanticMetric {
+    // 余弦相似度不低于threshold时命中
+    kCosine,
+    // 欧氏距离不超过threshold时命中
+    kL2,
+};
+
+// 近似检索结果缓存策略: 按集合及除向量外的检索条件(过滤条件、limit、检索参数等)分组, 每组保存最近的
+// 单向量检索, 新检索的向量与已缓存向量足够接近时直接返回缓存的结果
+struct SemanticCachePolicy {
+    // 是否开启缓存, 默认关闭
+    bool enabled = false;
+    SemanticMetric metric = SemanticMetric::kCosine;
+    // 命中阈值, 含义见SemanticMetric
+    float threshold = 0.995f;
+    // 每组最多保存的向量数, 超出后替换最早加入的向量
+    int maxEntries = 1024;
+    // 最多保存的分组数, 超出后丢弃任意一组
+    int maxGroups = 256;
+    // 缓存有效期(毫秒), 0表示不过期
+    int ttl = 60000;
+    // 局部敏感哈希的超平面数, 与签名相差不超过1位的桶都会被检查
+    int hashBits = 12;
+    // 命中时仍发送检索并比较分数的比例, 用于统计缓存结果的分数偏差
+    double verifyRate = 0.01;
+};
+
+struct SemanticCacheStats {
+    int64_t lookups = 0;
+    int64_t hits = 0;
+    int64_t verifications = 0;
+    int64_t inserts = 0;
+    int64_t entries = 0;
+    double hitRate = 0;
+    // 抽样校验中缓存结果与实际结果同一排名分数差的最大值及平均值
+    double maxScoreDrift = 0;
+    double meanScoreDrift = 0;
+};
+
+// 一次未命中(或被抽样校验)的检索, 检索完成后通过insert写入缓存
+struct SemanticCacheProbe {
+    std::string group;
+    std::string dbName;
+    std::string collectionName;
+    uint64_t version = 0;
+    std::vector<float> vector;
+    // 抽样校验时为命中的缓存结果
+    bool verify = false;
+    std::vector<Document> cached;
+};
+
+class SemanticSearchCache {
+  public:
+    explicit SemanticSearchCache(const SemanticCachePolicy& policy);
+
+    SemanticSearchCache(const SemanticSearchCache&) = delete;
+    SemanticSearchCache& operator=(const SemanticSearchCache&) = delete;
+
+    // 只缓存单向量且不含文档id、文本的检索
+    static bool cacheable(const olama::SearchRequest& request);
+
+    // 命中时将缓存的结果追加到result并返回true, 否则填充probe并返回false
+    bool lookup(const olama::SearchRequest& request, SearchDocumentResult* result, SemanticCacheProbe* probe);
+
+    // 写入检索结果, 抽样校验时同时统计分数偏差
+    void insert(const SemanticCacheProbe& probe, const std::vector<Document>& documents, const std::string& warning);
+
+    void invalidate(const std::string& dbName, const std::string& collectionName);
+    void invalidate(const std::string& dbName);
+
+    void clear();
+
+    SemanticCacheStats stats();
+
+  private:
+    struct Entry {
+        std::vector<float> vector;
+        // 余弦度量时为向量模长的倒数
+        float invNorm = 0;
+        uint32_t signature = 0;
+        uint64_t version = 0;
+        std::chrono::steady_clock::time_point expire;
+        std::vector<Document> documents;
+        std::string warning;
+    };
+
+    struct Group {
+        std::mutex mutex;
+        size_t dim = 0;
+        // hashBits个超平面, 按行存储
+        std::vector<float> planes;
+        // 循环使用的条目及下一个写入位置
+        std::vector<Entry> entries;
+        size_t next = 0;
+        // 签名 -> 条目下标
+        std::unordered_map<uint32_t, std::vector<size_t>> buckets;
+    };
+
+    std::shared_ptr<Group> group(const std::string& key, size_t dim, bool create);
+    uint32_t signature(const Group& group, const float* vector) const;
+    // 返回与vector最接近且在阈值内的有效条目, 不存在时返回nullptr
+    const Entry* nearest(Group& group, const float* vector, uint64_t version) const;
+    bool sampleVerify();
+
+    SemanticCachePolicy policy_;
+    CollectionVersions versions_;
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Group>> groups_;
+    std::atomic<int64_t> lookups_{0};
+    std::atomic<int64_t> hits_{0};
+    std::atomic<int64_t> verifications_{0};
+    std::atomic<int64_t> inserts_{0};
+    // 以下由mutex_保护
+    double maxScoreDrift_ = 0;
+    double totalScoreDrift_ = 0;
+    int64_t driftSamples_ = 0;
+};
+
+}  // namespace vectordb
@@ -30,8 +30,6 @@
 
 #include <string>
 
-#include "include/rpc_client.h"
-
 namespace vectordb {
 
 const std::string EventualConsistency = "eventualConsistency";
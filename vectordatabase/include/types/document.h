@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <memory>
 #include <optional>
@@ -35,6 +36,7 @@
 #include <variant>
 #include <vector>
 
+#include "include/types/consts.h"
 #include "include/types/filter.h"
 
 namespace vectordb {
@@ -121,6 +123,33 @@ struct Field {
     }
 };
 
+// 按行连续存储的向量矩阵视图, 不持有数据, 第i行起始于data + i * stride
+struct VectorMatrixView {
+    const float* data = nullptr;
+    size_t rows = 0;
+    size_t dim = 0;
+    // 相邻两行起始位置间隔的float个数, 0表示与dim相同, 否则不能小于dim
+    size_t stride = 0;
+
+    const float* row(size_t i) const {
+        return data + i * (stride == 0 ? dim : stride);
+    }
+};
+
+// 连续存储的文档id视图, 不持有数据, 可由std::vector<std::string>隐式构造
+struct IdSpan {
+    const std::string* data = nullptr;
+    size_t size = 0;
+
+    IdSpan() = default;
+    IdSpan(const std::string* data, size_t size) : data(data), size(size) {}
+    IdSpan(const std::vector<std::string>& ids) : data(ids.data()), size(ids.size()) {}
+
+    const std::string& operator[](size_t i) const {
+        return data[i];
+    }
+};
+
 struct Document {
     std::string id;
     std::vector<float> vector;
@@ -128,14 +157,30 @@ struct Document {
     float score = 0.0f;
 };
 
+// 同一批写入中相同id文档的合并方式
+enum class CoalescePolicy {
+    // 不合并, 所有文档均被发送
+    kNone,
+    // 只保留最后一次写入
+    kReplace,
+    // 以最后一次写入为准, 保留之前写入中未被覆盖的字段, vector为空时沿用之前的vector
+    kMergeFields,
+};
+
 struct UpsertDocumentParams {
     bool buildIndex;
+    CoalescePolicy coalesce{CoalescePolicy::kNone};
 };
 
 struct UpsertDocumentResult {
     bool success;
     std::string message;
     int affectedCount = 0;
+    // 服务端返回的警告, 如写入压力过大
+    std::string warning;
+    // 失败时服务端返回的错误码, 及RPC失败时的gRPC状态码, 成功时均为0
+    int code = 0;
+    int statusCode = 0;
 };
 
 struct QueryDocumentParams {
@@ -159,9 +204,19 @@ struct SearchParms {
     float radius = 0.0f;
 };
 
+// 客户端精确重排: 按limit * overFetch取回候选及其向量, 用精确距离重新计算score后排序并截断为limit,
+// 用于IVF_PQ/IVF_SQ等score为近似值的索引, 以较小的nprobe获得较高的召回率
+struct RerankParams {
+    // 集合的距离度量, L2/IP/COSINE; L2的score为距离的平方, 升序排列, IP/COSINE降序排列
+    std::string metricType = L2;
+    int overFetch = 4;
+};
+
 struct SearchDocumentParams {
     std::unique_ptr<Filter> filter;
     std::unique_ptr<SearchParms> searchParams;
+    // 为空时不重排; 仅对结果为SearchDocumentResult的向量检索生效
+    std::unique_ptr<RerankParams> rerank;
     bool retrieveVector;
     std::vector<std::string> outputFields;
     int64_t limit;
@@ -0,0 +1,67 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+
+#include "include/aimd_window.h"
+
+namespace vectordb {
+
+AimdWindow::AimdWindow(double initial, double minValue, double maxValue, double decreaseFactor)
+    : min_(minValue), max_(std::max(minValue, maxValue)), decreaseFactor_(decreaseFactor) {
+    value_ = std::clamp(initial, min_, max_);
+}
+
+bool AimdWindow::onSuccess() {
+    if (value_ >= max_) {
+        return false;
+    }
+    // 一轮请求全部成功后窗口加1, 窗口为小数时一轮按整数部分计
+    if (++successes_ < static_cast<int>(value_)) {
+        return false;
+    }
+    successes_ = 0;
+    value_ = std::min(value_ + 1, max_);
+    return true;
+}
+
+bool AimdWindow::onOverload(std::chrono::steady_clock::time_point sendTime) {
+    if (sendTime < lastDecrease_) {
+        return false;
+    }
+    lastDecrease_ = std::chrono::steady_clock::now();
+    successes_ = 0;
+    double value = std::max(value_ * decreaseFactor_, min_);
+    if (value >= value_) {
+        return false;
+    }
+    value_ = value;
+    return true;
+}
+
+}  // namespace vectordb
@@ -0,0 +1,67 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "include/async_call.h"
+
+namespace vectordb {
+
+CompletionQueuePool::CompletionQueuePool(int threadNum) {
+    if (threadNum <= 0) {
+        threadNum = 1;
+    }
+    for (int i = 0; i < threadNum; ++i) {
+        queues_.push_back(std::make_unique<grpc::CompletionQueue>());
+    }
+    for (auto& queue : queues_) {
+        threads_.emplace_back(&CompletionQueuePool::poll, queue.get());
+    }
+}
+
+CompletionQueuePool::~CompletionQueuePool() {
+    for (auto& queue : queues_) {
+        queue->Shutdown();
+    }
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+grpc::CompletionQueue* CompletionQueuePool::next() {
+    return queues_[next_.fetch_add(1, std::memory_order_relaxed) % queues_.size()].get();
+}
+
+void CompletionQueuePool::poll(grpc::CompletionQueue* cq) {
+    void* tag = nullptr;
+    bool ok = false;
+    while (cq->Next(&tag, &ok)) {
+        std::unique_ptr<AsyncCallBase> call(static_cast<AsyncCallBase*>(tag));
+        call->onComplete(ok);
+    }
+}
+
+}  // namespace vectordb
@@ -0,0 +1,179 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+
+#include "include/buffered_writer.h"
+#include "include/helper.h"
+
+namespace vectordb {
+
+BufferedWriter::BufferedWriter(RpcClient* client, const std::string& dbName, const std::string& collectionName,
+    const BufferedWriterOption& option)
+    : client_(client), dbName_(dbName), collectionName_(collectionName), option_(option) {
+    option_.maxDocs = std::max(1, option_.maxDocs);
+    option_.maxInFlight = std::max(1, option_.maxInFlight);
+    timer_ = std::thread(&BufferedWriter::timerLoop, this);
+}
+
+BufferedWriter::~BufferedWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+        timerCv_.notify_all();
+    }
+    timer_.join();
+    flush();
+}
+
+std::future<int> BufferedWriter::write(const Document& document) {
+    olama::Document d;
+    convertDocument2Proto(document, &d);
+    return append(&d);
+}
+
+std::future<int> BufferedWriter::write(Document&& document) {
+    olama::Document d;
+    convertDocument2Proto(std::move(document), &d);
+    return append(&d);
+}
+
+std::future<int> BufferedWriter::append(olama::Document* document) {
+    olama::Document& d = *document;
+    int64_t size = static_cast<int64_t>(encodedDocumentSize(d));
+
+    std::future<int> future;
+    std::unique_ptr<Batch> full;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_) {
+            std::promise<int> rejected;
+            rejected.set_value(-1);
+            return rejected.get_future();
+        }
+        if (!pending_) {
+            pending_ = std::make_unique<Batch>();
+            pending_->request.set_database(dbName_);
+            pending_->request.set_collection(collectionName_);
+            pending_->request.set_buildindex(option_.buildIndex);
+            pendingBytes_ = static_cast<int64_t>(pending_->request.ByteSizeLong());
+            pendingSince_ = std::chrono::steady_clock::now();
+            timerCv_.notify_all();
+        }
+        pending_->promises.emplace_back();
+        future = pending_->promises.back().get_future();
+        int slot = pending_->request.documents_size();
+        if (option_.coalesce != CoalescePolicy::kNone) {
+            slot = pending_->slots.emplace(d.id(), slot).first->second;
+        }
+        if (slot < pending_->request.documents_size()) {
+            // 缓冲中已有相同id的文档, 以本次写入替换
+            olama::Document* existing = pending_->request.mutable_documents(slot);
+            if (option_.coalesce == CoalescePolicy::kMergeFields) {
+                mergeDocumentFields(*existing, &d);
+                size = static_cast<int64_t>(encodedDocumentSize(d));
+            }
+            pendingBytes_ -= static_cast<int64_t>(encodedDocumentSize(*existing));
+            existing->Swap(&d);
+        } else {
+            pending_->request.add_documents()->Swap(&d);
+        }
+        pendingBytes_ += size;
+        if (pending_->request.documents_size() >= option_.maxDocs ||
+            (option_.maxBytes > 0 && pendingBytes_ >= option_.maxBytes)) {
+            full = takePending();
+        }
+    }
+    if (full) {
+        send(std::move(full));
+    }
+    return future;
+}
+
+int BufferedWriter::flush() {
+    std::unique_ptr<Batch> batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        batch = takePending();
+    }
+    if (batch) {
+        send(std::move(batch));
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    windowCv_.wait(lock, [this] { return inFlight_ == 0; });
+    int ret = failed_ ? -1 : 0;
+    failed_ = false;
+    return ret;
+}
+
+std::unique_ptr<BufferedWriter::Batch> BufferedWriter::takePending() {
+    pendingBytes_ = 0;
+    return std::move(pending_);
+}
+
+void BufferedWriter::send(std::unique_ptr<Batch> batch) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        windowCv_.wait(lock, [this] { return inFlight_ < option_.maxInFlight; });
+        ++inFlight_;
+    }
+    std::shared_ptr<Batch> shared = std::move(batch);
+    auto result = std::make_shared<UpsertDocumentResult>();
+    client_->sendUpsert(shared->request, result.get(), [this, shared, result](int ret) {
+        for (auto& promise : shared->promises) {
+            promise.set_value(ret);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        --inFlight_;
+        if (ret != 0) {
+            failed_ = true;
+        }
+        windowCv_.notify_all();
+    }, option_.timeout, true);
+}
+
+void BufferedWriter::timerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopped_) {
+        if (!pending_) {
+            timerCv_.wait(lock);
+            continue;
+        }
+        std::chrono::steady_clock::time_point deadline = pendingSince_ + std::chrono::milliseconds(option_.maxDelay);
+        if (std::chrono::steady_clock::now() < deadline) {
+            timerCv_.wait_until(lock, deadline);
+            continue;
+        }
+        std::unique_ptr<Batch> batch = takePending();
+        lock.unlock();
+        send(std::move(batch));
+        lock.lock();
+    }
+}
+
+}  // namespace vectordb
@@ -0,0 +1,638 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "include/bulk_importer.h"
+#include "include/helper.h"
+#include "include/json_line_parser.h"
+
+namespace vectordb {
+
+namespace {
+
+int mapFile(const std::string& path, const char** data, size_t* size, std::string* message) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        *message = "open " + path + " failed: " + std::strerror(errno);
+        return -1;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        *message = "stat " + path + " failed: " + std::strerror(errno);
+        ::close(fd);
+        return -1;
+    }
+    *size = static_cast<size_t>(st.st_size);
+    *data = nullptr;
+    if (*size > 0) {
+        void* addr = ::mmap(nullptr, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            *message = "mmap " + path + " failed: " + std::strerror(errno);
+            ::close(fd);
+            return -1;
+        }
+        // 按顺序读取, 让内核预读并尽早回收已读的页
+        ::madvise(addr, *size, MADV_SEQUENTIAL);
+        *data = static_cast<const char*>(addr);
+    }
+    ::close(fd);
+    return 0;
+}
+
+void unmapFile(const char* data, size_t size) {
+    if (data != nullptr) {
+        ::munmap(const_cast<char*>(data), size);
+    }
+}
+
+class MappedFile {
+  public:
+    MappedFile() = default;
+    ~MappedFile() {
+        unmapFile(data_, size_);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    int open(const std::string& path, std::string* message) {
+        return mapFile(path, &data_, &size_, message);
+    }
+    const char* data() const {
+        return data_;
+    }
+    size_t size() const {
+        return size_;
+    }
+
+  private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+bool endsWith(const std::string& str, const std::string& suffix) {
+    return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+uint32_t readUint32(const char* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+}  // namespace
+
+VectorFileReader::~VectorFileReader() {
+    unmapFile(data_, size_);
+}
+
+int VectorFileReader::fail(const std::string& message) {
+    message_ = message;
+    return -1;
+}
+
+int VectorFileReader::open(const std::string& path, VectorFileFormat format) {
+    if (format == VectorFileFormat::kAuto) {
+        if (endsWith(path, ".fvecs")) {
+            format = VectorFileFormat::kFvecs;
+        } else if (endsWith(path, ".bvecs")) {
+            format = VectorFileFormat::kBvecs;
+        } else if (endsWith(path, ".npy")) {
+            format = VectorFileFormat::kNpy;
+        } else {
+            return fail("unknown vector file format: " + path);
+        }
+    }
+    unmapFile(data_, size_);
+    data_ = nullptr;
+    rows_ = dim_ = 0;
+    dimPrefix_ = false;
+    if (mapFile(path, &data_, &size_, &message_) != 0) {
+        return -1;
+    }
+    if (format == VectorFileFormat::kNpy) {
+        return parseNpyHeader();
+    }
+
+    // fvecs/bvecs各行维度相同, 由首行得出行长度; 文件长度需为行长度的整数倍
+    // 其余各行的维度在appendRow读取该行时检查, 避免打开文件时遍历整个文件
+    type_ = format == VectorFileFormat::kFvecs ? ElementType::kFloat32 : ElementType::kUint8;
+    dimPrefix_ = true;
+    size_t elementSize = type_ == ElementType::kFloat32 ? sizeof(float) : sizeof(uint8_t);
+    if (size_ == 0) {
+        return 0;
+    }
+    if (size_ < sizeof(uint32_t)) {
+        return fail("truncated vector file: " + path);
+    }
+    dim_ = readUint32(data_);
+    rowStride_ = sizeof(uint32_t) + dim_ * elementSize;
+    if (dim_ == 0 || size_ % rowStride_ != 0) {
+        return fail("invalid vector file: " + path + ", size is not a multiple of the row size");
+    }
+    offset_ = sizeof(uint32_t);
+    rows_ = size_ / rowStride_;
+    if (readUint32(data_ + (rows_ - 1) * rowStride_) != dim_) {
+        return fail("invalid vector file: " + path + ", rows have different dimensions");
+    }
+    return 0;
+}
+
+int VectorFileReader::parseNpyHeader() {
+    static const char kMagic[] = "\x93NUMPY";
+    const size_t magicLen = sizeof(kMagic) - 1;
+    if (size_ < magicLen + 4 || std::memcmp(data_, kMagic, magicLen) != 0) {
+        return fail("invalid npy file: bad magic");
+    }
+    uint8_t major = static_cast<uint8_t>(data_[magicLen]);
+    size_t headerLen;
+    size_t headerStart;
+    if (major == 1) {
+        headerLen = static_cast<uint8_t>(data_[8]) | (static_cast<uint8_t>(data_[9]) << 8);
+        headerStart = 10;
+    } else if (major == 2 || major == 3) {
+        if (size_ < 12) {
+            return fail("invalid npy file: truncated header");
+        }
+        headerLen = readUint32(data_ + 8);
+        headerStart = 12;
+    } else {
+        return fail("unsupported npy version " + std::to_string(major));
+    }
+    if (headerStart + headerLen > size_) {
+        return fail("invalid npy file: truncated header");
+    }
+    std::string header(data_ + headerStart, headerLen);
+
+    auto valueOf = [&header](const std::string& key) -> std::string {
+        size_t pos = header.find("'" + key + "'");
+        if (pos == std::string::npos) {
+            return std::string();
+        }
+        pos = header.find(':', pos);
+        if (pos == std::string::npos) {
+            return std::string();
+        }
+        size_t begin = header.find_first_not_of(' ', pos + 1);
+        if (begin == std::string::npos) {
+            return std::string();
+        }
+        size_t end = header[begin] == '(' ? header.find(')', begin) + 1 : header.find_first_of(",}", begin);
+        return header.substr(begin, end - begin);
+    };
+    std::string descr = valueOf("descr");
+    if (descr == "'<f4'") {
+        type_ = ElementType::kFloat32;
+    } else if (descr == "'<f8'") {
+        type_ = ElementType::kFloat64;
+    } else if (descr == "'|u1'" || descr == "'<u1'") {
+        type_ = ElementType::kUint8;
+    } else {
+        return fail("unsupported npy dtype " + descr + ", expect <f4, <f8 or |u1");
+    }
+    if (valueOf("fortran_order") != "False") {
+        return fail("unsupported npy layout, expect fortran_order False");
+    }
+    std::string shape = valueOf("shape");
+    size_t rows = 0;
+    size_t dim = 0;
+    if (std::sscanf(shape.c_str(), "(%zu, %zu)", &rows, &dim) != 2) {
+        return fail("unsupported npy shape " + shape + ", expect (rows, dim)");
+    }
+    size_t elementSize = type_ == ElementType::kFloat32 ? sizeof(float)
+        : type_ == ElementType::kFloat64                ? sizeof(double)
+                                                        : sizeof(uint8_t);
+    // 先除后比较, 避免构造的shape使dim * elementSize或rows * rowStride_溢出后通过检查
+    if (dim > std::numeric_limits<size_t>::max() / elementSize) {
+        return fail("invalid npy file: data shorter than shape " + shape);
+    }
+    offset_ = headerStart + headerLen;
+    rowStride_ = dim * elementSize;
+    if (rowStride_ > 0 && rows > (size_ - offset_) / rowStride_) {
+        return fail("invalid npy file: data shorter than shape " + shape);
+    }
+    rows_ = rows;
+    dim_ = dim;
+    return 0;
+}
+
+int VectorFileReader::appendRow(size_t row, google::protobuf::RepeatedField<float>* vector) const {
+    const char* p = data_ + offset_ + row * rowStride_;
+    if (dimPrefix_ && readUint32(p - sizeof(uint32_t)) != dim_) {
+        return -1;
+    }
+    switch (type_) {
+        case ElementType::kFloat32:
+            copyVector2Proto(reinterpret_cast<const float*>(p), dim_, vector);
+            break;
+        case ElementType::kFloat64:
+            vector->Reserve(vector->size() + static_cast<int>(dim_));
+            for (size_t i = 0; i < dim_; ++i) {
+                double value;
+                std::memcpy(&value, p + i * sizeof(double), sizeof(double));
+                vector->AddAlreadyReserved(static_cast<float>(value));
+            }
+            break;
+        case ElementType::kUint8:
+            vector->Reserve(vector->size() + static_cast<int>(dim_));
+            for (size_t i = 0; i < dim_; ++i) {
+                vector->AddAlreadyReserved(static_cast<uint8_t>(p[i]));
+            }
+            break;
+    }
+    return 0;
+}
+
+struct BulkImporter::TaskProgress {
+    Task task;
+    // 未完成的请求数, 处理任务的线程在发送完所有请求前持有一个计数
+    std::atomic<int> pending{1};
+    std::atomic<int64_t> affectedCount{0};
+    std::atomic<bool> failed{false};
+};
+
+int parseSidecarLine(std::string_view line, const std::string& idField, olama::Document* doc,
+    std::string* message) {
+    JsonLineParser parser(line);
+    if (parser.parse(idField, doc) != 0) {
+        if (message != nullptr) {
+            *message = parser.message();
+        }
+        return -1;
+    }
+    return 0;
+}
+
+BulkImporter::BulkImporter(RpcClient* client, const std::string& dbName, const std::string& collectionName,
+    const BulkImportOption& option)
+    : client_(client), dbName_(dbName), collectionName_(collectionName), option_(option) {
+    option_.batchRows = std::max(1, option_.batchRows);
+    option_.workerNum = std::max(1, option_.workerNum);
+    option_.maxInFlight = std::max(1, option_.maxInFlight);
+    if (option_.adaptiveInFlight) {
+        IngestRateOption rateOption;
+        rateOption.maxInFlight = option_.maxInFlight;
+        rateOption.initialInFlight = std::max(1, option_.maxInFlight / 2);
+        rateController_ = std::make_unique<IngestRateController>(rateOption);
+    }
+}
+
+int BulkImporter::run(const std::string& vectorPath, BulkImportStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.clear();
+        acked_.clear();
+        closed_ = false;
+        failed_ = false;
+        stats_ = BulkImportStats();
+    }
+
+    VectorFileReader reader;
+    MappedFile sidecar;
+    std::string message;
+    if (reader.open(vectorPath, option_.format) != 0) {
+        fail(reader.message());
+    } else if (!option_.sidecarPath.empty() && sidecar.open(option_.sidecarPath, &message) != 0) {
+        fail(message);
+    } else if (!option_.journalPath.empty()) {
+        std::string source = "rows=" + std::to_string(reader.rows()) + " dim=" + std::to_string(reader.dim()) +
+                             " vector=" + vectorPath + " sidecar=" + option_.sidecarPath;
+        if (journal_.open(option_.journalPath, source) != 0) {
+            fail(journal_.message());
+        } else {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.resumedRows = journal_.ackedRows();
+        }
+    }
+
+    if (!failed()) {
+        std::vector<std::thread> workers;
+        for (int i = 0; i < option_.workerNum; ++i) {
+            workers.emplace_back(&BulkImporter::workerLoop, this, &reader, sidecar.data());
+        }
+
+        // 主线程只定位每批行在JSONL中的字节区间, 解析与序列化在工作线程中进行
+        size_t queueLimit = static_cast<size_t>(option_.workerNum) * 2;
+        size_t pos = 0;
+        for (size_t row = 0; row < reader.rows() && !failed(); row += option_.batchRows) {
+            Task task{row, std::min(reader.rows(), row + option_.batchRows), pos, pos};
+            if (sidecar.data() != nullptr) {
+                size_t r = task.beginRow;
+                for (; r < task.endRow && pos < sidecar.size(); ++r) {
+                    const void* newline = std::memchr(sidecar.data() + pos, '\n', sidecar.size() - pos);
+                    pos = newline == nullptr ? sidecar.size()
+                                             : static_cast<const char*>(newline) - sidecar.data() + 1;
+                }
+                task.sidecarEnd = pos;
+                if (r < task.endRow) {
+                    fail("sidecar " + option_.sidecarPath + " has fewer lines than the " +
+                         std::to_string(reader.rows()) + " vector rows");
+                    break;
+                }
+            }
+            if (!option_.journalPath.empty() && journal_.acked(task.beginRow, task.endRow)) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            queueNotFull_.wait(lock, [this, queueLimit] { return queue_.size() < queueLimit || failed_; });
+            queue_.push_back(task);
+            queueNotEmpty_.notify_one();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+            queueNotEmpty_.notify_all();
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        windowAvailable_.wait(lock, [this] { return inFlight_ == 0 || !acked_.empty(); });
+        writeAcked(&lock);
+        if (inFlight_ == 0 && acked_.empty()) {
+            break;
+        }
+    }
+    journal_.close();
+    stats_.inFlightLimit = inFlightLimit();
+    stats_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (stats_.seconds > 0) {
+        stats_.rowsPerSecond = stats_.rows / stats_.seconds;
+        stats_.bytesPerSecond = stats_.bytes / stats_.seconds;
+    }
+    if (stats != nullptr) {
+        *stats = stats_;
+    }
+    return failed_ ? -1 : 0;
+}
+
+void BulkImporter::workerLoop(const VectorFileReader* reader, const char* sidecar) {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            queueNotEmpty_.wait(lock, [this] { return !queue_.empty() || closed_; });
+            if (queue_.empty()) {
+                return;
+            }
+            task = queue_.front();
+            queue_.pop_front();
+            queueNotFull_.notify_one();
+        }
+        if (!failed()) {
+            processTask(task, reader, sidecar);
+        }
+    }
+}
+
+int BulkImporter::processTask(const Task& task, const VectorFileReader* reader, const char* sidecar) {
+    // 超过字节上限时发送并清空请求, 已分配的文档对象留待复用
+    olama::UpsertRequest request;
+    request.set_database(dbName_);
+    request.set_collection(collectionName_);
+    request.set_buildindex(option_.buildIndex);
+    size_t headerSize = request.ByteSizeLong();
+    size_t budget = option_.batchBytes > 0 ? static_cast<size_t>(option_.batchBytes) : SIZE_MAX;
+    size_t requestSize = headerSize;
+
+    auto progress = std::make_shared<TaskProgress>();
+    progress->task = task;
+    // 上次运行中已发送但未确认的批次可能已部分写入, 只重发服务端不存在的行
+    std::unordered_set<std::string> existing;
+    if (!option_.journalPath.empty()) {
+        if (journal_.started(task.beginRow, task.endRow) && existingIds(task, sidecar, &existing) != 0) {
+            return -1;
+        }
+        if (journal_.markStarted(task.beginRow, task.endRow) != 0) {
+            fail(journal_.message());
+            return -1;
+        }
+    }
+    int64_t verifiedRows = 0;
+
+    olama::Document doc;
+    size_t linePos = task.sidecarBegin;
+    std::string message;
+    for (size_t row = task.beginRow; row < task.endRow; ++row) {
+        doc.Clear();
+        if (sidecar != nullptr) {
+            const char* line = sidecar + linePos;
+            const void* newline = std::memchr(line, '\n', task.sidecarEnd - linePos);
+            size_t lineLen = newline == nullptr ? task.sidecarEnd - linePos
+                                                : static_cast<const char*>(newline) - line;
+            linePos += lineLen + 1;
+            if (parseSidecarLine(std::string_view(line, lineLen), option_.idField, &doc, &message) != 0) {
+                fail("sidecar " + option_.sidecarPath + " line " + std::to_string(row + 1) + ": " + message);
+                progress->failed = true;
+                finishRequest(progress);
+                return -1;
+            }
+        } else {
+            doc.set_id(std::to_string(row));
+        }
+        if (existing.count(doc.id()) > 0) {
+            ++verifiedRows;
+            continue;
+        }
+        if (reader->appendRow(row, doc.mutable_vector()) != 0) {
+            fail("vector file row " + std::to_string(row + 1) + " has a different dimension from the first row");
+            progress->failed = true;
+            finishRequest(progress);
+            return -1;
+        }
+
+        size_t docSize = encodedDocumentSize(doc);
+        if (request.documents_size() > 0 && requestSize + docSize > budget) {
+            send(request, request.documents_size(), progress);
+            request.clear_documents();
+            requestSize = headerSize;
+        }
+        request.add_documents()->Swap(&doc);
+        requestSize += docSize;
+    }
+    if (request.documents_size() > 0) {
+        send(request, request.documents_size(), progress);
+    }
+    if (verifiedRows > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.verifiedRows += verifiedRows;
+    }
+    finishRequest(progress);
+    return 0;
+}
+
+int BulkImporter::existingIds(const Task& task, const char* sidecar, std::unordered_set<std::string>* ids) {
+    std::vector<std::string> documentIds;
+    documentIds.reserve(task.endRow - task.beginRow);
+    olama::Document doc;
+    std::string message;
+    size_t linePos = task.sidecarBegin;
+    for (size_t row = task.beginRow; row < task.endRow; ++row) {
+        if (sidecar == nullptr) {
+            documentIds.push_back(std::to_string(row));
+            continue;
+        }
+        const char* line = sidecar + linePos;
+        const void* newline = std::memchr(line, '\n', task.sidecarEnd - linePos);
+        size_t lineLen = newline == nullptr ? task.sidecarEnd - linePos : static_cast<const char*>(newline) - line;
+        linePos += lineLen + 1;
+        doc.Clear();
+        if (parseSidecarLine(std::string_view(line, lineLen), option_.idField, &doc, &message) != 0) {
+            fail("sidecar " + option_.sidecarPath + " line " + std::to_string(row + 1) + ": " + message);
+            return -1;
+        }
+        documentIds.push_back(doc.id());
+    }
+
+    QueryDocumentParams params;
+    params.retrieveVector = false;
+    params.outputFields = {"id"};
+    params.offset = 0;
+    params.limit = static_cast<int64_t>(documentIds.size());
+    QueryDocumentResult result;
+    if (client_->query(dbName_, collectionName_, documentIds, &params, &result, option_.timeout) != 0) {
+        fail("verify rows " + std::to_string(task.beginRow) + "-" + std::to_string(task.endRow) + " failed: " +
+             result.message);
+        return -1;
+    }
+    for (auto& document : result.documents) {
+        ids->insert(std::move(document.id));
+    }
+    return 0;
+}
+
+void BulkImporter::send(const olama::UpsertRequest& request, int64_t rows,
+    const std::shared_ptr<TaskProgress>& progress) {
+    int64_t bytes = static_cast<int64_t>(request.ByteSizeLong());
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            windowAvailable_.wait(lock, [this] { return inFlight_ < inFlightLimit() || !acked_.empty(); });
+            writeAcked(&lock);
+            if (inFlight_ < inFlightLimit()) {
+                break;
+            }
+        }
+        if (failed_) {
+            progress->failed = true;
+            return;
+        }
+        ++inFlight_;
+    }
+    ++progress->pending;
+    auto result = std::make_shared<UpsertDocumentResult>();
+    auto sendTime = std::chrono::steady_clock::now();
+    client_->sendUpsert(request, result.get(), [this, result, bytes, rows, progress, sendTime](int ret) {
+        bool throttled = false;
+        if (rateController_) {
+            throttled = rateController_->onResponse(ret, *result, sendTime);
+        }
+        if (ret == 0) {
+            progress->affectedCount += result->affectedCount;
+        } else {
+            progress->failed = true;
+            fail(result->message);
+        }
+        // 先将批次加入日志队列再释放窗口, run()等待窗口清空时一并写完日志
+        finishRequest(progress);
+        std::lock_guard<std::mutex> lock(mutex_);
+        --inFlight_;
+        ++stats_.requests;
+        if (throttled) {
+            ++stats_.throttledRequests;
+        }
+        if (ret == 0) {
+            stats_.rows += rows;
+            stats_.bytes += bytes;
+            stats_.affectedCount += result->affectedCount;
+        }
+        windowAvailable_.notify_all();
+    }, option_.timeout, true);
+}
+
+void BulkImporter::finishRequest(const std::shared_ptr<TaskProgress>& progress) {
+    if (--progress->pending > 0 || progress->failed || option_.journalPath.empty()) {
+        return;
+    }
+    // 写日志需要落盘, 可能在完成队列线程中调用, 因此只入队并唤醒导入线程
+    std::lock_guard<std::mutex> lock(mutex_);
+    acked_.push_back(progress);
+    windowAvailable_.notify_all();
+}
+
+void BulkImporter::writeAcked(std::unique_lock<std::mutex>* lock) {
+    while (!acked_.empty()) {
+        auto progress = std::move(acked_.front());
+        acked_.pop_front();
+        lock->unlock();
+        const Task& task = progress->task;
+        if (journal_.markAcked(task.beginRow, task.endRow, progress->affectedCount) != 0) {
+            fail(journal_.message());
+        }
+        lock->lock();
+    }
+}
+
+int BulkImporter::inFlightLimit() const {
+    return rateController_ ? rateController_->window() : option_.maxInFlight;
+}
+
+void BulkImporter::fail(const std::string& message) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!failed_) {
+        failed_ = true;
+        stats_.message = message;
+    }
+    queueNotFull_.notify_all();
+}
+
+bool BulkImporter::failed() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return failed_;
+}
+
+}  // namespace vectordb
@@ -0,0 +1,224 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <memory>
+
+#include "include/bulk_writer.h"
+#include "include/helper.h"
+
+namespace vectordb {
+
+BulkWriter::BulkWriter(RpcClient* client, const std::string& dbName, const std::string& collectionName,
+    const BulkWriterOption& option)
+    : client_(client), dbName_(dbName), collectionName_(collectionName), option_(option) {
+    option_.batchDocs = std::max(1, option_.batchDocs);
+    option_.workerNum = std::max(1, option_.workerNum);
+    option_.maxInFlight = std::max(1, option_.maxInFlight);
+    option_.maxQueuedBatches = std::max(1, option_.maxQueuedBatches);
+    if (option_.adaptiveInFlight) {
+        IngestRateOption rateOption;
+        rateOption.maxInFlight = option_.maxInFlight;
+        rateOption.initialInFlight = std::max(1, option_.maxInFlight / 2);
+        rateController_ = std::make_unique<IngestRateController>(rateOption);
+    }
+    start_ = std::chrono::steady_clock::now();
+    for (int i = 0; i < option_.workerNum; ++i) {
+        workers_.emplace_back(&BulkWriter::workerLoop, this);
+    }
+}
+
+BulkWriter::~BulkWriter() {
+    close();
+}
+
+int BulkWriter::write(const Document& document) {
+    return write(Document(document));
+}
+
+int BulkWriter::write(Document&& document) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (closed_) {
+        return -1;
+    }
+    pending_.push_back(std::move(document));
+    if (pending_.size() >= static_cast<size_t>(option_.batchDocs)) {
+        enqueuePending(&lock);
+    }
+    return 0;
+}
+
+int BulkWriter::write(const std::vector<Document>& documents) {
+    for (const auto& document : documents) {
+        if (write(document) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void BulkWriter::enqueuePending(std::unique_lock<std::mutex>* lock) {
+    queueNotFull_.wait(*lock, [this] {
+        return queue_.size() < static_cast<size_t>(option_.maxQueuedBatches);
+    });
+    // 等待期间其他写入线程可能已将文档入队
+    if (pending_.empty()) {
+        return;
+    }
+    queue_.push_back(std::move(pending_));
+    pending_.clear();
+    queueNotEmpty_.notify_one();
+}
+
+void BulkWriter::workerLoop() {
+    olama::UpsertRequest header;
+    header.set_database(dbName_);
+    header.set_collection(collectionName_);
+    header.set_buildindex(option_.buildIndex);
+    size_t headerSize = header.ByteSizeLong();
+    size_t budget = option_.batchBytes > 0 ? static_cast<size_t>(option_.batchBytes) : SIZE_MAX;
+
+    while (true) {
+        std::vector<Document> documents;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            queueNotEmpty_.wait(lock, [this] { return !queue_.empty() || closed_; });
+            if (queue_.empty()) {
+                return;
+            }
+            documents = std::move(queue_.front());
+            queue_.pop_front();
+            queueNotFull_.notify_one();
+        }
+        std::vector<Document*> coalesced = coalesceOwnedDocuments(&documents, option_.coalesce);
+        if (coalesced.size() < documents.size()) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.coalescedDocuments += static_cast<int64_t>(documents.size() - coalesced.size());
+        }
+        olama::UpsertRequest request = header;
+        size_t requestSize = headerSize;
+        for (Document* document : coalesced) {
+            olama::Document d;
+            convertDocument2Proto(std::move(*document), &d);
+            size_t docSize = encodedDocumentSize(d);
+            if (request.documents_size() > 0 && requestSize + docSize > budget) {
+                send(request);
+                request = header;
+                requestSize = headerSize;
+            }
+            request.add_documents()->Swap(&d);
+            requestSize += docSize;
+        }
+        if (request.documents_size() > 0) {
+            send(request);
+        }
+    }
+}
+
+void BulkWriter::send(const olama::UpsertRequest& request) {
+    int64_t bytes = static_cast<int64_t>(request.ByteSizeLong());
+    int64_t documents = request.documents_size();
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        windowAvailable_.wait(lock, [this] { return inFlight_ < inFlightLimit(); });
+        ++inFlight_;
+    }
+    auto result = std::make_shared<UpsertDocumentResult>();
+    auto sendTime = std::chrono::steady_clock::now();
+    client_->sendUpsert(request, result.get(), [this, result, bytes, documents, sendTime](int ret) {
+        bool throttled = false;
+        if (rateController_) {
+            throttled = rateController_->onResponse(ret, *result, sendTime);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (throttled) {
+            ++stats_.throttledBatches;
+        }
+        --inFlight_;
+        ++stats_.batches;
+        if (ret == 0) {
+            stats_.documents += documents;
+            stats_.bytes += bytes;
+            stats_.affectedCount += result->affectedCount;
+        } else {
+            ++stats_.failedBatches;
+            stats_.failedDocuments += documents;
+            if (stats_.message.empty()) {
+                stats_.message = result->message;
+            }
+        }
+        windowAvailable_.notify_all();
+    }, option_.timeout, true);
+}
+
+int BulkWriter::close(BulkWriterStats* stats) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!closed_) {
+            if (!pending_.empty()) {
+                enqueuePending(&lock);
+            }
+            closed_ = true;
+            queueNotEmpty_.notify_all();
+        }
+    }
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    windowAvailable_.wait(lock, [this] { return inFlight_ == 0; });
+    if (stats != nullptr) {
+        *stats = stats_;
+        fillRates(stats);
+    }
+    return stats_.failedBatches == 0 ? 0 : -1;
+}
+
+BulkWriterStats BulkWriter::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    BulkWriterStats stats = stats_;
+    fillRates(&stats);
+    return stats;
+}
+
+int BulkWriter::inFlightLimit() const {
+    return rateController_ ? rateController_->window() : option_.maxInFlight;
+}
+
+void BulkWriter::fillRates(BulkWriterStats* stats) const {
+    stats->inFlightLimit = inFlightLimit();
+    stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    if (stats->seconds > 0) {
+        stats->docsPerSecond = stats->documents / stats->seconds;
+        stats->bytesPerSecond = stats->bytes / stats->seconds;
+    }
+}
+
+}  // namespace vectordb
@@ -0,0 +1,176 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <chrono>
+#include <limits>
+
+#include <grpcpp/create_channel.h>
+#include <grpcpp/impl/codegen/client_interceptor.h>
+
+#include "include/channel_pool.h"
+
+namespace vectordb {
+
+namespace {
+
+// 用于区分连接的channel参数, 参数不同的channel不会共享subchannel
+const char kChannelIndexArg[] = "vectordb.channel_index";
+
+class AuthInterceptor : public grpc::experimental::Interceptor {
+  public:
+    AuthInterceptor(const std::string& username, const std::string& api_key)
+        : auth_token_("Bearer account=" + username + "&api_key=" + api_key) {}
+
+    void Intercept(grpc::experimental::InterceptorBatchMethods* methods) override {
+        if (methods->QueryInterceptionHookPoint(
+                grpc::experimental::InterceptionHookPoints::PRE_SEND_INITIAL_METADATA)) {
+            auto* metadata = methods->GetSendInitialMetadata();
+            metadata->insert({"authorization", auth_token_});
+        }
+        methods->Proceed();
+    }
+
+  private:
+    std::string auth_token_;
+};
+
+class AuthInterceptorFactory : public grpc::experimental::ClientInterceptorFactoryInterface {
+  public:
+    AuthInterceptorFactory(const std::string& username, const std::string& api_key)
+        : username_(username), api_key_(api_key) {}
+
+    grpc::experimental::Interceptor* CreateClientInterceptor(
+        grpc::experimental::ClientRpcInfo* info) override {
+        return new AuthInterceptor(username_, api_key_);
+    }
+
+  private:
+    std::string username_;
+    std::string api_key_;
+};
+
+}  // namespace
+
+ChannelPool::Lease& ChannelPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        if (entry_ != nullptr) {
+            entry_->outstanding.fetch_sub(1, std::memory_order_relaxed);
+        }
+        entry_ = other.entry_;
+        other.entry_ = nullptr;
+    }
+    return *this;
+}
+
+ChannelPool::Lease::~Lease() {
+    if (entry_ != nullptr) {
+        entry_->outstanding.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+ChannelPool::ChannelPool(const std::string& url, const std::string& username, const std::string& key,
+    int channelNum, int reconnectBackoff, ChannelSelectPolicy policy) : policy_(policy) {
+    std::string rpcTarget;
+    if (url.find("http://") == 0) {
+        rpcTarget = url.substr(7);
+    } else {
+        rpcTarget = url;
+    }
+    if (channelNum < 1) {
+        channelNum = 1;
+    }
+
+    for (int i = 0; i < channelNum; ++i) {
+        std::vector<std::unique_ptr<grpc::experimental::ClientInterceptorFactoryInterface>> interceptors;
+        interceptors.push_back(std::make_unique<AuthInterceptorFactory>(username, key));
+        grpc::ChannelArguments channelArgs;
+        channelArgs.SetMaxReceiveMessageSize(16 * 1024 * 1024);
+        channelArgs.SetMaxSendMessageSize(16 * 1024 * 1024);
+        channelArgs.SetInt(GRPC_ARG_INITIAL_RECONNECT_BACKOFF_MS, reconnectBackoff);
+        channelArgs.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+        channelArgs.SetInt(kChannelIndexArg, i);
+
+        auto entry = std::make_unique<Entry>();
+        entry->channel = grpc::experimental::CreateCustomChannelWithInterceptors(
+            rpcTarget,
+            grpc::InsecureChannelCredentials(),
+            channelArgs,
+            std::move(interceptors));
+        if (!entry->channel) {
+            throw std::runtime_error("Failed to create gRPC channel");
+        }
+        entry->stub = olama::SearchEngine::NewStub(entry->channel);
+        entries_.push_back(std::move(entry));
+    }
+}
+
+ChannelPool::Lease ChannelPool::acquire() {
+    uint64_t start = next_.fetch_add(1, std::memory_order_relaxed);
+    Entry* selected = entries_[start % entries_.size()].get();
+    if (policy_ == ChannelSelectPolicy::kLeastOutstanding && entries_.size() > 1) {
+        int64_t least = std::numeric_limits<int64_t>::max();
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            Entry* entry = entries_[(start + i) % entries_.size()].get();
+            int64_t outstanding = entry->outstanding.load(std::memory_order_relaxed);
+            if (outstanding < least) {
+                least = outstanding;
+                selected = entry;
+            }
+        }
+    }
+    selected->outstanding.fetch_add(1, std::memory_order_relaxed);
+    return Lease(selected);
+}
+
+void ChannelPool::connect() {
+    for (auto& entry : entries_) {
+        entry->channel->GetState(true);
+    }
+}
+
+bool ChannelPool::waitForConnected(int timeout) {
+    std::chrono::system_clock::time_point deadline = std::chrono::system_clock::now() +
+        std::chrono::milliseconds(timeout);
+    connect();
+    for (auto& entry : entries_) {
+        if (!entry->channel->WaitForConnected(deadline)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<int64_t> ChannelPool::outstanding() const {
+    std::vector<int64_t> result;
+    for (const auto& entry : entries_) {
+        result.push_back(entry->outstanding.load(std::memory_order_relaxed));
+    }
+    return result;
+}
+
+}  // namespace vectordb
@@ -0,0 +1,313 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <thread>
+
+#include "include/collection_exporter.h"
+#include "include/helper.h"
+
+namespace vectordb {
+
+namespace {
+
+// 导出文件: 文件头后依次为4字节小端长度 + olama::Document序列化内容
+const char kExportFileMagic[] = "VDBEXP01";
+const size_t kExportFileMagicLen = sizeof(kExportFileMagic) - 1;
+
+}  // namespace
+
+CollectionExporter::CollectionExporter(RpcClient* client, const std::string& dbName,
+    const std::string& collectionName, const CollectionExportOption& option)
+    : client_(client), dbName_(dbName), collectionName_(collectionName), option_(option) {
+    option_.parallelism = std::max(1, option_.parallelism);
+    option_.pageSize = std::max(1, option_.pageSize);
+}
+
+std::vector<std::string> CollectionExporter::splitFilters(const std::string& field, uint64_t min, uint64_t max,
+    int count) {
+    std::vector<std::string> filters;
+    if (max < min) {
+        return filters;
+    }
+    uint64_t span = max - min;
+    uint64_t step = std::max<uint64_t>(1, span / std::max(1, count) + (span % std::max(1, count) != 0 ? 1 : 0));
+    for (uint64_t begin = min;; begin += step) {
+        // 最后一个区间包含max, 且避免begin + step溢出
+        if (max - begin < step) {
+            filters.push_back(field + " >= " + std::to_string(begin) + " and " + field + " <= " + std::to_string(max));
+            break;
+        }
+        filters.push_back(field + " >= " + std::to_string(begin) + " and " + field + " < " +
+                          std::to_string(begin + step));
+    }
+    return filters;
+}
+
+std::vector<std::string> CollectionExporter::buildRanges() const {
+    std::vector<std::string> ranges = option_.rangeFilters;
+    if (ranges.empty() && !option_.splitField.empty()) {
+        ranges = splitFilters(option_.splitField, option_.splitMin, option_.splitMax, option_.splitCount);
+    }
+    if (ranges.empty()) {
+        ranges.push_back(option_.filter);
+        return ranges;
+    }
+    if (!option_.filter.empty()) {
+        for (auto& range : ranges) {
+            range = "(" + option_.filter + ") and (" + range + ")";
+        }
+    }
+    return ranges;
+}
+
+int CollectionExporter::run(const ExportCallback& callback, CollectionExportStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = false;
+        ret_ = 0;
+        stats_ = CollectionExportStats();
+    }
+    callback_ = &callback;
+
+    std::vector<std::string> ranges = buildRanges();
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> workers;
+    int workerNum = std::min(option_.parallelism, static_cast<int>(ranges.size()));
+    for (int i = 0; i < workerNum; ++i) {
+        workers.emplace_back(&CollectionExporter::scanRanges, this, &ranges, &next);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    callback_ = nullptr;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (stats != nullptr) {
+        *stats = stats_;
+        if (stats->seconds > 0) {
+            stats->docsPerSecond = stats->documents / stats->seconds;
+        }
+    }
+    return ret_;
+}
+
+int CollectionExporter::runToFile(const std::string& path, CollectionExportStats* stats) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        if (stats != nullptr) {
+            *stats = CollectionExportStats();
+            stats->message = "open " + path + " failed: " + std::strerror(errno);
+        }
+        return -1;
+    }
+    std::vector<char> buffer(1 << 20);
+    std::setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+    std::fwrite(kExportFileMagic, 1, kExportFileMagicLen, file);
+
+    // 回调在deliverMutex_内串行调用, 序列化缓冲可以复用
+    int64_t bytes = kExportFileMagicLen;
+    olama::Document protoDoc;
+    std::string serialized;
+    std::string writeError;
+    int ret = run([&](Document&& document) {
+        protoDoc.Clear();
+        convertDocument2Proto(std::move(document), &protoDoc);
+        protoDoc.SerializeToString(&serialized);
+        uint32_t len = static_cast<uint32_t>(serialized.size());
+        unsigned char header[4] = {static_cast<unsigned char>(len), static_cast<unsigned char>(len >> 8),
+            static_cast<unsigned char>(len >> 16), static_cast<unsigned char>(len >> 24)};
+        if (std::fwrite(header, 1, sizeof(header), file) != sizeof(header) ||
+            std::fwrite(serialized.data(), 1, serialized.size(), file) != serialized.size()) {
+            writeError = "write " + path + " failed: " + std::strerror(errno);
+            return -1;
+        }
+        bytes += sizeof(header) + serialized.size();
+        return 0;
+    }, stats);
+
+    if (std::fclose(file) != 0 && writeError.empty()) {
+        writeError = "write " + path + " failed: " + std::strerror(errno);
+    }
+    if (stats != nullptr) {
+        stats->bytes = bytes;
+        if (stats->seconds > 0) {
+            stats->bytesPerSecond = bytes / stats->seconds;
+        }
+        if (!writeError.empty()) {
+            stats->message = writeError;
+        }
+    }
+    return writeError.empty() ? ret : -1;
+}
+
+void CollectionExporter::scanRanges(const std::vector<std::string>* ranges, std::atomic<size_t>* next) {
+    for (size_t i = (*next)++; i < ranges->size() && !stopped(); i = (*next)++) {
+        if (scanRange((*ranges)[i]) == 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++stats_.ranges;
+        }
+    }
+}
+
+int CollectionExporter::scanRange(const std::string& filter) {
+    QueryDocumentParams params;
+    if (!filter.empty()) {
+        params.filter = std::make_unique<Filter>(filter);
+    }
+    params.retrieveVector = option_.retrieveVector;
+    params.outputFields = option_.outputFields;
+    params.offset = 0;
+    params.limit = option_.pageSize;
+
+    // 两个结果交替使用: 一个等待下一页, 一个交给回调处理
+    auto current = std::make_unique<QueryDocumentResult>();
+    auto prefetch = std::make_unique<QueryDocumentResult>();
+    std::future<int> pending =
+        client_->queryAsync(dbName_, collectionName_, {}, &params, current.get(), option_.timeout);
+    while (true) {
+        if (pending.get() != 0) {
+            fail(current->message);
+            return -1;
+        }
+        bool hasNext = current->documents.size() >= static_cast<size_t>(option_.pageSize) && !stopped();
+        if (hasNext) {
+            params.offset += option_.pageSize;
+            prefetch->documents.clear();
+            pending = client_->queryAsync(dbName_, collectionName_, {}, &params, prefetch.get(), option_.timeout);
+        }
+        int ret = deliver(&current->documents);
+        if (!hasNext || ret != 0) {
+            if (hasNext) {
+                pending.wait();
+            }
+            return ret;
+        }
+        std::swap(current, prefetch);
+    }
+}
+
+int CollectionExporter::deliver(std::vector<Document>* documents) {
+    std::lock_guard<std::mutex> deliverLock(deliverMutex_);
+    if (stopped()) {
+        return -1;
+    }
+    for (auto& document : *documents) {
+        if ((*callback_)(std::move(document)) != 0) {
+            fail("export stopped by callback");
+            return -1;
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.documents += static_cast<int64_t>(documents->size());
+    ++stats_.pages;
+    return 0;
+}
+
+void CollectionExporter::fail(const std::string& message) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!stopped_) {
+        stopped_ = true;
+        ret_ = -1;
+        stats_.message = message;
+    }
+}
+
+bool CollectionExporter::stopped() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stopped_;
+}
+
+int readExportFile(const std::string& path, const ExportCallback& callback, std::string* message) {
+    std::string error;
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        error = "open " + path + " failed: " + std::strerror(errno);
+    } else {
+        // 记录长度来自文件内容, 分配缓冲区前先用剩余字节数检查
+        long fileSize = -1;
+        if (std::fseek(file, 0, SEEK_END) == 0) {
+            fileSize = std::ftell(file);
+            std::rewind(file);
+        }
+        char magic[kExportFileMagicLen];
+        if (fileSize < 0) {
+            error = "read " + path + " failed: " + std::strerror(errno);
+        } else if (std::fread(magic, 1, sizeof(magic), file) != sizeof(magic) ||
+            std::memcmp(magic, kExportFileMagic, sizeof(magic)) != 0) {
+            error = "invalid export file: " + path;
+        }
+        olama::Document protoDoc;
+        std::string serialized;
+        unsigned char header[4];
+        while (error.empty()) {
+            size_t n = std::fread(header, 1, sizeof(header), file);
+            if (n == 0) {
+                break;
+            }
+            uint32_t len = header[0] | (header[1] << 8) | (header[2] << 16) | (static_cast<uint32_t>(header[3]) << 24);
+            if (n != sizeof(header) || len > static_cast<uint64_t>(fileSize - std::ftell(file))) {
+                error = "truncated export file: " + path;
+                break;
+            }
+            serialized.resize(len);
+            if (std::fread(&serialized[0], 1, len, file) != len || !protoDoc.ParseFromString(serialized)) {
+                error = "truncated export file: " + path;
+                break;
+            }
+            Document document;
+            document.id = protoDoc.id();
+            document.vector.assign(protoDoc.vector().begin(), protoDoc.vector().end());
+            for (const auto& [key, value] : protoDoc.fields()) {
+                convertProto2Field(value, &document.fields[key]);
+            }
+            if (callback(std::move(document)) != 0) {
+                error = "read stopped by callback";
+                break;
+            }
+        }
+        std::fclose(file);
+    }
+    if (!error.empty()) {
+        if (message != nullptr) {
+            *message = error;
+        }
+        return -1;
+    }
+    return 0;
+}
+
+}  // namespace vectordb
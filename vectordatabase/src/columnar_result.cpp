@@ -0,0 +1,131 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+
+#include "include/columnar_result.h"
+
+namespace vectordb {
+
+namespace {
+
+ColumnType columnType(const olama::Field& field) {
+    switch (field.oneof_val_case()) {
+        case olama::Field::kValU64:
+            return ColumnType::kU64;
+        case olama::Field::kValDouble:
+            return ColumnType::kDouble;
+        case olama::Field::kValStr:
+            return ColumnType::kString;
+        default:
+            return ColumnType::kNone;
+    }
+}
+
+void appendValue(const olama::Field* field, FieldColumn* column) {
+    ColumnType type = field != nullptr ? columnType(*field) : ColumnType::kNone;
+    if (column->type == ColumnType::kNone && type != ColumnType::kNone) {
+        // 补齐之前缺少该字段的文档
+        size_t count = column->valid.size();
+        column->type = type;
+        column->u64s.resize(type == ColumnType::kU64 ? count : 0);
+        column->doubles.resize(type == ColumnType::kDouble ? count : 0);
+        column->stringOffsets.assign(type == ColumnType::kString ? count + 1 : 0, 0);
+    }
+    bool valid = type != ColumnType::kNone && type == column->type;
+    column->valid.push_back(valid);
+    switch (column->type) {
+        case ColumnType::kU64:
+            column->u64s.push_back(valid ? field->val_u64() : 0);
+            break;
+        case ColumnType::kDouble:
+            column->doubles.push_back(valid ? field->val_double() : 0);
+            break;
+        case ColumnType::kString:
+            if (valid) {
+                column->strings.append(field->val_str());
+            }
+            column->stringOffsets.push_back(static_cast<uint32_t>(column->strings.size()));
+            break;
+        case ColumnType::kNone:
+            break;
+    }
+}
+
+}  // namespace
+
+const FieldColumn* ColumnarResultSet::field(const std::string& name) const {
+    auto it = std::find(fieldNames.begin(), fieldNames.end(), name);
+    return it == fieldNames.end() ? nullptr : &fields[it - fieldNames.begin()];
+}
+
+void fillColumnarResult(const olama::SearchResponse& response, const std::vector<std::string>& columns,
+    ColumnarSearchResult* result) {
+    result->warning = response.warning();
+    result->results.reserve(result->results.size() + response.results_size());
+    for (const auto& resultSet : response.results()) {
+        result->results.emplace_back();
+        ColumnarResultSet& set = result->results.back();
+        size_t count = resultSet.documents_size();
+        set.size = count;
+        set.idOffsets.reserve(count + 1);
+        set.idOffsets.push_back(0);
+        set.scores.reserve(count);
+        set.fieldNames = columns;
+        set.fields.resize(columns.size());
+        for (auto& column : set.fields) {
+            column.valid.reserve(count);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            const olama::Document& document = resultSet.documents(i);
+            set.ids.append(document.id());
+            set.idOffsets.push_back(static_cast<uint32_t>(set.ids.size()));
+            set.scores.push_back(document.score());
+            if (document.vector_size() > 0 && set.dim == 0) {
+                set.dim = document.vector_size();
+                set.vectors.reserve(count * set.dim);
+                set.vectors.resize(i * set.dim);
+            }
+            if (set.dim > 0) {
+                // 维度不一致的向量截断或补0
+                size_t copied = std::min(set.dim, static_cast<size_t>(document.vector_size()));
+                set.vectors.insert(set.vectors.end(), document.vector().begin(),
+                    document.vector().begin() + copied);
+                set.vectors.resize(set.vectors.size() + set.dim - copied);
+            }
+            for (size_t c = 0; c < columns.size(); ++c) {
+                auto it = document.fields().find(columns[c]);
+                appendValue(it == document.fields().end() ? nullptr : &it->second, &set.fields[c]);
+            }
+        }
+    }
+    result->success = true;
+    result->message = response.msg();
+}
+
+}  // namespace vectordb
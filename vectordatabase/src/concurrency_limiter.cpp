@@ -0,0 +1,126 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+
+#include "include/concurrency_limiter.h"
+
+namespace vectordb {
+
+ConcurrencyLimiter::ConcurrencyLimiter(const ConcurrencyLimitOption& option)
+    : option_(option), limit_(option.initialLimit, std::max(option.minLimit, 1), option.maxLimit,
+          option.backoffRatio) {}
+
+bool ConcurrencyLimiter::acquire(std::chrono::system_clock::time_point deadline) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!hasSlot()) {
+        if (queued_ >= option_.maxQueue) {
+            ++rejected_;
+            return false;
+        }
+        ++queued_;
+        bool ok = cv_.wait_until(lock, deadline, [this] { return hasSlot(); });
+        --queued_;
+        if (!ok) {
+            ++rejected_;
+            return false;
+        }
+    }
+    ++inFlight_;
+    ++accepted_;
+    return true;
+}
+
+bool ConcurrencyLimiter::tryAcquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!hasSlot()) {
+        ++rejected_;
+        return false;
+    }
+    ++inFlight_;
+    ++accepted_;
+    return true;
+}
+
+void ConcurrencyLimiter::release(bool overloaded, std::chrono::steady_clock::time_point start) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (option_.latencyThreshold > 0 &&
+        std::chrono::steady_clock::now() - start > std::chrono::milliseconds(option_.latencyThreshold)) {
+        overloaded = true;
+    }
+    if (overloaded) {
+        ++overloaded_;
+        limit_.onOverload(start);
+    } else if (inFlight_ * 2 >= static_cast<int64_t>(limit_.value())) {
+        // 只有并发接近上限时才提高上限, 避免低负载时上限无限增长
+        limit_.onSuccess();
+    }
+    --inFlight_;
+    if (queued_ > 0) {
+        cv_.notify_all();
+    }
+}
+
+ConcurrencyLimiterStats ConcurrencyLimiter::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ConcurrencyLimiterStats stats;
+    stats.limit = limit_.value();
+    stats.inFlight = inFlight_;
+    stats.queued = queued_;
+    stats.accepted = accepted_;
+    stats.rejected = rejected_;
+    stats.overloaded = overloaded_;
+    return stats;
+}
+
+ConcurrencyLimiter* ConcurrencyLimiterGroup::get(const std::string& key) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto iter = limiters_.find(key);
+        if (iter != limiters_.end()) {
+            return iter->second.get();
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto& limiter = limiters_[key];
+    if (!limiter) {
+        limiter = std::make_unique<ConcurrencyLimiter>(option_);
+    }
+    return limiter.get();
+}
+
+std::map<std::string, ConcurrencyLimiterStats> ConcurrencyLimiterGroup::stats() {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    std::map<std::string, ConcurrencyLimiterStats> result;
+    for (const auto& [key, limiter] : limiters_) {
+        result[key] = limiter->stats();
+    }
+    return result;
+}
+
+}  // namespace vectordb
@@ -0,0 +1,152 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <utility>
+
+#include "include/document_batch_builder.h"
+#include "include/helper.h"
+
+namespace vectordb {
+
+DocumentBatchBuilder::DocumentBatchBuilder(const std::string& dbName, const std::string& collectionName,
+    bool buildIndex, google::protobuf::Arena* arena)
+    : arena_(arena), request_(google::protobuf::Arena::CreateMessage<olama::UpsertRequest>(arena)) {
+    request_->set_database(dbName);
+    request_->set_collection(collectionName);
+    request_->set_buildindex(buildIndex);
+    headerSize_ = request_->ByteSizeLong();
+}
+
+DocumentBatchBuilder::~DocumentBatchBuilder() {
+    if (arena_ == nullptr) {
+        delete request_;
+    }
+}
+
+DocumentBatchBuilder& DocumentBatchBuilder::addDocument(const std::string& id) {
+    if (request_->documents_size() > 0) {
+        finishedSize_ += encodedDocumentSize(request_->documents(request_->documents_size() - 1));
+    }
+    request_->add_documents()->set_id(id);
+    return *this;
+}
+
+DocumentBatchBuilder& DocumentBatchBuilder::setVector(const float* data, size_t dim) {
+    olama::Document* doc = current("setVector");
+    if (doc == nullptr) {
+        return *this;
+    }
+    doc->clear_vector();
+    copyVector2Proto(data, dim, doc->mutable_vector());
+    return *this;
+}
+
+DocumentBatchBuilder& DocumentBatchBuilder::setVector(const std::vector<float>& vector) {
+    return setVector(vector.data(), vector.size());
+}
+
+DocumentBatchBuilder& DocumentBatchBuilder::addFieldStr(const std::string& name, const std::string& value) {
+    olama::Document* doc = current("addFieldStr");
+    if (doc == nullptr) {
+        return *this;
+    }
+    (*doc->mutable_fields())[name].set_val_str(value);
+    return *this;
+}
+
+DocumentBatchBuilder& DocumentBatchBuilder::addFieldStr(const std::string& name, std::string&& value) {
+    olama::Document* doc = current("addFieldStr");
+    if (doc == nullptr) {
+        return *this;
+    }
+    (*doc->mutable_fields())[name].set_val_str(std::move(value));
+    return *this;
+}
+
+DocumentBatchBuilder& DocumentBatchBuilder::addFieldU64(const std::string& name, uint64_t value) {
+    olama::Document* doc = current("addFieldU64");
+    if (doc == nullptr) {
+        return *this;
+    }
+    (*doc->mutable_fields())[name].set_val_u64(value);
+    return *this;
+}
+
+DocumentBatchBuilder& DocumentBatchBuilder::addFieldDouble(const std::string& name, double value) {
+    olama::Document* doc = current("addFieldDouble");
+    if (doc == nullptr) {
+        return *this;
+    }
+    (*doc->mutable_fields())[name].set_val_double(value);
+    return *this;
+}
+
+DocumentBatchBuilder& DocumentBatchBuilder::addFieldStrArr(const std::string& name,
+    const std::vector<std::string>& value) {
+    olama::Document* doc = current("addFieldStrArr");
+    if (doc == nullptr) {
+        return *this;
+    }
+    auto* strArr = (*doc->mutable_fields())[name].mutable_val_str_arr()->mutable_str_arr();
+    strArr->Clear();
+    strArr->Reserve(static_cast<int>(value.size()));
+    for (const auto& str : value) {
+        strArr->Add()->assign(str);
+    }
+    return *this;
+}
+
+size_t DocumentBatchBuilder::size() const {
+    return static_cast<size_t>(request_->documents_size());
+}
+
+size_t DocumentBatchBuilder::byteSize() const {
+    size_t size = headerSize_ + finishedSize_;
+    if (request_->documents_size() > 0) {
+        size += encodedDocumentSize(request_->documents(request_->documents_size() - 1));
+    }
+    return size;
+}
+
+void DocumentBatchBuilder::clear() {
+    request_->clear_documents();
+    finishedSize_ = 0;
+    message_.clear();
+}
+
+olama::Document* DocumentBatchBuilder::current(const char* method) {
+    if (request_->documents_size() == 0) {
+        if (message_.empty()) {
+            message_ = std::string("DocumentBatchBuilder: addDocument must be called before ") + method;
+        }
+        return nullptr;
+    }
+    return request_->mutable_documents(request_->documents_size() - 1);
+}
+
+}  // namespace vectordb
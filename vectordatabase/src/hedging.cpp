@@ -0,0 +1,78 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+
+#include "include/hedging.h"
+
+namespace vectordb {
+
+namespace {
+
+const size_t kRefreshInterval = 32;
+
+}  // namespace
+
+LatencyTracker::LatencyTracker(size_t capacity) : capacity_(capacity == 0 ? 1 : capacity) {
+    samples_.reserve(capacity_);
+}
+
+void LatencyTracker::add(int64_t latencyUs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (samples_.size() < capacity_) {
+        samples_.push_back(latencyUs);
+    } else {
+        samples_[next_] = latencyUs;
+        next_ = (next_ + 1) % capacity_;
+    }
+    ++addsSinceRefresh_;
+}
+
+int64_t LatencyTracker::percentile(double p, size_t minSamples) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (samples_.empty() || samples_.size() < minSamples) {
+        return -1;
+    }
+    if (cachedP_ == p && addsSinceRefresh_ < kRefreshInterval) {
+        return cachedValue_;
+    }
+    std::vector<int64_t> sorted(samples_);
+    size_t rank = static_cast<size_t>(std::clamp(p, 0.0, 1.0) * (sorted.size() - 1));
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    cachedP_ = p;
+    cachedValue_ = sorted[rank];
+    addsSinceRefresh_ = 0;
+    return cachedValue_;
+}
+
+size_t LatencyTracker::sampleCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return samples_.size();
+}
+
+}  // namespace vectordb
@@ -26,6 +26,13 @@
   *THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <unordered_map>
+
+#include <google/protobuf/io/coded_stream.h>
+
 #include "include/helper.h"
 #include "include/rpc_client.h"
 #include "include/types/collection.h"
@@ -88,17 +95,132 @@ void toCollection(const olama::CreateCollectionRequest& collectionItem, Collecti
 }
 
 void convertField2Proto(const Field& field, olama::Field* protoField) {
-    if (field.hasValDouble()) {
-        protoField->set_val_double(field.getValDouble());
-    } else if (field.hasValStr()) {
-        protoField->set_val_str(field.getValStr());
-    } else if (field.hasValU64()) {
-        protoField->set_val_u64(field.getValU64());
-    } else if (field.hasValStrArr()) {
-        for (const auto& str : field.getValStrArr()) {
-            protoField->mutable_val_str_arr()->add_str_arr(str);
+    if (const auto* val = std::get_if<double>(&field.oneofVal)) {
+        protoField->set_val_double(*val);
+    } else if (const auto* val = std::get_if<std::string>(&field.oneofVal)) {
+        protoField->set_val_str(*val);
+    } else if (const auto* val = std::get_if<uint64_t>(&field.oneofVal)) {
+        protoField->set_val_u64(*val);
+    } else if (const auto* val = std::get_if<std::vector<std::string>>(&field.oneofVal)) {
+        auto* strArr = protoField->mutable_val_str_arr()->mutable_str_arr();
+        strArr->Reserve(static_cast<int>(val->size()));
+        for (const auto& str : *val) {
+            strArr->Add()->assign(str);
+        }
+    }
+}
+
+void convertField2Proto(Field&& field, olama::Field* protoField) {
+    if (auto* val = std::get_if<std::string>(&field.oneofVal)) {
+        protoField->set_val_str(std::move(*val));
+    } else if (auto* val = std::get_if<std::vector<std::string>>(&field.oneofVal)) {
+        auto* strArr = protoField->mutable_val_str_arr()->mutable_str_arr();
+        strArr->Reserve(static_cast<int>(val->size()));
+        for (auto& str : *val) {
+            strArr->Add(std::move(str));
+        }
+    } else {
+        convertField2Proto(static_cast<const Field&>(field), protoField);
+    }
+}
+
+void copyVector2Proto(const float* data, size_t dim, google::protobuf::RepeatedField<float>* vector) {
+    if (dim == 0) {
+        return;
+    }
+    vector->Reserve(vector->size() + static_cast<int>(dim));
+    float* dst = vector->AddNAlreadyReserved(static_cast<int>(dim));
+    std::memcpy(dst, data, dim * sizeof(float));
+}
+
+void convertDocument2Proto(const Document& doc, olama::Document* protoDoc) {
+    protoDoc->set_id(doc.id);
+    for (const auto& [key, value] : doc.fields) {
+        convertField2Proto(value, &(*protoDoc->mutable_fields())[key]);
+    }
+    copyVector2Proto(doc.vector.data(), doc.vector.size(), protoDoc->mutable_vector());
+}
+
+void convertDocument2Proto(Document&& doc, olama::Document* protoDoc) {
+    protoDoc->set_id(std::move(doc.id));
+    for (auto& [key, value] : doc.fields) {
+        convertField2Proto(std::move(value), &(*protoDoc->mutable_fields())[key]);
+    }
+    copyVector2Proto(doc.vector.data(), doc.vector.size(), protoDoc->mutable_vector());
+}
+
+size_t encodedDocumentSize(const olama::Document& protoDoc) {
+    size_t size = protoDoc.ByteSizeLong();
+    return 1 + google::protobuf::io::CodedOutputStream::VarintSize64(size) + size;
+}
+
+namespace {
+
+// DocumentT为const Document时合并字段产生的新文档存放在merged中, 否则直接将字段移动到最后一次写入的文档
+template <typename DocumentT, typename Documents>
+std::vector<DocumentT*> coalesce(Documents& documents, CoalescePolicy policy, std::deque<Document>* merged) {
+    std::vector<DocumentT*> result;
+    result.reserve(documents.size());
+    if (policy == CoalescePolicy::kNone) {
+        for (auto& doc : documents) {
+            result.push_back(&doc);
+        }
+        return result;
+    }
+    std::unordered_map<std::string, size_t> slots;
+    slots.reserve(documents.size());
+    for (auto& doc : documents) {
+        auto [iter, inserted] = slots.emplace(doc.id, result.size());
+        if (inserted) {
+            result.push_back(&doc);
+            continue;
+        }
+        DocumentT*& slot = result[iter->second];
+        if (policy == CoalescePolicy::kReplace) {
+            slot = &doc;
+            continue;
+        }
+        if constexpr (std::is_const_v<DocumentT>) {
+            merged->push_back(doc);
+            Document& latest = merged->back();
+            for (const auto& [key, value] : slot->fields) {
+                latest.fields.emplace(key, value);
+            }
+            if (latest.vector.empty()) {
+                latest.vector = slot->vector;
+            }
+            slot = &latest;
+        } else {
+            for (auto& [key, value] : slot->fields) {
+                doc.fields.try_emplace(key, std::move(value));
+            }
+            if (doc.vector.empty()) {
+                doc.vector = std::move(slot->vector);
+            }
+            slot = &doc;
         }
     }
+    return result;
+}
+
+}  // namespace
+
+std::vector<const Document*> coalesceDocuments(const std::vector<Document>& documents, CoalescePolicy policy,
+    std::deque<Document>* merged) {
+    return coalesce<const Document>(documents, policy, merged);
+}
+
+std::vector<Document*> coalesceOwnedDocuments(std::vector<Document>* documents, CoalescePolicy policy) {
+    return coalesce<Document>(*documents, policy, nullptr);
+}
+
+void mergeDocumentFields(const olama::Document& earlier, olama::Document* latest) {
+    for (const auto& [key, value] : earlier.fields()) {
+        latest->mutable_fields()->insert({key, value});
+    }
+    if (latest->vector_size() == 0) {
+        *latest->mutable_vector() = earlier.vector();
+    }
 }
 
 void convertProto2Field(const olama::Field& protoField, Field* field) {
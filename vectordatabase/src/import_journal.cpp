@@ -0,0 +1,193 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include "include/import_journal.h"
+
+namespace vectordb {
+
+ImportJournal::~ImportJournal() {
+    close();
+}
+
+int ImportJournal::open(const std::string& path, const std::string& source) {
+    close();
+    std::lock_guard<std::mutex> lock(mutex_);
+    acked_.clear();
+    started_.clear();
+    affectedCount_ = 0;
+
+    bool exists = false;
+    bool endsWithNewline = true;
+    std::ifstream in(path, std::ios::binary);
+    if (in) {
+        std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        exists = !content.empty();
+        endsWithNewline = content.empty() || content.back() == '\n';
+        std::istringstream lines(content);
+        std::string line;
+        bool first = true;
+        while (std::getline(lines, line)) {
+            if (first) {
+                first = false;
+                if (line != "source " + source) {
+                    message_ = "journal " + path + " belongs to a different import: " + line;
+                    return -1;
+                }
+                continue;
+            }
+            // 进程中断时最后一行可能不完整, 无法解析的行直接忽略
+            std::istringstream fields(line);
+            std::string type;
+            size_t beginRow = 0;
+            size_t endRow = 0;
+            int64_t affectedCount = 0;
+            if (!(fields >> type >> beginRow >> endRow) || beginRow >= endRow) {
+                continue;
+            }
+            if (type == "S") {
+                insertRange(&started_, beginRow, endRow);
+            } else if (type == "A" && (fields >> affectedCount)) {
+                insertRange(&acked_, beginRow, endRow);
+                affectedCount_ += affectedCount;
+            }
+        }
+    }
+
+    file_ = std::fopen(path.c_str(), "a");
+    if (file_ == nullptr) {
+        message_ = "open journal " + path + " failed: " + std::strerror(errno);
+        return -1;
+    }
+    if (!endsWithNewline) {
+        std::fputc('\n', file_);
+    }
+    if (!exists) {
+        return append("source " + source);
+    }
+    return 0;
+}
+
+void ImportJournal::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_ != nullptr) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+bool ImportJournal::acked(size_t beginRow, size_t endRow) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return covers(acked_, beginRow, endRow);
+}
+
+bool ImportJournal::started(size_t beginRow, size_t endRow) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return overlaps(started_, beginRow, endRow) && !covers(acked_, beginRow, endRow);
+}
+
+int ImportJournal::markStarted(size_t beginRow, size_t endRow) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    insertRange(&started_, beginRow, endRow);
+    return append("S " + std::to_string(beginRow) + " " + std::to_string(endRow));
+}
+
+int ImportJournal::markAcked(size_t beginRow, size_t endRow, int64_t affectedCount) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    insertRange(&acked_, beginRow, endRow);
+    affectedCount_ += affectedCount;
+    return append("A " + std::to_string(beginRow) + " " + std::to_string(endRow) + " " +
+                  std::to_string(affectedCount));
+}
+
+int64_t ImportJournal::ackedRows() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t rows = 0;
+    for (const auto& range : acked_) {
+        rows += static_cast<int64_t>(range.second - range.first);
+    }
+    return rows;
+}
+
+int64_t ImportJournal::affectedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return affectedCount_;
+}
+
+std::string ImportJournal::message() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return message_;
+}
+
+void ImportJournal::insertRange(RangeMap* ranges, size_t beginRow, size_t endRow) {
+    auto it = ranges->upper_bound(beginRow);
+    if (it != ranges->begin() && std::prev(it)->second >= beginRow) {
+        --it;
+        beginRow = it->first;
+        endRow = std::max(endRow, it->second);
+        it = ranges->erase(it);
+    }
+    while (it != ranges->end() && it->first <= endRow) {
+        endRow = std::max(endRow, it->second);
+        it = ranges->erase(it);
+    }
+    (*ranges)[beginRow] = endRow;
+}
+
+bool ImportJournal::covers(const RangeMap& ranges, size_t beginRow, size_t endRow) {
+    auto it = ranges.upper_bound(beginRow);
+    return it != ranges.begin() && std::prev(it)->second >= endRow;
+}
+
+bool ImportJournal::overlaps(const RangeMap& ranges, size_t beginRow, size_t endRow) {
+    auto it = ranges.lower_bound(endRow);
+    return it != ranges.begin() && std::prev(it)->second > beginRow;
+}
+
+int ImportJournal::append(const std::string& line) {
+    if (file_ == nullptr) {
+        message_ = "journal is not open";
+        return -1;
+    }
+    // 确认记录需在进程或机器崩溃后仍然有效, 每行写入后同步到磁盘
+    if (std::fputs((line + "\n").c_str(), file_) < 0 || std::fflush(file_) != 0 || ::fdatasync(fileno(file_)) != 0) {
+        message_ = std::string("write journal failed: ") + std::strerror(errno);
+        return -1;
+    }
+    return 0;
+}
+
+}  // namespace vectordb
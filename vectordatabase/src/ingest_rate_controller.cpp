@@ -0,0 +1,129 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+#include <grpcpp/grpcpp.h>
+
+#include "include/ingest_rate_controller.h"
+
+namespace vectordb {
+
+namespace {
+
+// 延迟EWMA的平滑系数, 及判断延迟升高前需要的样本数
+const double kLatencyAlpha = 0.2;
+const int64_t kWarmupSamples = 8;
+// 基线取观测到的最小延迟, 并缓慢向当前延迟靠拢, 以适应数据量增长带来的正常变慢
+const double kBaselineDrift = 0.01;
+
+bool containsThrottleHint(const std::string& message) {
+    static const char* const kHints[] = {"too many", "rate limit", "throttl", "busy", "overload"};
+    std::string lower(message);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    for (const char* hint : kHints) {
+        if (lower.find(hint) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+IngestRateController::IngestRateController(const IngestRateOption& option)
+    : option_(option), window_(option.initialInFlight, std::max(1, option.minInFlight), option.maxInFlight,
+          option.decreaseFactor) {}
+
+int IngestRateController::window() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int>(window_.value());
+}
+
+bool IngestRateController::throttled(int ret, const UpsertDocumentResult& result) {
+    if (!result.warning.empty()) {
+        return true;
+    }
+    if (ret == 0) {
+        return false;
+    }
+    switch (result.statusCode) {
+        case grpc::StatusCode::RESOURCE_EXHAUSTED:
+        case grpc::StatusCode::UNAVAILABLE:
+        case grpc::StatusCode::DEADLINE_EXCEEDED:
+            return true;
+        default:
+            break;
+    }
+    return result.code != 0 && containsThrottleHint(result.message);
+}
+
+bool IngestRateController::onResponse(int ret, const UpsertDocumentResult& result,
+    std::chrono::steady_clock::time_point sendTime) {
+    bool signal = throttled(ret, result);
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ret == 0) {
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(now - sendTime);
+        double sample = static_cast<double>(latency.count());
+        latencyUs_ = samples_ == 0 ? sample : latencyUs_ + kLatencyAlpha * (sample - latencyUs_);
+        if (samples_ == 0 || sample < baselineUs_) {
+            baselineUs_ = sample;
+        } else {
+            baselineUs_ += kBaselineDrift * (sample - baselineUs_);
+        }
+        ++samples_;
+        if (option_.latencyFactor > 0 && samples_ >= kWarmupSamples &&
+            latencyUs_ > baselineUs_ * option_.latencyFactor) {
+            signal = true;
+        }
+    }
+
+    if (signal) {
+        ++stats_.throttled;
+        if (window_.onOverload(sendTime)) {
+            ++stats_.decreases;
+        }
+    } else if (ret == 0 && window_.onSuccess()) {
+        ++stats_.increases;
+    }
+    return signal;
+}
+
+IngestRateStats IngestRateController::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    IngestRateStats stats = stats_;
+    stats.window = static_cast<int>(window_.value());
+    stats.latencyMs = latencyUs_ / 1000;
+    stats.baselineMs = baselineUs_ / 1000;
+    return stats;
+}
+
+}  // namespace vectordb
@@ -0,0 +1,331 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "include/json_line_parser.h"
+
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+namespace vectordb {
+
+namespace {
+
+void appendUtf8(uint32_t codePoint, std::string* out) {
+    if (codePoint < 0x80) {
+        out->push_back(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+        out->push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+        out->push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        out->push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+        out->push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else {
+        out->push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+        out->push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+}  // namespace
+
+int JsonLineParser::parse(const std::string& idField, olama::Document* doc) {
+    bool hasId = false;
+    skipSpace();
+    if (!consume('{')) {
+        return fail("expected '{'");
+    }
+    skipSpace();
+    if (!consume('}')) {
+        while (true) {
+            std::string name;
+            skipSpace();
+            if (parseString(&name) != 0) {
+                return -1;
+            }
+            skipSpace();
+            if (!consume(':')) {
+                return fail("expected ':' after \"" + name + "\"");
+            }
+            skipSpace();
+            if (name == idField) {
+                if (parseId(doc->mutable_id()) != 0) {
+                    return -1;
+                }
+                hasId = true;
+            } else {
+                olama::Field field;
+                bool isNull = false;
+                if (parseValue(&field, &isNull) != 0) {
+                    return -1;
+                }
+                if (!isNull) {
+                    (*doc->mutable_fields())[name].Swap(&field);
+                }
+            }
+            skipSpace();
+            if (consume('}')) {
+                break;
+            }
+            if (!consume(',')) {
+                return fail("expected ',' or '}'");
+            }
+        }
+    }
+    skipSpace();
+    if (p_ != end_) {
+        return fail("unexpected trailing characters");
+    }
+    if (!hasId) {
+        return fail("missing \"" + idField + "\"");
+    }
+    return 0;
+}
+
+int JsonLineParser::fail(const std::string& message) {
+    message_ = message;
+    return -1;
+}
+
+void JsonLineParser::skipSpace() {
+    while (p_ != end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\r' || *p_ == '\n')) {
+        ++p_;
+    }
+}
+
+bool JsonLineParser::consume(char c) {
+    if (p_ != end_ && *p_ == c) {
+        ++p_;
+        return true;
+    }
+    return false;
+}
+
+bool JsonLineParser::consumeLiteral(const char* literal) {
+    size_t len = std::strlen(literal);
+    if (static_cast<size_t>(end_ - p_) >= len && std::memcmp(p_, literal, len) == 0) {
+        p_ += len;
+        return true;
+    }
+    return false;
+}
+
+int JsonLineParser::parseHex4(uint32_t* value) {
+    if (end_ - p_ < 4) {
+        return fail("truncated \\u escape");
+    }
+    *value = 0;
+    for (int i = 0; i < 4; ++i) {
+        char c = *p_++;
+        *value <<= 4;
+        if (c >= '0' && c <= '9') {
+            *value |= c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            *value |= c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            *value |= c - 'A' + 10;
+        } else {
+            return fail("invalid \\u escape");
+        }
+    }
+    return 0;
+}
+
+int JsonLineParser::parseString(std::string* out) {
+    if (!consume('"')) {
+        return fail("expected string");
+    }
+    out->clear();
+    while (p_ != end_) {
+        const char* start = p_;
+        while (p_ != end_ && *p_ != '"' && *p_ != '\\') {
+            ++p_;
+        }
+        out->append(start, p_);
+        if (p_ == end_) {
+            break;
+        }
+        if (*p_++ == '"') {
+            return 0;
+        }
+        if (p_ == end_) {
+            break;
+        }
+        char c = *p_++;
+        switch (c) {
+            case '"':
+            case '\\':
+            case '/':
+                out->push_back(c);
+                break;
+            case 'b':
+                out->push_back('\b');
+                break;
+            case 'f':
+                out->push_back('\f');
+                break;
+            case 'n':
+                out->push_back('\n');
+                break;
+            case 'r':
+                out->push_back('\r');
+                break;
+            case 't':
+                out->push_back('\t');
+                break;
+            case 'u': {
+                uint32_t codePoint;
+                if (parseHex4(&codePoint) != 0) {
+                    return -1;
+                }
+                if (codePoint >= 0xD800 && codePoint < 0xDC00) {
+                    uint32_t low;
+                    if (!consumeLiteral("\\u") || parseHex4(&low) != 0 || low < 0xDC00 || low >= 0xE000) {
+                        return fail("invalid surrogate pair");
+                    }
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                } else if (codePoint >= 0xDC00 && codePoint < 0xE000) {
+                    return fail("invalid surrogate pair");
+                }
+                appendUtf8(codePoint, out);
+                break;
+            }
+            default:
+                return fail(std::string("invalid escape \\") + c);
+        }
+    }
+    return fail("unterminated string");
+}
+
+int JsonLineParser::scanNumber(std::string* token, bool* isInteger) {
+    const char* start = p_;
+    *isInteger = true;
+    while (p_ != end_ && (std::isdigit(static_cast<unsigned char>(*p_)) || *p_ == '-' || *p_ == '+' ||
+                             *p_ == '.' || *p_ == 'e' || *p_ == 'E')) {
+        if (!std::isdigit(static_cast<unsigned char>(*p_))) {
+            *isInteger = false;
+        }
+        ++p_;
+    }
+    if (p_ == start) {
+        return fail("invalid value");
+    }
+    token->assign(start, p_);
+    return 0;
+}
+
+int JsonLineParser::parseId(std::string* id) {
+    if (p_ != end_ && *p_ == '"') {
+        return parseString(id);
+    }
+    bool isInteger;
+    if (scanNumber(id, &isInteger) != 0 || !isInteger) {
+        return fail("id must be a string or a non-negative integer");
+    }
+    return 0;
+}
+
+int JsonLineParser::parseValue(olama::Field* field, bool* isNull) {
+    if (p_ == end_) {
+        return fail("expected value");
+    }
+    switch (*p_) {
+        case '"':
+            return parseString(field->mutable_val_str());
+        case '[':
+            return parseStringArray(field->mutable_val_str_arr()->mutable_str_arr());
+        case '{':
+            return fail("nested objects are not supported");
+        case 't':
+        case 'f':
+            if (consumeLiteral("true")) {
+                field->set_val_u64(1);
+                return 0;
+            }
+            if (consumeLiteral("false")) {
+                field->set_val_u64(0);
+                return 0;
+            }
+            return fail("invalid value");
+        case 'n':
+            if (consumeLiteral("null")) {
+                *isNull = true;
+                return 0;
+            }
+            return fail("invalid value");
+        default:
+            break;
+    }
+    std::string token;
+    bool isInteger;
+    if (scanNumber(&token, &isInteger) != 0) {
+        return -1;
+    }
+    char* parsedEnd = nullptr;
+    errno = 0;
+    if (isInteger) {
+        uint64_t value = std::strtoull(token.c_str(), &parsedEnd, 10);
+        if (errno == 0 && *parsedEnd == '\0') {
+            field->set_val_u64(value);
+            return 0;
+        }
+        errno = 0;
+    }
+    double value = std::strtod(token.c_str(), &parsedEnd);
+    if (errno != 0 || *parsedEnd != '\0') {
+        return fail("invalid number " + token);
+    }
+    field->set_val_double(value);
+    return 0;
+}
+
+int JsonLineParser::parseStringArray(google::protobuf::RepeatedPtrField<std::string>* out) {
+    consume('[');
+    skipSpace();
+    if (consume(']')) {
+        return 0;
+    }
+    while (true) {
+        skipSpace();
+        if (parseString(out->Add()) != 0) {
+            return fail("only arrays of strings are supported");
+        }
+        skipSpace();
+        if (consume(']')) {
+            return 0;
+        }
+        if (!consume(',')) {
+            return fail("expected ',' or ']'");
+        }
+    }
+}
+
+}  // namespace vectordb
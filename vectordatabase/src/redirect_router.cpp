@@ -0,0 +1,116 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <mutex>
+
+#include "include/redirect_router.h"
+
+namespace vectordb {
+
+RedirectRouter::RedirectRouter(const std::string& url, const std::string& username, const std::string& key,
+    int channelNum, int reconnectBackoff, ChannelSelectPolicy policy)
+    : defaultTarget_(normalize(url)), username_(username), key_(key), channelNum_(channelNum),
+      reconnectBackoff_(reconnectBackoff), policy_(policy) {}
+
+std::string RedirectRouter::normalize(const std::string& target) {
+    std::string result = target;
+    if (result.find("http://") == 0) {
+        result = result.substr(7);
+    }
+    while (!result.empty() && result.back() == '/') {
+        result.pop_back();
+    }
+    return result;
+}
+
+std::shared_ptr<ChannelPool> RedirectRouter::route(const std::string& collectionKey) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto routeIter = routes_.find(collectionKey);
+    if (routeIter == routes_.end()) {
+        return nullptr;
+    }
+    auto poolIter = pools_.find(routeIter->second);
+    if (poolIter == pools_.end()) {
+        return nullptr;
+    }
+    return poolIter->second;
+}
+
+void RedirectRouter::learn(const std::string& collectionKey, const std::string& redirect) {
+    std::string target = normalize(redirect);
+    if (target.empty()) {
+        return;
+    }
+    if (target == defaultTarget_) {
+        invalidate(collectionKey);
+        return;
+    }
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto iter = routes_.find(collectionKey);
+        if (iter != routes_.end() && iter->second == target) {
+            return;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (pools_.find(target) == pools_.end()) {
+        pools_[target] = std::make_shared<ChannelPool>(target, username_, key_, channelNum_,
+            reconnectBackoff_, policy_);
+    }
+    routes_[collectionKey] = target;
+}
+
+void RedirectRouter::invalidate(const std::string& collectionKey) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto iter = routes_.find(collectionKey);
+    if (iter == routes_.end()) {
+        return;
+    }
+    std::string target = iter->second;
+    routes_.erase(iter);
+    for (const auto& [key, value] : routes_) {
+        if (value == target) {
+            return;
+        }
+    }
+    // 没有集合再路由到该节点时释放连接池, 进行中的请求仍持有连接池的引用
+    pools_.erase(target);
+}
+
+void RedirectRouter::clear() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    routes_.clear();
+    pools_.clear();
+}
+
+std::map<std::string, std::string> RedirectRouter::routes() {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return std::map<std::string, std::string>(routes_.begin(), routes_.end());
+}
+
+}  // namespace vectordb
@@ -0,0 +1,248 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VECTORDB_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define VECTORDB_NEON 1
+#endif
+
+#include "include/rerank.h"
+#include "include/types/consts.h"
+
+namespace vectordb {
+
+namespace {
+
+using DistanceFunction = float (*)(const float*, const float*, size_t);
+
+float l2Scalar(const float* a, const float* b, size_t dim) {
+    float sum = 0;
+    for (size_t i = 0; i < dim; ++i) {
+        float d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+float ipScalar(const float* a, const float* b, size_t dim) {
+    float sum = 0;
+    for (size_t i = 0; i < dim; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+#ifdef VECTORDB_X86
+
+__attribute__((target("avx2,fma"))) float horizontalSum(__m256 v) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+}
+
+__attribute__((target("avx2,fma"))) float l2Avx2(const float* a, const float* b, size_t dim) {
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= dim; i += 16) {
+        __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+        sum0 = _mm256_fmadd_ps(d0, d0, sum0);
+        sum1 = _mm256_fmadd_ps(d1, d1, sum1);
+    }
+    for (; i + 8 <= dim; i += 8) {
+        __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        sum0 = _mm256_fmadd_ps(d, d, sum0);
+    }
+    return horizontalSum(_mm256_add_ps(sum0, sum1)) + l2Scalar(a + i, b + i, dim - i);
+}
+
+__attribute__((target("avx2,fma"))) float ipAvx2(const float* a, const float* b, size_t dim) {
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= dim; i += 16) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+        sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), sum1);
+    }
+    for (; i + 8 <= dim; i += 8) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+    }
+    return horizontalSum(_mm256_add_ps(sum0, sum1)) + ipScalar(a + i, b + i, dim - i);
+}
+
+// 尾部不足16个元素时使用掩码加载, 无需标量收尾
+__attribute__((target("avx512f"))) float l2Avx512(const float* a, const float* b, size_t dim) {
+    __m512 sum = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= dim; i += 16) {
+        __m512 d = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        sum = _mm512_fmadd_ps(d, d, sum);
+    }
+    if (i < dim) {
+        __mmask16 mask = static_cast<__mmask16>((1u << (dim - i)) - 1);
+        __m512 d = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i));
+        sum = _mm512_fmadd_ps(d, d, sum);
+    }
+    return _mm512_reduce_add_ps(sum);
+}
+
+__attribute__((target("avx512f"))) float ipAvx512(const float* a, const float* b, size_t dim) {
+    __m512 sum = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= dim; i += 16) {
+        sum = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), sum);
+    }
+    if (i < dim) {
+        __mmask16 mask = static_cast<__mmask16>((1u << (dim - i)) - 1);
+        sum = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i), sum);
+    }
+    return _mm512_reduce_add_ps(sum);
+}
+
+#endif  // VECTORDB_X86
+
+#ifdef VECTORDB_NEON
+
+float l2Neon(const float* a, const float* b, size_t dim) {
+    float32x4_t sum0 = vdupq_n_f32(0);
+    float32x4_t sum1 = vdupq_n_f32(0);
+    size_t i = 0;
+    for (; i + 8 <= dim; i += 8) {
+        float32x4_t d0 = vsubq_f32(vld1q_f32(a + i), vld1q_f32(b + i));
+        float32x4_t d1 = vsubq_f32(vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+        sum0 = vfmaq_f32(sum0, d0, d0);
+        sum1 = vfmaq_f32(sum1, d1, d1);
+    }
+    return vaddvq_f32(vaddq_f32(sum0, sum1)) + l2Scalar(a + i, b + i, dim - i);
+}
+
+float ipNeon(const float* a, const float* b, size_t dim) {
+    float32x4_t sum0 = vdupq_n_f32(0);
+    float32x4_t sum1 = vdupq_n_f32(0);
+    size_t i = 0;
+    for (; i + 8 <= dim; i += 8) {
+        sum0 = vfmaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+        sum1 = vfmaq_f32(sum1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    return vaddvq_f32(vaddq_f32(sum0, sum1)) + ipScalar(a + i, b + i, dim - i);
+}
+
+#endif  // VECTORDB_NEON
+
+struct DistanceKernels {
+    DistanceFunction l2 = l2Scalar;
+    DistanceFunction ip = ipScalar;
+    const char* name = "scalar";
+};
+
+DistanceKernels selectKernels() {
+    DistanceKernels kernels;
+#if defined(VECTORDB_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        kernels = {l2Avx512, ipAvx512, "avx512"};
+    } else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        kernels = {l2Avx2, ipAvx2, "avx2"};
+    }
+#elif defined(VECTORDB_NEON)
+    kernels = {l2Neon, ipNeon, "neon"};
+#endif
+    return kernels;
+}
+
+const DistanceKernels& kernels() {
+    static const DistanceKernels selected = selectKernels();
+    return selected;
+}
+
+}  // namespace
+
+float l2Squared(const float* a, const float* b, size_t dim) {
+    return kernels().l2(a, b, dim);
+}
+
+float innerProduct(const float* a, const float* b, size_t dim) {
+    return kernels().ip(a, b, dim);
+}
+
+const char* distanceKernelName() {
+    return kernels().name;
+}
+
+bool rerankMetricSupported(const std::string& metricType) {
+    return metricType == L2 || metricType == IP || metricType == COSINE;
+}
+
+int rerankDocuments(const float* query, size_t dim, const std::string& metricType, size_t limit,
+    std::vector<Document>* documents) {
+    if (!rerankMetricSupported(metricType)) {
+        return -1;
+    }
+    const DistanceKernels& k = kernels();
+    bool ascending = metricType == L2;
+    float queryNorm = 0;
+    if (metricType == COSINE) {
+        queryNorm = std::sqrt(k.ip(query, query, dim));
+    }
+    // 有向量的文档重新计算score, 排在前面
+    auto scored = std::stable_partition(documents->begin(), documents->end(),
+        [dim](const Document& document) { return document.vector.size() == dim; });
+    for (auto it = documents->begin(); it != scored; ++it) {
+        const float* vector = it->vector.data();
+        if (ascending) {
+            it->score = k.l2(query, vector, dim);
+        } else if (metricType == IP) {
+            it->score = k.ip(query, vector, dim);
+        } else {
+            float norm = std::sqrt(k.ip(vector, vector, dim)) * queryNorm;
+            it->score = norm > 0 ? k.ip(query, vector, dim) / norm : 0;
+        }
+    }
+    if (ascending) {
+        std::stable_sort(documents->begin(), scored,
+            [](const Document& a, const Document& b) { return a.score < b.score; });
+    } else {
+        std::stable_sort(documents->begin(), scored,
+            [](const Document& a, const Document& b) { return a.score > b.score; });
+    }
+    if (documents->size() > limit) {
+        documents->erase(documents->begin() + limit, documents->end());
+    }
+    return 0;
+}
+
+}  // namespace vectordb
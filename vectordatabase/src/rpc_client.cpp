@@ -26,49 +26,15 @@
   *THE POSSIBILITY OF SUCH DAMAGE.
 */
 
-#include <iostream>
-
-#include <grpcpp/create_channel.h>
-#include <grpcpp/impl/codegen/client_interceptor.h>
-#include <grpcpp/impl/codegen/time.h>
+#include <mutex>
+#include <thread>
 
 #include "include/rpc_client.h"
+#include "include/async_call.h"
+#include "include/channel_pool.h"
 
 namespace vectordb {
 
-class AuthInterceptor : public grpc::experimental::Interceptor {
-  public:
-    AuthInterceptor(const std::string& username, const std::string& api_key)
-        : auth_token_("Bearer account=" + username + "&api_key=" + api_key) {}
-
-    void Intercept(grpc::experimental::InterceptorBatchMethods* methods) override {
-        if (methods->QueryInterceptionHookPoint(
-                grpc::experimental::InterceptionHookPoints::PRE_SEND_INITIAL_METADATA)) {
-            auto* metadata = methods->GetSendInitialMetadata();
-            metadata->insert({"authorization", auth_token_});
-        }
-        methods->Proceed();
-    }
-
-  private:
-    std::string auth_token_;
-};
-
-class AuthInterceptorFactory : public grpc::experimental::ClientInterceptorFactoryInterface {
-  public:
-    AuthInterceptorFactory(const std::string& username, const std::string& api_key)
-        : username_(username), api_key_(api_key) {}
-
-    grpc::experimental::Interceptor* CreateClientInterceptor(
-        grpc::experimental::ClientRpcInfo* info) override {
-        return new AuthInterceptor(username_, api_key_);
-    }
-
-  private:
-    std::string username_;
-    std::string api_key_;
-};
-
 RpcClient::RpcClient(const std::string& url, const std::string& username, const std::string& key,
     const ClientOption* option) {
     if (option == nullptr) {
@@ -77,45 +43,46 @@ RpcClient::RpcClient(const std::string& url, const std::string& username, const
         option_ = *option;
     }
 
-    std::string rpcTarget;
-    if (url.find("http://") == 0) {
-        rpcTarget = url.substr(7);
-    } else {
-        rpcTarget = url;
-    }
-
     url_ = url;
     username_ = username;
     key_ = key;
     debug_ = false;
 
-    std::vector<std::unique_ptr<grpc::experimental::ClientInterceptorFactoryInterface>> interceptors;
-    interceptors.push_back(std::make_unique<AuthInterceptorFactory>(username_, key_));
-    grpc::ChannelArguments channelArgs;
-    channelArgs.SetMaxReceiveMessageSize(16 * 1024 * 1024);
-    channelArgs.SetMaxSendMessageSize(16 * 1024 * 1024);
-    channelArgs.SetInt(GRPC_ARG_INITIAL_RECONNECT_BACKOFF_MS, option_.timeout);
-
-    grpcChannel_ = grpc::experimental::CreateCustomChannelWithInterceptors(
-        rpcTarget,
-        grpc::InsecureChannelCredentials(),
-        channelArgs,
-        {std::move(interceptors)});
-
-    if (!grpcChannel_) {
-        throw std::runtime_error("Failed to create gRPC channel");
-    }
-
-    const gpr_timespec deadline = gpr_time_add(
-        gpr_now(GPR_CLOCK_REALTIME),
-        gpr_time_from_seconds(option_.timeout / 1000, GPR_TIMESPAN));
-    
-    grpc_connectivity_state state = grpcChannel_->GetState(true);
-    if (!grpcChannel_->WaitForConnected(deadline)) {
+    if (option_.channelPool) {
+        channelPool_ = option_.channelPool;
+    } else {
+        channelPool_ = std::make_shared<ChannelPool>(url_, username_, key_, option_.channelNum,
+            option_.timeout, option_.channelSelectPolicy);
+    }
+
+    if (!option_.lazyConnect && !channelPool_->waitForConnected(option_.timeout)) {
         throw std::runtime_error("Failed to establish connection within timeout");
     }
 
-    stub_ = olama::SearchEngine::NewStub(grpcChannel_);
+    cqPool_ = std::make_unique<CompletionQueuePool>(option_.asyncThreadNum);
+    limiters_ = std::make_unique<ConcurrencyLimiterGroup>(option_.concurrencyLimit);
+    if (option_.redirectRouting) {
+        router_ = std::make_unique<RedirectRouter>(url_, username_, key_, option_.channelNum,
+            option_.timeout, option_.channelSelectPolicy);
+    }
+    if (option_.searchCache.enabled) {
+        searchCache_ = std::make_unique<SearchResultCache>(option_.searchCache);
+    }
+    if (option_.semanticCache.enabled) {
+        semanticCache_ = std::make_unique<SemanticSearchCache>(option_.semanticCache);
+    }
+    if (option_.searchBatching.enabled) {
+        // 合并后的请求不写入缓存, 由submitBatchedSearch按单个向量缓存
+        searchBatcher_ = std::make_unique<SearchBatcher>(option_.searchBatching,
+            [this](const olama::SearchRequest& request, int timeout, SearchDocumentResult* result,
+                AsyncCallback done) { sendSearchAsync(request, result, std::move(done), timeout); });
+    }
+}
+
+RpcClient::~RpcClient() {
+    // 先发送等待合并的检索, 再等待未完成的异步调用回调执行完毕, 回调中可能访问客户端的其他成员
+    searchBatcher_.reset();
+    cqPool_.reset();
 }
 
 void RpcClient::setTimeout(int timeout) {
@@ -123,7 +90,134 @@ void RpcClient::setTimeout(int timeout) {
 }
 
 void RpcClient::closeConnection() {
-    grpcChannel_.reset();
+    channelPool_.reset();
+    if (router_) {
+        router_->clear();
+    }
+}
+
+std::future<bool> RpcClient::warmup(int timeout) {
+    std::shared_ptr<ChannelPool> pool = channelPool_;
+    if (!pool) {
+        std::promise<bool> promise;
+        promise.set_value(false);
+        return promise.get_future();
+    }
+    // std::async返回的future析构时会等待任务结束, 调用方不等待结果时会被阻塞, 因此使用分离的线程
+    auto promise = std::make_shared<std::promise<bool>>();
+    std::future<bool> future = promise->get_future();
+    std::thread([pool, promise, timeout]() {
+        promise->set_value(pool->waitForConnected(timeout));
+    }).detach();
+    return future;
+}
+
+std::future<int> RpcClient::warmup(const std::vector<std::pair<std::string, std::string>>& collections,
+    WarmupResult* result, int timeout) {
+    struct WarmupState {
+        std::mutex mutex;
+        size_t remaining;
+        std::vector<DescribeCollectionResult> results;
+        std::promise<int> promise;
+    };
+    result->failedCollections.clear();
+    result->message.clear();
+    auto state = std::make_shared<WarmupState>();
+    state->remaining = collections.size();
+    state->results.resize(collections.size());
+    std::future<int> future = state->promise.get_future();
+
+    if (channelPool_) {
+        channelPool_->connect();
+    }
+    if (collections.empty()) {
+        result->success = true;
+        state->promise.set_value(0);
+        return future;
+    }
+    for (size_t i = 0; i < collections.size(); ++i) {
+        std::string name = collections[i].first + "/" + collections[i].second;
+        describeCollectionAsync(collections[i].first, collections[i].second, &state->results[i],
+            [state, result, name](int ret) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (ret != 0) {
+                    result->failedCollections.push_back(name);
+                }
+                if (--state->remaining > 0) {
+                    return;
+                }
+                result->success = result->failedCollections.empty();
+                if (!result->success) {
+                    result->message = "Fail to warm up " + std::to_string(result->failedCollections.size()) +
+                        " collection(s)";
+                }
+                state->promise.set_value(result->success ? 0 : -1);
+            }, timeout);
+    }
+    return future;
+}
+
+std::map<std::string, ConcurrencyLimiterStats> RpcClient::getConcurrencyLimiterStats() {
+    return limiters_->stats();
+}
+
+std::map<std::string, std::string> RpcClient::getRedirectRoutes() {
+    if (!router_) {
+        return {};
+    }
+    return router_->routes();
+}
+
+SearchBatchStats RpcClient::getSearchBatchStats() {
+    if (!searchBatcher_) {
+        return {};
+    }
+    return searchBatcher_->stats();
+}
+
+SearchCacheStats RpcClient::getSearchCacheStats() {
+    if (!searchCache_) {
+        return {};
+    }
+    return searchCache_->stats();
+}
+
+SemanticCacheStats RpcClient::getSemanticCacheStats() {
+    if (!semanticCache_) {
+        return {};
+    }
+    return semanticCache_->stats();
+}
+
+void RpcClient::clearSearchCache() {
+    if (searchCache_) {
+        searchCache_->clear();
+    }
+    if (semanticCache_) {
+        semanticCache_->clear();
+    }
+}
+
+std::shared_ptr<ChannelPool> RpcClient::selectPool(const std::string& key, bool* routed) {
+    if (router_) {
+        std::shared_ptr<ChannelPool> pool = router_->route(key);
+        if (pool) {
+            *routed = true;
+            return pool;
+        }
+    }
+    *routed = false;
+    return channelPool_;
+}
+
+void RpcClient::updateRoute(const std::string& key, bool routed, bool failed, const std::string& redirect) {
+    // 路由到的节点不再可用或不再负责该集合, 回退到默认地址; 出错的响应仍可能携带新的redirect
+    if (failed && routed) {
+        router_->invalidate(key);
+    }
+    if (!redirect.empty()) {
+        router_->learn(key, redirect);
+    }
 }
 
 }  // namespace vectordb
@@ -27,64 +27,62 @@
 */
 
 #include "include/rpc_client.h"
+#include "include/rpc_invoke.h"
+#include "include/scoped_arena.h"
 #include "include/helper.h"
 #include "include/types/collection.h"
 
 namespace vectordb {
 
-int RpcClient::createCollection(const std::string& dbName, const std::string& collectionName,
+namespace {
+
+void fillCreateCollectionRequest(const std::string& dbName, const std::string& collectionName,
     uint32_t shardNum, uint32_t replicaNum, const std::string& description, const Indexes& indexes,
-    const CreateCollectionParams* params, CreateCollectionResult* result, int timeout) {
-    olama::CreateCollectionRequest request;
-    request.set_database(dbName);
-    request.set_collection(collectionName);
-    request.set_shardnum(shardNum);
-    request.set_replicanum(replicaNum);
-    request.set_description(description);
+    const CreateCollectionParams* params, olama::CreateCollectionRequest* request) {
+    request->set_database(dbName);
+    request->set_collection(collectionName);
+    request->set_shardnum(shardNum);
+    request->set_replicanum(replicaNum);
+    request->set_description(description);
 
     for (const auto& v : indexes.vectorIndex) {
-        olama::IndexColumn column;
+        olama::IndexColumn& column = (*request->mutable_indexes())[v.fieldName];
         column.set_fieldname(v.fieldName);
         column.set_fieldtype(v.fieldType);
         column.set_indextype(v.indexType);
         column.set_dimension(v.dimension);
         column.set_metrictype(v.metricType);
 
-        column.set_allocated_params(new olama::IndexParams());
         column.mutable_params()->set_m(v.params.m);
         column.mutable_params()->set_efconstruction(v.params.efConstruction);
         column.mutable_params()->set_nlist(v.params.nList);
         column.mutable_params()->set_nprobe(v.params.nProbe);
-        (*request.mutable_indexes())[v.fieldName] = column;
     }
 
     for (const auto& v : indexes.filterIndex) {
-        olama::IndexColumn column;
+        olama::IndexColumn& column = (*request->mutable_indexes())[v.fieldName];
+        // 与向量索引同名时覆盖之前的配置
+        column.Clear();
         column.set_fieldname(v.fieldName);
         column.set_fieldtype(v.fieldType);
         column.set_indextype(v.indexType);
         if (v.fieldType == kArray) {
             column.set_fieldelementtype(kString);
         }
-        (*request.mutable_indexes())[v.fieldName] = column;
     }
 
     if (params != nullptr) {
         if (params->embedding != nullptr) {
-            olama::EmbeddingParams* embeddingParams = new olama::EmbeddingParams();
+            olama::EmbeddingParams* embeddingParams = request->mutable_embeddingparams();
             embeddingParams->set_field(params->embedding->field);
             embeddingParams->set_vector_field(params->embedding->vectorField);
             embeddingParams->set_model_name(params->embedding->model);
-            request.set_allocated_embeddingparams(embeddingParams);
         }
     }
+}
 
-    grpc::ClientContext context;
-    std::chrono::system_clock::time_point deadline = std::chrono::system_clock::now() +
-        std::chrono::milliseconds(timeout);
-    context.set_deadline(deadline);
-    olama::CreateCollectionResponse response;
-    grpc::Status status = stub_->createCollection(&context, request, &response);
+int parseCreateCollectionResponse(const grpc::Status& status, const olama::CreateCollectionResponse& response,
+    const olama::CreateCollectionRequest& request, const Indexes& indexes, CreateCollectionResult* result) {
     if (!status.ok()) {
         result->success = false;
         result->message = "Fail to create collection: " + status.error_message();
@@ -96,11 +94,11 @@ int RpcClient::createCollection(const std::string& dbName, const std::string& co
         return -1;
     }
     auto collection = std::make_unique<Collection>();
-    collection->database = dbName;
-    collection->collectionName = collectionName;
-    collection->shardNum = shardNum;
-    collection->replicaNum = replicaNum;
-    collection->description = description;
+    collection->database = request.database();
+    collection->collectionName = request.collection();
+    collection->shardNum = request.shardnum();
+    collection->replicaNum = request.replicanum();
+    collection->description = request.description();
     collection->indexes = indexes;
     result->success = true;
     result->message = response.msg();
@@ -108,16 +106,8 @@ int RpcClient::createCollection(const std::string& dbName, const std::string& co
     return 0;
 }
 
-int RpcClient::listCollections(const std::string& dbName, ListCollectionResult* result, int timeout) {
-    olama::ListCollectionsRequest request;
-    request.set_database(dbName);
-
-    grpc::ClientContext context;
-    std::chrono::system_clock::time_point deadline = std::chrono::system_clock::now() +
-        std::chrono::milliseconds(timeout);
-    context.set_deadline(deadline);
-    olama::ListCollectionsResponse response;
-    grpc::Status status = stub_->listCollections(&context, request, &response);
+int parseListCollectionsResponse(const grpc::Status& status, const olama::ListCollectionsResponse& response,
+    ListCollectionResult* result) {
     if (!status.ok()) {
         result->success = false;
         result->message = "Fail to list collections: " + status.error_message();
@@ -140,17 +130,8 @@ int RpcClient::listCollections(const std::string& dbName, ListCollectionResult*
     return 0;
 }
 
-int RpcClient::describeCollection(const std::string& dbName, const std::string& collectionName,
-        DescribeCollectionResult* result, int timeout) {
-    olama::DescribeCollectionRequest request;
-    request.set_database(dbName);
-    request.set_collection(collectionName);
-    grpc::ClientContext context;
-    std::chrono::system_clock::time_point deadline = std::chrono::system_clock::now() +
-        std::chrono::milliseconds(timeout);
-    context.set_deadline(deadline);
-    olama::DescribeCollectionResponse response;
-    grpc::Status status = stub_->describeCollection(&context, request, &response);
+int parseDescribeCollectionResponse(const grpc::Status& status, const olama::DescribeCollectionResponse& response,
+    DescribeCollectionResult* result) {
     if (!status.ok()) {
         result->success = false;
         result->message = "Fail to describe collection: " + status.error_message();
@@ -174,17 +155,8 @@ int RpcClient::describeCollection(const std::string& dbName, const std::string&
     return 0;
 }
 
-int RpcClient::truncateCollection(const std::string& dbName, const std::string& collectionName,
-        TruncateCollectionResult* result, int timeout) {
-    olama::TruncateCollectionRequest request;
-    request.set_database(dbName);
-    request.set_collection(collectionName);
-    grpc::ClientContext context;
-    std::chrono::system_clock::time_point deadline = std::chrono::system_clock::now() +
-        std::chrono::milliseconds(timeout);
-    context.set_deadline(deadline);
-    olama::TruncateCollectionResponse response;
-    grpc::Status status = stub_->truncateCollection(&context, request, &response);
+int parseTruncateCollectionResponse(const grpc::Status& status, const olama::TruncateCollectionResponse& response,
+    TruncateCollectionResult* result) {
     if (!status.ok()) {
         result->success = false;
         result->message = "Fail to truncate collection: " + status.error_message();
@@ -201,18 +173,8 @@ int RpcClient::truncateCollection(const std::string& dbName, const std::string&
     return 0;
 }
 
-int RpcClient::dropCollection(const std::string& dbName, const std::string& collectionName,
-        DropCollectionResult* result, int timeout) {
-    olama::DropCollectionRequest request;
-    request.set_database(dbName);
-    request.set_collection(collectionName);
-
-    grpc::ClientContext context;
-    std::chrono::system_clock::time_point deadline = std::chrono::system_clock::now() +
-        std::chrono::milliseconds(timeout);
-    context.set_deadline(deadline);
-    olama::DropCollectionResponse response;
-    grpc::Status status = stub_->dropCollection(&context, request, &response);
+int parseDropCollectionResponse(const grpc::Status& status, const olama::DropCollectionResponse& response,
+    DropCollectionResult* result) {
     if (!status.ok()) {
         result->success = false;
         result->message = "Fail to drop collection: " + status.error_message();
@@ -229,4 +191,172 @@ int RpcClient::dropCollection(const std::string& dbName, const std::string& coll
     return 0;
 }
 
+}  // namespace
+
+int RpcClient::createCollection(const std::string& dbName, const std::string& collectionName,
+    uint32_t shardNum, uint32_t replicaNum, const std::string& description, const Indexes& indexes,
+    const CreateCollectionParams* params, CreateCollectionResult* result, int timeout) {
+    ScopedArena arena;
+    olama::CreateCollectionRequest& request = arena.create<olama::CreateCollectionRequest>();
+    fillCreateCollectionRequest(dbName, collectionName, shardNum, replicaNum, description, indexes, params, &request);
+    olama::CreateCollectionResponse& response = arena.create<olama::CreateCollectionResponse>();
+    grpc::Status status = invoke(&olama::SearchEngine::Stub::createCollection, request, &response, timeout);
+    return parseCreateCollectionResponse(status, response, request, indexes, result);
+}
+
+int RpcClient::listCollections(const std::string& dbName, ListCollectionResult* result, int timeout) {
+    ScopedArena arena;
+    olama::ListCollectionsRequest& request = arena.create<olama::ListCollectionsRequest>();
+    request.set_database(dbName);
+
+    olama::ListCollectionsResponse& response = arena.create<olama::ListCollectionsResponse>();
+    grpc::Status status = invoke(&olama::SearchEngine::Stub::listCollections, request, &response, timeout);
+    return parseListCollectionsResponse(status, response, result);
+}
+
+int RpcClient::describeCollection(const std::string& dbName, const std::string& collectionName,
+        DescribeCollectionResult* result, int timeout) {
+    ScopedArena arena;
+    olama::DescribeCollectionRequest& request = arena.create<olama::DescribeCollectionRequest>();
+    request.set_database(dbName);
+    request.set_collection(collectionName);
+    olama::DescribeCollectionResponse& response = arena.create<olama::DescribeCollectionResponse>();
+    grpc::Status status = invoke(&olama::SearchEngine::Stub::describeCollection, request, &response, timeout);
+    return parseDescribeCollectionResponse(status, response, result);
+}
+
+int RpcClient::truncateCollection(const std::string& dbName, const std::string& collectionName,
+        TruncateCollectionResult* result, int timeout) {
+    ScopedArena arena;
+    olama::TruncateCollectionRequest& request = arena.create<olama::TruncateCollectionRequest>();
+    request.set_database(dbName);
+    request.set_collection(collectionName);
+    olama::TruncateCollectionResponse& response = arena.create<olama::TruncateCollectionResponse>();
+    invalidateSearchCache(dbName, collectionName);
+    grpc::Status status = invoke(&olama::SearchEngine::Stub::truncateCollection, request, &response, timeout);
+    invalidateSearchCache(dbName, collectionName);
+    return parseTruncateCollectionResponse(status, response, result);
+}
+
+int RpcClient::dropCollection(const std::string& dbName, const std::string& collectionName,
+        DropCollectionResult* result, int timeout) {
+    ScopedArena arena;
+    olama::DropCollectionRequest& request = arena.create<olama::DropCollectionRequest>();
+    request.set_database(dbName);
+    request.set_collection(collectionName);
+
+    olama::DropCollectionResponse& response = arena.create<olama::DropCollectionResponse>();
+    invalidateSearchCache(dbName, collectionName);
+    grpc::Status status = invoke(&olama::SearchEngine::Stub::dropCollection, request, &response, timeout);
+    invalidateSearchCache(dbName, collectionName);
+    return parseDropCollectionResponse(status, response, result);
+}
+
+void RpcClient::createCollectionAsync(const std::string& dbName, const std::string& collectionName,
+    uint32_t shardNum, uint32_t replicaNum, const std::string& description, const Indexes& indexes,
+    const CreateCollectionParams* params, CreateCollectionResult* result, AsyncCallback callback, int timeout) {
+    auto request = std::make_shared<olama::CreateCollectionRequest>();
+    fillCreateCollectionRequest(dbName, collectionName, shardNum, replicaNum, description, indexes, params,
+        request.get());
+    invokeAsync<olama::CreateCollectionRequest, olama::CreateCollectionResponse>(
+        &olama::SearchEngine::Stub::PrepareAsynccreateCollection, *request, timeout,
+        [request, indexes, result, callback](const grpc::Status& status, olama::CreateCollectionResponse& response) {
+            callback(parseCreateCollectionResponse(status, response, *request, indexes, result));
+        });
+}
+
+std::future<int> RpcClient::createCollectionAsync(const std::string& dbName, const std::string& collectionName,
+    uint32_t shardNum, uint32_t replicaNum, const std::string& description, const Indexes& indexes,
+    const CreateCollectionParams* params, CreateCollectionResult* result, int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        createCollectionAsync(dbName, collectionName, shardNum, replicaNum, description, indexes, params, result,
+            std::move(callback), timeout);
+    });
+}
+
+void RpcClient::listCollectionsAsync(const std::string& dbName, ListCollectionResult* result,
+    AsyncCallback callback, int timeout) {
+    ScopedArena arena;
+    olama::ListCollectionsRequest& request = arena.create<olama::ListCollectionsRequest>();
+    request.set_database(dbName);
+    invokeAsync<olama::ListCollectionsRequest, olama::ListCollectionsResponse>(
+        &olama::SearchEngine::Stub::PrepareAsynclistCollections, request, timeout,
+        [result, callback](const grpc::Status& status, olama::ListCollectionsResponse& response) {
+            callback(parseListCollectionsResponse(status, response, result));
+        });
+}
+
+std::future<int> RpcClient::listCollectionsAsync(const std::string& dbName, ListCollectionResult* result,
+    int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        listCollectionsAsync(dbName, result, std::move(callback), timeout);
+    });
+}
+
+void RpcClient::describeCollectionAsync(const std::string& dbName, const std::string& collectionName,
+    DescribeCollectionResult* result, AsyncCallback callback, int timeout) {
+    ScopedArena arena;
+    olama::DescribeCollectionRequest& request = arena.create<olama::DescribeCollectionRequest>();
+    request.set_database(dbName);
+    request.set_collection(collectionName);
+    invokeAsync<olama::DescribeCollectionRequest, olama::DescribeCollectionResponse>(
+        &olama::SearchEngine::Stub::PrepareAsyncdescribeCollection, request, timeout,
+        [result, callback](const grpc::Status& status, olama::DescribeCollectionResponse& response) {
+            callback(parseDescribeCollectionResponse(status, response, result));
+        });
+}
+
+std::future<int> RpcClient::describeCollectionAsync(const std::string& dbName, const std::string& collectionName,
+    DescribeCollectionResult* result, int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        describeCollectionAsync(dbName, collectionName, result, std::move(callback), timeout);
+    });
+}
+
+void RpcClient::truncateCollectionAsync(const std::string& dbName, const std::string& collectionName,
+    TruncateCollectionResult* result, AsyncCallback callback, int timeout) {
+    ScopedArena arena;
+    olama::TruncateCollectionRequest& request = arena.create<olama::TruncateCollectionRequest>();
+    request.set_database(dbName);
+    request.set_collection(collectionName);
+    invalidateSearchCache(dbName, collectionName);
+    invokeAsync<olama::TruncateCollectionRequest, olama::TruncateCollectionResponse>(
+        &olama::SearchEngine::Stub::PrepareAsynctruncateCollection, request, timeout,
+        [this, dbName, collectionName, result, callback](const grpc::Status& status,
+            olama::TruncateCollectionResponse& response) {
+            invalidateSearchCache(dbName, collectionName);
+            callback(parseTruncateCollectionResponse(status, response, result));
+        });
+}
+
+std::future<int> RpcClient::truncateCollectionAsync(const std::string& dbName, const std::string& collectionName,
+    TruncateCollectionResult* result, int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        truncateCollectionAsync(dbName, collectionName, result, std::move(callback), timeout);
+    });
+}
+
+void RpcClient::dropCollectionAsync(const std::string& dbName, const std::string& collectionName,
+    DropCollectionResult* result, AsyncCallback callback, int timeout) {
+    ScopedArena arena;
+    olama::DropCollectionRequest& request = arena.create<olama::DropCollectionRequest>();
+    request.set_database(dbName);
+    request.set_collection(collectionName);
+    invalidateSearchCache(dbName, collectionName);
+    invokeAsync<olama::DropCollectionRequest, olama::DropCollectionResponse>(
+        &olama::SearchEngine::Stub::PrepareAsyncdropCollection, request, timeout,
+        [this, dbName, collectionName, result, callback](const grpc::Status& status,
+            olama::DropCollectionResponse& response) {
+            invalidateSearchCache(dbName, collectionName);
+            callback(parseDropCollectionResponse(status, response, result));
+        });
+}
+
+std::future<int> RpcClient::dropCollectionAsync(const std::string& dbName, const std::string& collectionName,
+    DropCollectionResult* result, int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        dropCollectionAsync(dbName, collectionName, result, std::move(callback), timeout);
+    });
+}
+
 }  // namespace vectordb
@@ -27,20 +27,21 @@
 */
 
 #include "include/rpc_client.h"
+#include "include/rpc_invoke.h"
+#include "include/scoped_arena.h"
 #include "include/types/database.h"
 
 namespace vectordb {
 
-int RpcClient::createDatabase(const std::string& dbName, CreateDatabaseResult* result, int timeout) {
-    olama::DatabaseRequest request;
-    request.set_database(dbName);
-    request.set_dbtype(olama::DataType::BASE);
-    olama::DatabaseResponse response;
-    grpc::ClientContext context;
-    std::chrono::system_clock::time_point deadline = std::chrono::system_clock::now() +
-        std::chrono::milliseconds(timeout);
-    context.set_deadline(deadline);
-    grpc::Status status = stub_->createDatabase(&context, request, &response);
+namespace {
+
+void fillDatabaseRequest(const std::string& dbName, olama::DatabaseRequest* request) {
+    request->set_database(dbName);
+    request->set_dbtype(olama::DataType::BASE);
+}
+
+int parseCreateDatabaseResponse(const grpc::Status& status, const olama::DatabaseResponse& response,
+    const std::string& dbName, CreateDatabaseResult* result) {
     if (!status.ok()) {
         result->success = false;
         result->message = "Fail to create database: " + status.error_message();
@@ -59,14 +60,8 @@ int RpcClient::createDatabase(const std::string& dbName, CreateDatabaseResult* r
     return 0;
 }
 
-int RpcClient::listDatabases(ListDatabaseResult* result, int timeout) {
-    olama::DatabaseRequest request;
-    olama::DatabaseResponse response;
-    grpc::ClientContext context;
-    std::chrono::system_clock::time_point deadline = std::chrono::system_clock::now() +
-        std::chrono::milliseconds(timeout);
-    context.set_deadline(deadline);
-    grpc::Status status = stub_->listDatabases(&context, request, &response);
+int parseListDatabasesResponse(const grpc::Status& status, const olama::DatabaseResponse& response,
+    ListDatabaseResult* result) {
     if (!status.ok()) {
         result->success = false;
         result->message = "Fail to list databases: " + status.error_message();
@@ -94,16 +89,8 @@ int RpcClient::listDatabases(ListDatabaseResult* result, int timeout) {
     return 0;
 }
 
-int RpcClient::dropDatabase(const std::string& dbName, DropDatabaseResult* result, int timeout) {
-    olama::DatabaseRequest request;
-    request.set_database(dbName);
-    request.set_dbtype(olama::DataType::BASE);
-    olama::DatabaseResponse response;
-    grpc::ClientContext context;
-    std::chrono::system_clock::time_point deadline = std::chrono::system_clock::now() +
-        std::chrono::milliseconds(timeout);
-    context.set_deadline(deadline);
-    grpc::Status status = stub_->dropDatabase(&context, request, &response);
+int parseDropDatabaseResponse(const grpc::Status& status, const olama::DatabaseResponse& response,
+    DropDatabaseResult* result) {
     if (!status.ok()) {
         result->success = false;
         result->message = "Fail to drop database: " + status.error_message();
@@ -119,4 +106,88 @@ int RpcClient::dropDatabase(const std::string& dbName, DropDatabaseResult* resul
     return 0;
 }
 
+}  // namespace
+
+int RpcClient::createDatabase(const std::string& dbName, CreateDatabaseResult* result, int timeout) {
+    ScopedArena arena;
+    olama::DatabaseRequest& request = arena.create<olama::DatabaseRequest>();
+    fillDatabaseRequest(dbName, &request);
+    olama::DatabaseResponse& response = arena.create<olama::DatabaseResponse>();
+    grpc::Status status = invoke(&olama::SearchEngine::Stub::createDatabase, request, &response, timeout);
+    return parseCreateDatabaseResponse(status, response, dbName, result);
+}
+
+int RpcClient::listDatabases(ListDatabaseResult* result, int timeout) {
+    ScopedArena arena;
+    olama::DatabaseRequest& request = arena.create<olama::DatabaseRequest>();
+    olama::DatabaseResponse& response = arena.create<olama::DatabaseResponse>();
+    grpc::Status status = invoke(&olama::SearchEngine::Stub::listDatabases, request, &response, timeout);
+    return parseListDatabasesResponse(status, response, result);
+}
+
+int RpcClient::dropDatabase(const std::string& dbName, DropDatabaseResult* result, int timeout) {
+    ScopedArena arena;
+    olama::DatabaseRequest& request = arena.create<olama::DatabaseRequest>();
+    fillDatabaseRequest(dbName, &request);
+    olama::DatabaseResponse& response = arena.create<olama::DatabaseResponse>();
+    invalidateSearchCache(dbName);
+    grpc::Status status = invoke(&olama::SearchEngine::Stub::dropDatabase, request, &response, timeout);
+    invalidateSearchCache(dbName);
+    return parseDropDatabaseResponse(status, response, result);
+}
+
+void RpcClient::createDatabaseAsync(const std::string& dbName, CreateDatabaseResult* result,
+    AsyncCallback callback, int timeout) {
+    ScopedArena arena;
+    olama::DatabaseRequest& request = arena.create<olama::DatabaseRequest>();
+    fillDatabaseRequest(dbName, &request);
+    invokeAsync<olama::DatabaseRequest, olama::DatabaseResponse>(&olama::SearchEngine::Stub::PrepareAsynccreateDatabase,
+        request, timeout, [dbName, result, callback](const grpc::Status& status, olama::DatabaseResponse& response) {
+            callback(parseCreateDatabaseResponse(status, response, dbName, result));
+        });
+}
+
+std::future<int> RpcClient::createDatabaseAsync(const std::string& dbName, CreateDatabaseResult* result,
+    int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        createDatabaseAsync(dbName, result, std::move(callback), timeout);
+    });
+}
+
+void RpcClient::listDatabasesAsync(ListDatabaseResult* result, AsyncCallback callback, int timeout) {
+    ScopedArena arena;
+    olama::DatabaseRequest& request = arena.create<olama::DatabaseRequest>();
+    invokeAsync<olama::DatabaseRequest, olama::DatabaseResponse>(&olama::SearchEngine::Stub::PrepareAsynclistDatabases,
+        request, timeout, [result, callback](const grpc::Status& status, olama::DatabaseResponse& response) {
+            callback(parseListDatabasesResponse(status, response, result));
+        });
+}
+
+std::future<int> RpcClient::listDatabasesAsync(ListDatabaseResult* result, int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        listDatabasesAsync(result, std::move(callback), timeout);
+    });
+}
+
+void RpcClient::dropDatabaseAsync(const std::string& dbName, DropDatabaseResult* result,
+    AsyncCallback callback, int timeout) {
+    ScopedArena arena;
+    olama::DatabaseRequest& request = arena.create<olama::DatabaseRequest>();
+    fillDatabaseRequest(dbName, &request);
+    invalidateSearchCache(dbName);
+    invokeAsync<olama::DatabaseRequest, olama::DatabaseResponse>(&olama::SearchEngine::Stub::PrepareAsyncdropDatabase,
+        request, timeout, [this, dbName, result, callback](const grpc::Status& status,
+            olama::DatabaseResponse& response) {
+            invalidateSearchCache(dbName);
+            callback(parseDropDatabaseResponse(status, response, result));
+        });
+}
+
+std::future<int> RpcClient::dropDatabaseAsync(const std::string& dbName, DropDatabaseResult* result,
+    int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        dropDatabaseAsync(dbName, result, std::move(callback), timeout);
+    });
+}
+
 }  // namespace vectordb
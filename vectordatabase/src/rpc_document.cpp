@@ -26,41 +26,135 @@
   *THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <algorithm>
+#include <condition_variable>
+#include <future>
+#include <limits>
+#include <mutex>
+
 #include "include/rpc_client.h"
+#include "include/rpc_invoke.h"
+#include "include/scoped_arena.h"
 #include "include/helper.h"
+#include "include/rerank.h"
 #include "include/types/document.h"
 
 namespace vectordb {
 
-int RpcClient::upsert(const std::string& dbName, const std::string& collectionName,
-    const std::vector<Document>& documents, const UpsertDocumentParams* params,
-    UpsertDocumentResult* result, int timeout) {
-    olama::UpsertRequest request;
-    request.set_database(dbName);
-    request.set_collection(collectionName);
-    for (const auto& doc : documents) {
-        olama::Document* d = request.add_documents();
-        d->set_id(doc.id);
-        for (const auto& [key, value] : doc.fields) {
-            olama::Field protoField;
-            convertField2Proto(value, &protoField);
-            (*d->mutable_fields())[key] = protoField;
+namespace {
+
+// 按序列化后的字节数将文档分配到多个请求, 每个请求不超过maxBatchBytes
+// 单个文档超过上限时独占一个请求; maxBatchBytes不大于0时不拆分
+class UpsertRequestSplitter {
+  public:
+    UpsertRequestSplitter(const std::string& dbName, const std::string& collectionName,
+        const UpsertDocumentParams* params, int64_t maxBatchBytes, std::vector<olama::UpsertRequest>* requests)
+        : requests_(requests) {
+        header_.set_database(dbName);
+        header_.set_collection(collectionName);
+        if (params != nullptr) {
+            header_.set_buildindex(params->buildIndex);
+        } else {
+            header_.set_buildindex(true);
         }
-        for (const auto& vec : doc.vector) {
-            d->add_vector(vec);
+        headerSize_ = header_.ByteSizeLong();
+        budget_ = maxBatchBytes > 0 ? static_cast<size_t>(maxBatchBytes) : SIZE_MAX;
+        requests_->clear();
+        requests_->push_back(header_);
+        batchSize_ = headerSize_;
+    }
+
+    // 将doc移入当前请求, 超出上限时开始新的请求
+    void add(olama::Document* doc) {
+        size_t docSize = encodedDocumentSize(*doc);
+        if (requests_->back().documents_size() > 0 && batchSize_ + docSize > budget_) {
+            requests_->push_back(header_);
+            batchSize_ = headerSize_;
         }
+        requests_->back().add_documents()->Swap(doc);
+        batchSize_ += docSize;
     }
-    if (params != nullptr) {
-        request.set_buildindex(params->buildIndex);
-    } else {
-        request.set_buildindex(true);
-    }
-    grpc::ClientContext context;
-    std::chrono::system_clock::time_point deadline = std::chrono::system_clock::now() +
-        std::chrono::milliseconds(timeout);
-    context.set_deadline(deadline);
-    olama::UpsertResponse response;
-    grpc::Status status = stub_->upsert(&context, request, &response);
+
+  private:
+    olama::UpsertRequest header_;
+    size_t headerSize_;
+    size_t budget_;
+    size_t batchSize_;
+    std::vector<olama::UpsertRequest>* requests_;
+};
+
+// 按params->coalesce合并相同id的文档后拆分为多个请求
+void fillUpsertRequests(const std::string& dbName, const std::string& collectionName,
+    const std::vector<Document>& documents, const UpsertDocumentParams* params, int64_t maxBatchBytes,
+    std::vector<olama::UpsertRequest>* requests) {
+    std::deque<Document> merged;
+    std::vector<const Document*> coalesced = coalesceDocuments(documents,
+        params != nullptr ? params->coalesce : CoalescePolicy::kNone, &merged);
+    UpsertRequestSplitter splitter(dbName, collectionName, params, maxBatchBytes, requests);
+    for (const Document* doc : coalesced) {
+        olama::Document d;
+        convertDocument2Proto(*doc, &d);
+        splitter.add(&d);
+    }
+}
+
+void fillUpsertRequests(const std::string& dbName, const std::string& collectionName,
+    std::vector<Document>&& documents, const UpsertDocumentParams* params, int64_t maxBatchBytes,
+    std::vector<olama::UpsertRequest>* requests) {
+    std::vector<Document*> coalesced = coalesceOwnedDocuments(&documents,
+        params != nullptr ? params->coalesce : CoalescePolicy::kNone);
+    UpsertRequestSplitter splitter(dbName, collectionName, params, maxBatchBytes, requests);
+    for (Document* doc : coalesced) {
+        olama::Document d;
+        convertDocument2Proto(std::move(*doc), &d);
+        splitter.add(&d);
+    }
+}
+
+// 矩阵数据为空或行间隔小于维度时在发送请求前失败, 避免越界读取调用方的内存
+template <typename Result>
+int checkMatrix(const VectorMatrixView& vectors, const char* action, Result* result) {
+    if ((vectors.data != nullptr || vectors.rows == 0) && (vectors.stride == 0 || vectors.stride >= vectors.dim)) {
+        return 0;
+    }
+    result->success = false;
+    result->message = std::string("Fail to ") + action +
+        " documents: vectors must have non-null data and a stride of 0 or at least dim";
+    return -1;
+}
+
+int fillUpsertRequests(const std::string& dbName, const std::string& collectionName,
+    IdSpan ids, const VectorMatrixView& vectors,
+    const std::vector<std::unordered_map<std::string, Field>>* fields, const UpsertDocumentParams* params,
+    int64_t maxBatchBytes, std::vector<olama::UpsertRequest>* requests, UpsertDocumentResult* result) {
+    if (checkMatrix(vectors, "upsert", result) != 0) {
+        return -1;
+    }
+    if (ids.size != vectors.rows || (fields != nullptr && fields->size() != vectors.rows)) {
+        result->success = false;
+        result->message = "Fail to upsert documents: ids, vectors and fields must have the same number of rows";
+        return -1;
+    }
+    UpsertRequestSplitter splitter(dbName, collectionName, params, maxBatchBytes, requests);
+    for (size_t i = 0; i < vectors.rows; ++i) {
+        olama::Document d;
+        d.set_id(ids[i]);
+        copyVector2Proto(vectors.row(i), vectors.dim, d.mutable_vector());
+        if (fields != nullptr) {
+            for (const auto& [key, value] : (*fields)[i]) {
+                convertField2Proto(value, &(*d.mutable_fields())[key]);
+            }
+        }
+        splitter.add(&d);
+    }
+    return 0;
+}
+
+int parseUpsertResponse(const grpc::Status& status, const olama::UpsertResponse& response,
+    UpsertDocumentResult* result) {
+    result->statusCode = status.error_code();
+    result->code = status.ok() ? response.code() : 0;
+    result->warning = status.ok() ? response.warning() : std::string();
     if (!status.ok()) {
         result->success = false;
         result->message = "Fail to upsert documents: " + status.error_message();
@@ -77,35 +171,31 @@ int RpcClient::upsert(const std::string& dbName, const std::string& collectionNa
     return 0;
 }
 
-int RpcClient::query(const std::string& dbName, const std::string& collectionName,
-    const std::vector<std::string>& documentIds,
-    const QueryDocumentParams* params, QueryDocumentResult* result, int timeout) {
-    olama::QueryRequest request;
-    request.set_database(dbName);
-    request.set_collection(collectionName);
-    olama::QueryCond* queryCond = new olama::QueryCond();
+void fillQueryRequest(const std::string& dbName, const std::string& collectionName,
+    const std::vector<std::string>& documentIds, const QueryDocumentParams* params,
+    const std::string& readConsistency, olama::QueryRequest* request) {
+    request->set_database(dbName);
+    request->set_collection(collectionName);
+    olama::QueryCond* queryCond = request->mutable_query();
     for (const auto& docId : documentIds) {
         queryCond->add_documentids(docId);
     }
-    request.set_allocated_query(queryCond);
-    request.set_readconsistency(option_.readConsistency);
+    request->set_readconsistency(readConsistency);
     if (params != nullptr) {
         if (params->filter) {
-            request.mutable_query()->set_filter(params->filter->cond);
+            request->mutable_query()->set_filter(params->filter->cond);
         }
-        request.mutable_query()->set_retrievevector(params->retrieveVector);
+        request->mutable_query()->set_retrievevector(params->retrieveVector);
         for (const auto& field : params->outputFields) {
-            request.mutable_query()->add_outputfields(field);
+            request->mutable_query()->add_outputfields(field);
         }
-        request.mutable_query()->set_offset(params->offset);
-        request.mutable_query()->set_limit(params->limit);
-    }
-    grpc::ClientContext context;
-    std::chrono::system_clock::time_point deadline = std::chrono::system_clock::now() +
-        std::chrono::milliseconds(timeout);
-    context.set_deadline(deadline);
-    olama::QueryResponse response;
-    grpc::Status status = stub_->query(&context, request, &response);
+        request->mutable_query()->set_offset(params->offset);
+        request->mutable_query()->set_limit(params->limit);
+    }
+}
+
+int parseQueryResponse(const grpc::Status& status, const olama::QueryResponse& response,
+    QueryDocumentResult* result) {
     if (!status.ok()) {
         result->success = false;
         result->message = "Fail to query documents: " + status.error_message();
@@ -126,21 +216,22 @@ int RpcClient::query(const std::string& dbName, const std::string& collectionNam
             convertProto2Field(value, &field);
             d.fields[key] = field;
         }
-        documents.push_back(d);
+        documents.push_back(std::move(d));
     }
-    result->documents = documents;
+    result->success = true;
+    result->message = response.msg();
+    result->documents = std::move(documents);
     result->total = response.count();
     return 0;
 }
 
-int RpcClient::dele(const std::string& dbName, const std::string& collectionName,
-        const DeleteDocumentParams* params, DeleteDocumentResult* result, int timeout) {
-    olama::DeleteRequest request;
-    request.set_database(dbName);
-    request.set_collection(collectionName);
+void fillDeleteRequest(const std::string& dbName, const std::string& collectionName,
+    const DeleteDocumentParams* params, olama::DeleteRequest* request) {
+    request->set_database(dbName);
+    request->set_collection(collectionName);
 
     if (params != nullptr) {
-        olama::QueryCond* queryCond = new olama::QueryCond();
+        olama::QueryCond* queryCond = request->mutable_query();
         for (const auto& docId : params->documentIds) {
             queryCond->add_documentids(docId);
         }
@@ -150,14 +241,11 @@ int RpcClient::dele(const std::string& dbName, const std::string& collectionName
         if (params->limit > 0) {
             queryCond->set_limit(params->limit);
         }
-        request.set_allocated_query(queryCond);
-    }
-    grpc::ClientContext context;
-    std::chrono::system_clock::time_point deadline = std::chrono::system_clock::now() +
-        std::chrono::milliseconds(timeout);
-    context.set_deadline(deadline);
-    olama::DeleteResponse response;
-    grpc::Status status = stub_->dele(&context, request, &response);
+    }
+}
+
+int parseDeleteResponse(const grpc::Status& status, const olama::DeleteResponse& response,
+    DeleteDocumentResult* result) {
     if (!status.ok()) {
         result->success = false;
         result->message = "Fail to dele documents: " + status.error_message();
@@ -174,100 +262,63 @@ int RpcClient::dele(const std::string& dbName, const std::string& collectionName
     return 0;
 }
 
-int RpcClient::update(const std::string& dbName, const std::string& collectionName,
-        const UpdateDocumentParams* params, UpdateDocumentResult* result, int timeout) {
-    olama::UpdateRequest request;
-    request.set_database(dbName);
-    request.set_collection(collectionName);
-    if (params) {
-        olama::QueryCond* queryCond = new olama::QueryCond();
-        for (const auto& docId : params->queryIds) {
-            queryCond->add_documentids(docId);
-        }
-        if (params->queryFilter) {
-            queryCond->set_filter(params->queryFilter->cond);
+void fillSearchParams(const std::string& dbName, const std::string& collectionName,
+    const SearchDocumentParams* params, const std::string& readConsistency, olama::SearchRequest* request) {
+    request->set_database(dbName);
+    request->set_collection(collectionName);
+    request->set_readconsistency(readConsistency);
+    olama::SearchCond* searchCond = request->mutable_search();
+    if (params != nullptr) {
+        if (params->filter) {
+            searchCond->set_filter(params->filter->cond);
         }
-        request.set_allocated_query(queryCond);
-        auto* updateDoc = new olama::Document();
-        for (const auto& value : params->updateVector) {
-            updateDoc->add_vector(value);
+        searchCond->set_retrievevector(params->retrieveVector);
+        for (const auto& field : params->outputFields) {
+            searchCond->add_outputfields(field);
         }
-        for (const auto& [key, value] : params->updateFields) {
-            olama::Field protoField;
-            convertField2Proto(value, &protoField);
-            (*updateDoc->mutable_fields())[key] = protoField;
+        searchCond->set_limit(params->limit);
+        if (params->searchParams) {
+            olama::SearchParams* protoSearchParams = searchCond->mutable_params();
+            protoSearchParams->set_nprobe(params->searchParams->nprobe);
+            protoSearchParams->set_ef(params->searchParams->ef);
+            protoSearchParams->set_radius(params->searchParams->radius);
         }
-        request.set_allocated_update(updateDoc);
-    }
-    grpc::ClientContext context;
-    std::chrono::system_clock::time_point deadline = std::chrono::system_clock::now() +
-        std::chrono::milliseconds(timeout);
-    context.set_deadline(deadline);
-    olama::UpdateResponse response;
-    grpc::Status status = stub_->update(&context, request, &response);
-    if (!status.ok()) {
-        result->success = false;
-        result->message = "Fail to update documents: " + status.error_message();
-        return -1;
-    }
-    if (response.code() != 0) {
-        result->success = false;
-        result->message = "Fail to update documents: " + response.msg();
-        return -1;
     }
-    result->success = true;
-    result->message = response.msg();
-    result->affectedCount = static_cast<int>(response.affectedcount());
-    return 0;
 }
 
-int RpcClient::search(const std::string& dbName, const std::string& collectionName,
+void fillSearchRequest(const std::string& dbName, const std::string& collectionName,
     const std::vector<std::string>& documentIds, const std::vector<std::vector<float>>& vectors,
-    const std::map<std::string, std::vector<std::string>>& text,
-    const SearchDocumentParams* params, SearchDocumentResult* result, int timeout) {
-    olama::SearchRequest request;
-    request.set_database(dbName);
-    request.set_collection(collectionName);
-    request.set_readconsistency(option_.readConsistency);
-    olama::SearchCond* searchCond = new olama::SearchCond();
+    const std::map<std::string, std::vector<std::string>>& text, const SearchDocumentParams* params,
+    const std::string& readConsistency, olama::SearchRequest* request) {
+    fillSearchParams(dbName, collectionName, params, readConsistency, request);
+    olama::SearchCond* searchCond = request->mutable_search();
     for (const auto& docId : documentIds) {
         searchCond->add_documentids(docId);
     }
+    searchCond->mutable_vectors()->Reserve(static_cast<int>(vectors.size()));
     for (const auto& vector : vectors) {
-        auto* vectorArray = searchCond->add_vectors();
-        for (const auto& vecValue : vector) {
-            vectorArray->add_vector(vecValue);
-        }
+        copyVector2Proto(vector.data(), vector.size(), searchCond->add_vectors()->mutable_vector());
     }
     for (const auto& [key, value] : text) {
         for (const auto& str : value) {
             searchCond->add_embeddingitems(str);
         }
     }
-    request.set_allocated_search(searchCond);
-    if (params != nullptr) {
-        if (params->filter) {
-            request.mutable_search()->set_filter(params->filter->cond);
-        }
-        request.mutable_search()->set_retrievevector(params->retrieveVector);
-        for (const auto& field : params->outputFields) {
-            request.mutable_search()->add_outputfields(field);
-        }
-        request.mutable_search()->set_limit(params->limit);
-        if (params->searchParams) {
-            olama::SearchParams* protoSearchParams = new olama::SearchParams();
-            protoSearchParams->set_nprobe(params->searchParams->nprobe);
-            protoSearchParams->set_ef(params->searchParams->ef);
-            protoSearchParams->set_radius(params->searchParams->radius);
-            request.mutable_search()->set_allocated_params(protoSearchParams);
-        }
+}
+
+void fillSearchRequest(const std::string& dbName, const std::string& collectionName,
+    const VectorMatrixView& vectors, const SearchDocumentParams* params, const std::string& readConsistency,
+    olama::SearchRequest* request) {
+    fillSearchParams(dbName, collectionName, params, readConsistency, request);
+    olama::SearchCond* searchCond = request->mutable_search();
+    searchCond->mutable_vectors()->Reserve(static_cast<int>(vectors.rows));
+    for (size_t i = 0; i < vectors.rows; ++i) {
+        copyVector2Proto(vectors.row(i), vectors.dim, searchCond->add_vectors()->mutable_vector());
     }
-    grpc::ClientContext context;
-    std::chrono::system_clock::time_point deadline = std::chrono::system_clock::now() +
-        std::chrono::milliseconds(timeout);
-    context.set_deadline(deadline);
-    olama::SearchResponse response;
-    grpc::Status status = stub_->search(&context, request, &response);
+}
+
+int parseSearchResponse(const grpc::Status& status, const olama::SearchResponse& response,
+    SearchDocumentResult* result) {
     if (!status.ok()) {
         result->success = false;
         result->message = "Fail to search documents: " + status.error_message();
@@ -293,49 +344,998 @@ int RpcClient::search(const std::string& dbName, const std::string& collectionNa
             }
             vecDocs.push_back(std::move(d));
         }
-        result->documents.push_back(vecDocs);
+        result->documents.push_back(std::move(vecDocs));
     }
     result->success = true;
     result->message = response.msg();
     return 0;
 }
 
-int RpcClient::count(const std::string& dbName, const std::string& collectionName,
-    const Filter* filter, CountResult* result, int timeout) {
-    olama::CountRequest request;
-    request.set_database(dbName);
-    request.set_collection(collectionName);
-    
+void fillUpdateRequest(const std::string& dbName, const std::string& collectionName,
+    const UpdateDocumentParams* params, olama::UpdateRequest* request) {
+    request->set_database(dbName);
+    request->set_collection(collectionName);
+    if (params) {
+        olama::QueryCond* queryCond = request->mutable_query();
+        for (const auto& docId : params->queryIds) {
+            queryCond->add_documentids(docId);
+        }
+        if (params->queryFilter) {
+            queryCond->set_filter(params->queryFilter->cond);
+        }
+        olama::Document* updateDoc = request->mutable_update();
+        copyVector2Proto(params->updateVector.data(), params->updateVector.size(), updateDoc->mutable_vector());
+        for (const auto& [key, value] : params->updateFields) {
+            convertField2Proto(value, &(*updateDoc->mutable_fields())[key]);
+        }
+    }
+}
+
+int parseUpdateResponse(const grpc::Status& status, const olama::UpdateResponse& response,
+    UpdateDocumentResult* result) {
+    if (!status.ok()) {
+        result->success = false;
+        result->message = "Fail to update documents: " + status.error_message();
+        return -1;
+    }
+    if (response.code() != 0) {
+        result->success = false;
+        result->message = "Fail to update documents: " + response.msg();
+        return -1;
+    }
+    result->success = true;
+    result->message = response.msg();
+    result->affectedCount = static_cast<int>(response.affectedcount());
+    return 0;
+}
+
+void fillCountRequest(const std::string& dbName, const std::string& collectionName,
+    const Filter* filter, olama::CountRequest* request) {
+    request->set_database(dbName);
+    request->set_collection(collectionName);
+
     if (filter != nullptr) {
-        olama::QueryCond* queryCond = new olama::QueryCond();
+        olama::QueryCond* queryCond = request->mutable_query();
         queryCond->set_filter(filter->cond);
-        request.set_allocated_query(queryCond);
     }
+}
 
-    grpc::ClientContext context;
-    std::chrono::system_clock::time_point deadline = std::chrono::system_clock::now() +
-        std::chrono::milliseconds(timeout);
-    context.set_deadline(deadline);
-    
-    olama::CountResponse response;
-    grpc::Status status = stub_->count(&context, request, &response);
-    
+int parseCountResponse(const grpc::Status& status, const olama::CountResponse& response,
+    CountResult* result) {
     if (!status.ok()) {
         result->success = false;
         result->message = "Fail to count documents: " + status.error_message();
         return -1;
     }
-    
+
     if (response.code() != 0) {
         result->success = false;
         result->message = "Fail to count documents: " + response.msg();
         return -1;
     }
-    
+
     result->success = true;
     result->message = response.msg();
     result->count = response.count();
     return 0;
 }
 
+int parseSearchResponse(const grpc::Status& status, olama::SearchResponse& response, SearchResultView* result,
+    olama::SearchResponse** adopted) {
+    if (!status.ok()) {
+        result->success = false;
+        result->message = "Fail to search documents: " + status.error_message();
+        return -1;
+    }
+    if (response.code() != 0) {
+        result->success = false;
+        result->message = "Fail to search documents: " + response.msg();
+        return -1;
+    }
+    *adopted = &response;
+    result->success = true;
+    result->message = response.msg();
+    return 0;
+}
+
+int parseSearchResponse(const grpc::Status& status, const olama::SearchResponse& response,
+    const std::vector<std::string>& columns, ColumnarSearchResult* result) {
+    if (!status.ok()) {
+        result->success = false;
+        result->message = "Fail to search documents: " + status.error_message();
+        return -1;
+    }
+    if (response.code() != 0) {
+        result->success = false;
+        result->message = "Fail to search documents: " + response.msg();
+        return -1;
+    }
+    fillColumnarResult(response, columns, result);
+    return 0;
+}
+
+// 重排的度量不受支持时在发送请求前失败
+int checkRerank(const SearchDocumentParams* params, SearchDocumentResult* result) {
+    if (params == nullptr || !params->rerank || rerankMetricSupported(params->rerank->metricType)) {
+        return 0;
+    }
+    result->success = false;
+    result->message = "Fail to search documents: unsupported metricType " + params->rerank->metricType +
+        " for rerank";
+    return -1;
+}
+
+// SearchResultView及ColumnarSearchResult直接引用响应中的结果, 不支持重排
+template <typename Result>
+int rejectRerank(const SearchDocumentParams* params, Result* result) {
+    if (params == nullptr || !params->rerank) {
+        return 0;
+    }
+    result->success = false;
+    result->message = "Fail to search documents: rerank is not supported for SearchResultView or "
+        "ColumnarSearchResult, use SearchDocumentResult instead";
+    return -1;
+}
+
+// 开启重排时按limit * overFetch取回候选及其向量
+void applyRerank(const SearchDocumentParams* params, olama::SearchRequest* request) {
+    if (params == nullptr || !params->rerank) {
+        return;
+    }
+    olama::SearchCond* searchCond = request->mutable_search();
+    searchCond->set_limit(params->limit * std::max(1, params->rerank->overFetch));
+    searchCond->set_retrievevector(true);
+}
+
+std::vector<FloatSpan> querySpans(const std::vector<std::vector<float>>& vectors) {
+    std::vector<FloatSpan> queries;
+    queries.reserve(vectors.size());
+    for (const auto& vector : vectors) {
+        queries.push_back({vector.data(), vector.size()});
+    }
+    return queries;
+}
+
+std::vector<FloatSpan> querySpans(const VectorMatrixView& vectors) {
+    std::vector<FloatSpan> queries;
+    queries.reserve(vectors.rows);
+    for (size_t i = 0; i < vectors.rows; ++i) {
+        queries.push_back({vectors.row(i), vectors.dim});
+    }
+    return queries;
+}
+
+// 重排从begin开始追加的各组结果; 没有对应检索向量(按id或文本检索)的结果只截断为limit
+void rerankSearchResult(const std::vector<FloatSpan>& queries, const RerankParams& rerank, int64_t limit,
+    bool retrieveVector, size_t begin, SearchDocumentResult* result) {
+    size_t keep = limit > 0 ? static_cast<size_t>(limit) : std::numeric_limits<size_t>::max();
+    for (size_t i = begin; i < result->documents.size(); ++i) {
+        std::vector<Document>& documents = result->documents[i];
+        size_t query = i - begin;
+        if (query < queries.size()) {
+            rerankDocuments(queries[query].data, queries[query].size, rerank.metricType, keep, &documents);
+        } else if (documents.size() > keep) {
+            documents.erase(documents.begin() + keep, documents.end());
+        }
+        if (!retrieveVector) {
+            for (auto& document : documents) {
+                std::vector<float>().swap(document.vector);
+            }
+        }
+    }
+}
+
+// 取出从begin开始追加到result中的检索结果, 用于写入检索结果缓存
+std::vector<std::vector<Document>> appendedDocuments(const SearchDocumentResult& result, size_t begin) {
+    return std::vector<std::vector<Document>>(result.documents.begin() + begin, result.documents.end());
+}
+
+}  // namespace
+
+int RpcClient::upsert(const std::string& dbName, const std::string& collectionName,
+    const std::vector<Document>& documents, const UpsertDocumentParams* params,
+    UpsertDocumentResult* result, int timeout) {
+    std::vector<olama::UpsertRequest> requests;
+    fillUpsertRequests(dbName, collectionName, documents, params, option_.maxBatchBytes, &requests);
+    return sendUpsertRequests(std::move(requests), result, timeout);
+}
+
+int RpcClient::upsert(const std::string& dbName, const std::string& collectionName,
+    std::vector<Document>&& documents, const UpsertDocumentParams* params,
+    UpsertDocumentResult* result, int timeout) {
+    std::vector<olama::UpsertRequest> requests;
+    fillUpsertRequests(dbName, collectionName, std::move(documents), params, option_.maxBatchBytes, &requests);
+    return sendUpsertRequests(std::move(requests), result, timeout);
+}
+
+int RpcClient::upsert(const std::string& dbName, const std::string& collectionName,
+    IdSpan ids, const VectorMatrixView& vectors,
+    const std::vector<std::unordered_map<std::string, Field>>* fields, const UpsertDocumentParams* params,
+    UpsertDocumentResult* result, int timeout) {
+    UpsertDocumentResult ignored;
+    if (result == nullptr) {
+        result = &ignored;
+    }
+    std::vector<olama::UpsertRequest> requests;
+    if (fillUpsertRequests(dbName, collectionName, ids, vectors, fields, params, option_.maxBatchBytes,
+        &requests, result) != 0) {
+        return -1;
+    }
+    return sendUpsertRequests(std::move(requests), result, timeout);
+}
+
+// 多个子请求共享的状态, 由各子请求的完成回调共同持有
+struct RpcClient::UpsertBatchState {
+    std::mutex mutex;
+    std::vector<olama::UpsertRequest> requests;
+    std::string database;
+    std::string collection;
+    // 下一个待发送的子请求
+    size_t next = 0;
+    size_t inFlight = 0;
+    size_t succeeded = 0;
+    int affectedCount = 0;
+    bool failed = false;
+    std::string message;
+    std::string warning;
+    int code = 0;
+    int statusCode = 0;
+    UpsertDocumentResult* result = nullptr;
+    AsyncCallback callback;
+    int timeout = 0;
+    // 为true时由调用线程发送子请求并等待并发额度, 子请求完成后通知windowAvailable而不是发送下一个子请求
+    bool waitForSlot = false;
+    std::condition_variable windowAvailable;
+};
+
+int RpcClient::sendUpsertRequests(std::vector<olama::UpsertRequest>&& requests, UpsertDocumentResult* result,
+    int timeout) {
+    if (requests.size() == 1) {
+        return upsert(requests[0], result, timeout);
+    }
+    UpsertDocumentResult ignored;
+    if (result == nullptr) {
+        result = &ignored;
+    }
+    auto state = std::make_shared<UpsertBatchState>();
+    state->requests = std::move(requests);
+    state->result = result;
+    std::future<int> future = toFuture([&state](AsyncCallback callback) {
+        state->callback = std::move(callback);
+    });
+    state->timeout = timeout;
+    state->waitForSlot = true;
+    state->database = state->requests[0].database();
+    state->collection = state->requests[0].collection();
+    invalidateSearchCache(state->database, state->collection);
+    size_t window = static_cast<size_t>(std::max(1, option_.maxBatchParallelism));
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->windowAvailable.wait(lock, [&state, window] {
+                return state->failed || state->inFlight < window;
+            });
+            if (state->failed || state->next == state->requests.size()) {
+                break;
+            }
+        }
+        sendUpsertBatch(state);
+    }
+    return future.get();
+}
+
+int RpcClient::upsert(const olama::UpsertRequest& request, UpsertDocumentResult* result, int timeout) {
+    UpsertDocumentResult ignored;
+    if (result == nullptr) {
+        result = &ignored;
+    }
+    ScopedArena arena;
+    olama::UpsertResponse& response = arena.create<olama::UpsertResponse>();
+    invalidateSearchCache(request.database(), request.collection());
+    grpc::Status status = invoke(&olama::SearchEngine::Stub::upsert, request, &response, timeout);
+    invalidateSearchCache(request.database(), request.collection());
+    return parseUpsertResponse(status, response, result);
+}
+
+int RpcClient::query(const std::string& dbName, const std::string& collectionName,
+    const std::vector<std::string>& documentIds,
+    const QueryDocumentParams* params, QueryDocumentResult* result, int timeout) {
+    ScopedArena arena;
+    olama::QueryRequest& request = arena.create<olama::QueryRequest>();
+    fillQueryRequest(dbName, collectionName, documentIds, params, option_.readConsistency, &request);
+    olama::QueryResponse& response = arena.create<olama::QueryResponse>();
+    grpc::Status status;
+    if (option_.hedging.enabled) {
+        status = invokeHedged(&olama::SearchEngine::Stub::PrepareAsyncquery, request, &response, timeout, &queryLatency_);
+    } else {
+        status = invoke(&olama::SearchEngine::Stub::query, request, &response, timeout);
+    }
+    return parseQueryResponse(status, response, result);
+}
+
+int RpcClient::dele(const std::string& dbName, const std::string& collectionName,
+        const DeleteDocumentParams* params, DeleteDocumentResult* result, int timeout) {
+    ScopedArena arena;
+    olama::DeleteRequest& request = arena.create<olama::DeleteRequest>();
+    fillDeleteRequest(dbName, collectionName, params, &request);
+    olama::DeleteResponse& response = arena.create<olama::DeleteResponse>();
+    invalidateSearchCache(dbName, collectionName);
+    grpc::Status status = invoke(&olama::SearchEngine::Stub::dele, request, &response, timeout);
+    invalidateSearchCache(dbName, collectionName);
+    return parseDeleteResponse(status, response, result);
+}
+
+int RpcClient::update(const std::string& dbName, const std::string& collectionName,
+        const UpdateDocumentParams* params, UpdateDocumentResult* result, int timeout) {
+    ScopedArena arena;
+    olama::UpdateRequest& request = arena.create<olama::UpdateRequest>();
+    fillUpdateRequest(dbName, collectionName, params, &request);
+    olama::UpdateResponse& response = arena.create<olama::UpdateResponse>();
+    invalidateSearchCache(dbName, collectionName);
+    grpc::Status status = invoke(&olama::SearchEngine::Stub::update, request, &response, timeout);
+    invalidateSearchCache(dbName, collectionName);
+    return parseUpdateResponse(status, response, result);
+}
+
+int RpcClient::search(const std::string& dbName, const std::string& collectionName,
+    const std::vector<std::string>& documentIds, const std::vector<std::vector<float>>& vectors,
+    const std::map<std::string, std::vector<std::string>>& text,
+    const SearchDocumentParams* params, SearchDocumentResult* result, int timeout) {
+    if (checkRerank(params, result) != 0) {
+        return -1;
+    }
+    bool rerank = params != nullptr && params->rerank;
+    size_t begin = rerank ? result->documents.size() : 0;
+    int ret;
+    if (searchBatcher_ && documentIds.empty() && text.empty() && vectors.size() == 1) {
+        ret = toFuture([&](AsyncCallback callback) {
+            submitBatchedSearch(dbName, collectionName, vectors[0].data(), vectors[0].size(), params, result,
+                std::move(callback), timeout);
+        }).get();
+    } else {
+        ScopedArena arena;
+        olama::SearchRequest& request = arena.create<olama::SearchRequest>();
+        fillSearchRequest(dbName, collectionName, documentIds, vectors, text, params, option_.readConsistency,
+            &request);
+        applyRerank(params, &request);
+        ret = search(request, result, timeout);
+    }
+    if (ret == 0 && rerank) {
+        bool byVector = documentIds.empty() && text.empty();
+        rerankSearchResult(byVector ? querySpans(vectors) : std::vector<FloatSpan>(), *params->rerank,
+            params->limit, params->retrieveVector, begin, result);
+    }
+    return ret;
+}
+
+int RpcClient::search(const std::string& dbName, const std::string& collectionName,
+    const VectorMatrixView& vectors, const SearchDocumentParams* params, SearchDocumentResult* result,
+    int timeout) {
+    if (checkMatrix(vectors, "search", result) != 0) {
+        return -1;
+    }
+    if (checkRerank(params, result) != 0) {
+        return -1;
+    }
+    bool rerank = params != nullptr && params->rerank;
+    size_t begin = rerank ? result->documents.size() : 0;
+    int ret;
+    if (searchBatcher_ && vectors.rows == 1) {
+        ret = toFuture([&](AsyncCallback callback) {
+            submitBatchedSearch(dbName, collectionName, vectors.row(0), vectors.dim, params, result,
+                std::move(callback), timeout);
+        }).get();
+    } else {
+        ScopedArena arena;
+        olama::SearchRequest& request = arena.create<olama::SearchRequest>();
+        fillSearchRequest(dbName, collectionName, vectors, params, option_.readConsistency, &request);
+        applyRerank(params, &request);
+        ret = search(request, result, timeout);
+    }
+    if (ret == 0 && rerank) {
+        rerankSearchResult(querySpans(vectors), *params->rerank, params->limit, params->retrieveVector, begin,
+            result);
+    }
+    return ret;
+}
+
+int RpcClient::search(const olama::SearchRequest& request, SearchDocumentResult* result, int timeout) {
+    AsyncCallback fillCache;
+    if (lookupSearchCache(request, result, &fillCache)) {
+        return 0;
+    }
+    ScopedArena arena;
+    olama::SearchResponse& response = arena.create<olama::SearchResponse>();
+    grpc::Status status;
+    if (option_.hedging.enabled) {
+        status = invokeHedged(&olama::SearchEngine::Stub::PrepareAsyncsearch, request, &response, timeout, &searchLatency_);
+    } else {
+        status = invoke(&olama::SearchEngine::Stub::search, request, &response, timeout);
+    }
+    int ret = parseSearchResponse(status, response, result);
+    if (fillCache) {
+        fillCache(ret);
+    }
+    return ret;
+}
+
+int RpcClient::search(const std::string& dbName, const std::string& collectionName,
+    const VectorMatrixView& vectors, const SearchDocumentParams* params, SearchResultView* result, int timeout) {
+    if (checkMatrix(vectors, "search", result) != 0) {
+        return -1;
+    }
+    if (rejectRerank(params, result) != 0) {
+        return -1;
+    }
+    ScopedArena arena;
+    olama::SearchRequest& request = arena.create<olama::SearchRequest>();
+    fillSearchRequest(dbName, collectionName, vectors, params, option_.readConsistency, &request);
+    return search(request, result, timeout);
+}
+
+int RpcClient::search(const olama::SearchRequest& request, SearchResultView* result, int timeout) {
+    olama::SearchResponse* response =
+        google::protobuf::Arena::CreateMessage<olama::SearchResponse>(result->reset());
+    grpc::Status status;
+    if (option_.hedging.enabled) {
+        status = invokeHedged(&olama::SearchEngine::Stub::PrepareAsyncsearch, request, response, timeout, &searchLatency_);
+    } else {
+        status = invoke(&olama::SearchEngine::Stub::search, request, response, timeout);
+    }
+    return parseSearchResponse(status, *response, result, &result->response_);
+}
+
+int RpcClient::search(const std::string& dbName, const std::string& collectionName,
+    const VectorMatrixView& vectors, const SearchDocumentParams* params, ColumnarSearchResult* result,
+    int timeout) {
+    if (checkMatrix(vectors, "search", result) != 0) {
+        return -1;
+    }
+    if (rejectRerank(params, result) != 0) {
+        return -1;
+    }
+    ScopedArena arena;
+    olama::SearchRequest& request = arena.create<olama::SearchRequest>();
+    fillSearchRequest(dbName, collectionName, vectors, params, option_.readConsistency, &request);
+    return search(request, result, timeout);
+}
+
+int RpcClient::search(const olama::SearchRequest& request, ColumnarSearchResult* result, int timeout) {
+    ScopedArena arena;
+    olama::SearchResponse& response = arena.create<olama::SearchResponse>();
+    grpc::Status status;
+    if (option_.hedging.enabled) {
+        status = invokeHedged(&olama::SearchEngine::Stub::PrepareAsyncsearch, request, &response, timeout, &searchLatency_);
+    } else {
+        status = invoke(&olama::SearchEngine::Stub::search, request, &response, timeout);
+    }
+    const auto& outputFields = request.search().outputfields();
+    return parseSearchResponse(status, response, std::vector<std::string>(outputFields.begin(), outputFields.end()),
+        result);
+}
+
+bool RpcClient::lookupSearchCache(const olama::SearchRequest& request, SearchDocumentResult* result,
+    AsyncCallback* fillCache) {
+    std::string key;
+    uint64_t version = 0;
+    if (searchCache_) {
+        key = SearchResultCache::key(request);
+        if (searchCache_->lookup(key, request.database(), request.collection(), result)) {
+            return true;
+        }
+        version = searchCache_->version(request.database(), request.collection());
+    }
+    std::shared_ptr<SemanticCacheProbe> probe;
+    if (semanticCache_ && SemanticSearchCache::cacheable(request)) {
+        probe = std::make_shared<SemanticCacheProbe>();
+        if (semanticCache_->lookup(request, result, probe.get())) {
+            return true;
+        }
+    }
+    if (!searchCache_ && !probe) {
+        return false;
+    }
+    size_t begin = result->documents.size();
+    *fillCache = [this, key = std::move(key), db = request.database(), coll = request.collection(), version,
+        probe = std::move(probe), begin, result](int ret) {
+        if (ret != 0) {
+            return;
+        }
+        if (searchCache_) {
+            searchCache_->insert(key, db, coll, version, appendedDocuments(*result, begin), result->warning);
+        }
+        if (probe && result->documents.size() == begin + 1) {
+            semanticCache_->insert(*probe, result->documents[begin], result->warning);
+        }
+    };
+    return false;
+}
+
+int RpcClient::count(const std::string& dbName, const std::string& collectionName,
+    const Filter* filter, CountResult* result, int timeout) {
+    ScopedArena arena;
+    olama::CountRequest& request = arena.create<olama::CountRequest>();
+    fillCountRequest(dbName, collectionName, filter, &request);
+
+    olama::CountResponse& response = arena.create<olama::CountResponse>();
+    grpc::Status status;
+    if (option_.hedging.enabled) {
+        status = invokeHedged(&olama::SearchEngine::Stub::PrepareAsynccount, request, &response, timeout, &countLatency_);
+    } else {
+        status = invoke(&olama::SearchEngine::Stub::count, request, &response, timeout);
+    }
+    return parseCountResponse(status, response, result);
+}
+
+void RpcClient::upsertAsync(const std::string& dbName, const std::string& collectionName,
+    const std::vector<Document>& documents, const UpsertDocumentParams* params, UpsertDocumentResult* result,
+    AsyncCallback callback, int timeout) {
+    std::vector<olama::UpsertRequest> requests;
+    fillUpsertRequests(dbName, collectionName, documents, params, option_.maxBatchBytes, &requests);
+    upsertBatches(std::move(requests), result, std::move(callback), timeout);
+}
+
+std::future<int> RpcClient::upsertAsync(const std::string& dbName, const std::string& collectionName,
+    const std::vector<Document>& documents, const UpsertDocumentParams* params, UpsertDocumentResult* result,
+    int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        upsertAsync(dbName, collectionName, documents, params, result, std::move(callback), timeout);
+    });
+}
+
+void RpcClient::upsertAsync(const std::string& dbName, const std::string& collectionName,
+    std::vector<Document>&& documents, const UpsertDocumentParams* params, UpsertDocumentResult* result,
+    AsyncCallback callback, int timeout) {
+    std::vector<olama::UpsertRequest> requests;
+    fillUpsertRequests(dbName, collectionName, std::move(documents), params, option_.maxBatchBytes, &requests);
+    upsertBatches(std::move(requests), result, std::move(callback), timeout);
+}
+
+std::future<int> RpcClient::upsertAsync(const std::string& dbName, const std::string& collectionName,
+    std::vector<Document>&& documents, const UpsertDocumentParams* params, UpsertDocumentResult* result,
+    int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        upsertAsync(dbName, collectionName, std::move(documents), params, result, std::move(callback), timeout);
+    });
+}
+
+void RpcClient::upsertAsync(const std::string& dbName, const std::string& collectionName,
+    IdSpan ids, const VectorMatrixView& vectors,
+    const std::vector<std::unordered_map<std::string, Field>>* fields, const UpsertDocumentParams* params,
+    UpsertDocumentResult* result, AsyncCallback callback, int timeout) {
+    std::vector<olama::UpsertRequest> requests;
+    if (fillUpsertRequests(dbName, collectionName, ids, vectors, fields, params, option_.maxBatchBytes,
+        &requests, result) != 0) {
+        callback(-1);
+        return;
+    }
+    upsertBatches(std::move(requests), result, std::move(callback), timeout);
+}
+
+std::future<int> RpcClient::upsertAsync(const std::string& dbName, const std::string& collectionName,
+    IdSpan ids, const VectorMatrixView& vectors,
+    const std::vector<std::unordered_map<std::string, Field>>* fields, const UpsertDocumentParams* params,
+    UpsertDocumentResult* result, int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        upsertAsync(dbName, collectionName, ids, vectors, fields, params, result, std::move(callback), timeout);
+    });
+}
+
+void RpcClient::upsertAsync(const olama::UpsertRequest& request, UpsertDocumentResult* result,
+    AsyncCallback callback, int timeout) {
+    sendUpsert(request, result, std::move(callback), timeout, false);
+}
+
+void RpcClient::sendUpsert(const olama::UpsertRequest& request, UpsertDocumentResult* result,
+    AsyncCallback callback, int timeout, bool waitForSlot) {
+    invalidateSearchCache(request.database(), request.collection());
+    invokeAsync<olama::UpsertRequest, olama::UpsertResponse>(&olama::SearchEngine::Stub::PrepareAsyncupsert,
+        request, timeout, [this, db = request.database(), coll = request.collection(), result, callback](
+            const grpc::Status& status, olama::UpsertResponse& response) {
+            invalidateSearchCache(db, coll);
+            callback(parseUpsertResponse(status, response, result));
+        }, nullptr, waitForSlot);
+}
+
+std::future<int> RpcClient::upsertAsync(const olama::UpsertRequest& request, UpsertDocumentResult* result,
+    int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        upsertAsync(request, result, std::move(callback), timeout);
+    });
+}
+
+void RpcClient::queryAsync(const std::string& dbName, const std::string& collectionName,
+    const std::vector<std::string>& documentIds, const QueryDocumentParams* params, QueryDocumentResult* result,
+    AsyncCallback callback, int timeout) {
+    ScopedArena arena;
+    olama::QueryRequest& request = arena.create<olama::QueryRequest>();
+    fillQueryRequest(dbName, collectionName, documentIds, params, option_.readConsistency, &request);
+    invokeAsync<olama::QueryRequest, olama::QueryResponse>(&olama::SearchEngine::Stub::PrepareAsyncquery,
+        request, timeout, [result, callback](const grpc::Status& status, olama::QueryResponse& response) {
+            callback(parseQueryResponse(status, response, result));
+        });
+}
+
+std::future<int> RpcClient::queryAsync(const std::string& dbName, const std::string& collectionName,
+    const std::vector<std::string>& documentIds, const QueryDocumentParams* params, QueryDocumentResult* result,
+    int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        queryAsync(dbName, collectionName, documentIds, params, result, std::move(callback), timeout);
+    });
+}
+
+void RpcClient::searchAsync(const std::string& dbName, const std::string& collectionName,
+    const std::vector<std::string>& documentIds, const std::vector<std::vector<float>>& vectors,
+    const std::map<std::string, std::vector<std::string>>& text,
+    const SearchDocumentParams* params, SearchDocumentResult* result, AsyncCallback callback, int timeout) {
+    if (checkRerank(params, result) != 0) {
+        callback(-1);
+        return;
+    }
+    if (params != nullptr && params->rerank) {
+        // 调用返回后params及vectors可能被释放, 重排所需的参数及检索向量随回调保存
+        std::vector<std::vector<float>> queries;
+        if (documentIds.empty() && text.empty()) {
+            queries = vectors;
+        }
+        callback = [queries = std::move(queries), rerank = *params->rerank, limit = params->limit,
+            retrieveVector = params->retrieveVector, begin = result->documents.size(), result,
+            callback = std::move(callback)](int ret) {
+            if (ret == 0) {
+                rerankSearchResult(querySpans(queries), rerank, limit, retrieveVector, begin, result);
+            }
+            callback(ret);
+        };
+    }
+    if (searchBatcher_ && documentIds.empty() && text.empty() && vectors.size() == 1) {
+        submitBatchedSearch(dbName, collectionName, vectors[0].data(), vectors[0].size(), params, result,
+            std::move(callback), timeout);
+        return;
+    }
+    ScopedArena arena;
+    olama::SearchRequest& request = arena.create<olama::SearchRequest>();
+    fillSearchRequest(dbName, collectionName, documentIds, vectors, text, params, option_.readConsistency, &request);
+    applyRerank(params, &request);
+    searchAsync(request, result, std::move(callback), timeout);
+}
+
+std::future<int> RpcClient::searchAsync(const std::string& dbName, const std::string& collectionName,
+    const std::vector<std::string>& documentIds, const std::vector<std::vector<float>>& vectors,
+    const std::map<std::string, std::vector<std::string>>& text,
+    const SearchDocumentParams* params, SearchDocumentResult* result, int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        searchAsync(dbName, collectionName, documentIds, vectors, text, params, result, std::move(callback), timeout);
+    });
+}
+
+void RpcClient::searchAsync(const std::string& dbName, const std::string& collectionName,
+    const VectorMatrixView& vectors, const SearchDocumentParams* params, SearchDocumentResult* result,
+    AsyncCallback callback, int timeout) {
+    if (checkMatrix(vectors, "search", result) != 0) {
+        callback(-1);
+        return;
+    }
+    if (checkRerank(params, result) != 0) {
+        callback(-1);
+        return;
+    }
+    if (params != nullptr && params->rerank) {
+        std::vector<std::vector<float>> queries(vectors.rows);
+        for (size_t i = 0; i < vectors.rows; ++i) {
+            queries[i].assign(vectors.row(i), vectors.row(i) + vectors.dim);
+        }
+        callback = [queries = std::move(queries), rerank = *params->rerank, limit = params->limit,
+            retrieveVector = params->retrieveVector, begin = result->documents.size(), result,
+            callback = std::move(callback)](int ret) {
+            if (ret == 0) {
+                rerankSearchResult(querySpans(queries), rerank, limit, retrieveVector, begin, result);
+            }
+            callback(ret);
+        };
+    }
+    if (searchBatcher_ && vectors.rows == 1) {
+        submitBatchedSearch(dbName, collectionName, vectors.row(0), vectors.dim, params, result, std::move(callback),
+            timeout);
+        return;
+    }
+    ScopedArena arena;
+    olama::SearchRequest& request = arena.create<olama::SearchRequest>();
+    fillSearchRequest(dbName, collectionName, vectors, params, option_.readConsistency, &request);
+    applyRerank(params, &request);
+    searchAsync(request, result, std::move(callback), timeout);
+}
+
+void RpcClient::submitBatchedSearch(const std::string& dbName, const std::string& collectionName,
+    const float* vector, size_t dim, const SearchDocumentParams* params, SearchDocumentResult* result,
+    AsyncCallback callback, int timeout) {
+    ScopedArena arena;
+    olama::SearchRequest& shape = arena.create<olama::SearchRequest>();
+    fillSearchParams(dbName, collectionName, params, option_.readConsistency, &shape);
+    applyRerank(params, &shape);
+    if (searchCache_ || semanticCache_) {
+        // 按单独发送时的请求查询缓存, 合并发送与否不影响命中
+        olama::SearchRequest& single = arena.create<olama::SearchRequest>();
+        single.CopyFrom(shape);
+        copyVector2Proto(vector, dim, single.mutable_search()->add_vectors()->mutable_vector());
+        AsyncCallback fillCache;
+        if (lookupSearchCache(single, result, &fillCache)) {
+            callback(0);
+            return;
+        }
+        if (fillCache) {
+            callback = [fillCache = std::move(fillCache), callback = std::move(callback)](int ret) {
+                fillCache(ret);
+                callback(ret);
+            };
+        }
+    }
+    searchBatcher_->submit(shape, vector, dim, timeout, result, std::move(callback));
+}
+
+std::future<int> RpcClient::searchAsync(const std::string& dbName, const std::string& collectionName,
+    const VectorMatrixView& vectors, const SearchDocumentParams* params, SearchDocumentResult* result,
+    int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        searchAsync(dbName, collectionName, vectors, params, result, std::move(callback), timeout);
+    });
+}
+
+void RpcClient::searchAsync(const olama::SearchRequest& request, SearchDocumentResult* result,
+    AsyncCallback callback, int timeout) {
+    AsyncCallback fillCache;
+    if (lookupSearchCache(request, result, &fillCache)) {
+        callback(0);
+        return;
+    }
+    if (fillCache) {
+        callback = [fillCache = std::move(fillCache), callback = std::move(callback)](int ret) {
+            fillCache(ret);
+            callback(ret);
+        };
+    }
+    sendSearchAsync(request, result, std::move(callback), timeout);
+}
+
+std::future<int> RpcClient::searchAsync(const std::string& dbName, const std::string& collectionName,
+    const VectorMatrixView& vectors, const SearchDocumentParams* params, SearchResultView* result, int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        searchAsync(dbName, collectionName, vectors, params, result, std::move(callback), timeout);
+    });
+}
+
+void RpcClient::searchAsync(const std::string& dbName, const std::string& collectionName,
+    const VectorMatrixView& vectors, const SearchDocumentParams* params, SearchResultView* result,
+    AsyncCallback callback, int timeout) {
+    if (checkMatrix(vectors, "search", result) != 0) {
+        callback(-1);
+        return;
+    }
+    if (rejectRerank(params, result) != 0) {
+        callback(-1);
+        return;
+    }
+    ScopedArena arena;
+    olama::SearchRequest& request = arena.create<olama::SearchRequest>();
+    fillSearchRequest(dbName, collectionName, vectors, params, option_.readConsistency, &request);
+    searchAsync(request, result, std::move(callback), timeout);
+}
+
+std::future<int> RpcClient::searchAsync(const olama::SearchRequest& request, SearchResultView* result,
+    int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        searchAsync(request, result, std::move(callback), timeout);
+    });
+}
+
+void RpcClient::searchAsync(const olama::SearchRequest& request, SearchResultView* result,
+    AsyncCallback callback, int timeout) {
+    google::protobuf::Arena* arena = result->reset();
+    invokeAsync<olama::SearchRequest, olama::SearchResponse>(&olama::SearchEngine::Stub::PrepareAsyncsearch,
+        request, timeout, [result, callback](const grpc::Status& status, olama::SearchResponse& response) {
+            callback(parseSearchResponse(status, response, result, &result->response_));
+        }, arena);
+}
+
+std::future<int> RpcClient::searchAsync(const std::string& dbName, const std::string& collectionName,
+    const VectorMatrixView& vectors, const SearchDocumentParams* params, ColumnarSearchResult* result,
+    int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        searchAsync(dbName, collectionName, vectors, params, result, std::move(callback), timeout);
+    });
+}
+
+void RpcClient::searchAsync(const std::string& dbName, const std::string& collectionName,
+    const VectorMatrixView& vectors, const SearchDocumentParams* params, ColumnarSearchResult* result,
+    AsyncCallback callback, int timeout) {
+    if (checkMatrix(vectors, "search", result) != 0) {
+        callback(-1);
+        return;
+    }
+    if (rejectRerank(params, result) != 0) {
+        callback(-1);
+        return;
+    }
+    ScopedArena arena;
+    olama::SearchRequest& request = arena.create<olama::SearchRequest>();
+    fillSearchRequest(dbName, collectionName, vectors, params, option_.readConsistency, &request);
+    searchAsync(request, result, std::move(callback), timeout);
+}
+
+std::future<int> RpcClient::searchAsync(const olama::SearchRequest& request, ColumnarSearchResult* result,
+    int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        searchAsync(request, result, std::move(callback), timeout);
+    });
+}
+
+void RpcClient::searchAsync(const olama::SearchRequest& request, ColumnarSearchResult* result,
+    AsyncCallback callback, int timeout) {
+    const auto& outputFields = request.search().outputfields();
+    invokeAsync<olama::SearchRequest, olama::SearchResponse>(&olama::SearchEngine::Stub::PrepareAsyncsearch,
+        request, timeout, [columns = std::vector<std::string>(outputFields.begin(), outputFields.end()), result,
+            callback](const grpc::Status& status, olama::SearchResponse& response) {
+            callback(parseSearchResponse(status, response, columns, result));
+        });
+}
+
+void RpcClient::sendSearchAsync(const olama::SearchRequest& request, SearchDocumentResult* result,
+    AsyncCallback callback, int timeout) {
+    invokeAsync<olama::SearchRequest, olama::SearchResponse>(&olama::SearchEngine::Stub::PrepareAsyncsearch,
+        request, timeout, [result, callback](const grpc::Status& status, olama::SearchResponse& response) {
+            callback(parseSearchResponse(status, response, result));
+        });
+}
+
+std::future<int> RpcClient::searchAsync(const olama::SearchRequest& request, SearchDocumentResult* result,
+    int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        searchAsync(request, result, std::move(callback), timeout);
+    });
+}
+
+void RpcClient::deleAsync(const std::string& dbName, const std::string& collectionName,
+    const DeleteDocumentParams* params, DeleteDocumentResult* result, AsyncCallback callback, int timeout) {
+    ScopedArena arena;
+    olama::DeleteRequest& request = arena.create<olama::DeleteRequest>();
+    fillDeleteRequest(dbName, collectionName, params, &request);
+    invalidateSearchCache(dbName, collectionName);
+    invokeAsync<olama::DeleteRequest, olama::DeleteResponse>(&olama::SearchEngine::Stub::PrepareAsyncdele,
+        request, timeout, [this, dbName, collectionName, result, callback](const grpc::Status& status,
+            olama::DeleteResponse& response) {
+            invalidateSearchCache(dbName, collectionName);
+            callback(parseDeleteResponse(status, response, result));
+        });
+}
+
+std::future<int> RpcClient::deleAsync(const std::string& dbName, const std::string& collectionName,
+    const DeleteDocumentParams* params, DeleteDocumentResult* result, int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        deleAsync(dbName, collectionName, params, result, std::move(callback), timeout);
+    });
+}
+
+void RpcClient::updateAsync(const std::string& dbName, const std::string& collectionName,
+    const UpdateDocumentParams* params, UpdateDocumentResult* result, AsyncCallback callback, int timeout) {
+    ScopedArena arena;
+    olama::UpdateRequest& request = arena.create<olama::UpdateRequest>();
+    fillUpdateRequest(dbName, collectionName, params, &request);
+    invalidateSearchCache(dbName, collectionName);
+    invokeAsync<olama::UpdateRequest, olama::UpdateResponse>(&olama::SearchEngine::Stub::PrepareAsyncupdate,
+        request, timeout, [this, dbName, collectionName, result, callback](const grpc::Status& status,
+            olama::UpdateResponse& response) {
+            invalidateSearchCache(dbName, collectionName);
+            callback(parseUpdateResponse(status, response, result));
+        });
+}
+
+std::future<int> RpcClient::updateAsync(const std::string& dbName, const std::string& collectionName,
+    const UpdateDocumentParams* params, UpdateDocumentResult* result, int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        updateAsync(dbName, collectionName, params, result, std::move(callback), timeout);
+    });
+}
+
+void RpcClient::countAsync(const std::string& dbName, const std::string& collectionName,
+    const Filter* filter, CountResult* result, AsyncCallback callback, int timeout) {
+    ScopedArena arena;
+    olama::CountRequest& request = arena.create<olama::CountRequest>();
+    fillCountRequest(dbName, collectionName, filter, &request);
+    invokeAsync<olama::CountRequest, olama::CountResponse>(&olama::SearchEngine::Stub::PrepareAsynccount,
+        request, timeout, [result, callback](const grpc::Status& status, olama::CountResponse& response) {
+            callback(parseCountResponse(status, response, result));
+        });
+}
+
+std::future<int> RpcClient::countAsync(const std::string& dbName, const std::string& collectionName,
+    const Filter* filter, CountResult* result, int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        countAsync(dbName, collectionName, filter, result, std::move(callback), timeout);
+    });
+}
+
+void RpcClient::upsertBatches(std::vector<olama::UpsertRequest>&& requests, UpsertDocumentResult* result,
+    AsyncCallback callback, int timeout) {
+    if (requests.size() == 1) {
+        upsertAsync(requests[0], result, std::move(callback), timeout);
+        return;
+    }
+    auto state = std::make_shared<UpsertBatchState>();
+    state->requests = std::move(requests);
+    state->result = result;
+    state->callback = std::move(callback);
+    state->timeout = timeout;
+    // 子请求属于同一集合, 首个子请求发出前和最后一个完成后各失效一次缓存
+    state->database = state->requests[0].database();
+    state->collection = state->requests[0].collection();
+    invalidateSearchCache(state->database, state->collection);
+    size_t window = std::min(state->requests.size(), static_cast<size_t>(std::max(1, option_.maxBatchParallelism)));
+    for (size_t i = 0; i < window; ++i) {
+        sendUpsertBatch(state);
+    }
+}
+
+void RpcClient::sendUpsertBatch(const std::shared_ptr<UpsertBatchState>& state) {
+    size_t index;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->failed || state->next == state->requests.size()) {
+            return;
+        }
+        index = state->next++;
+        ++state->inFlight;
+    }
+    invokeAsync<olama::UpsertRequest, olama::UpsertResponse>(&olama::SearchEngine::Stub::PrepareAsyncupsert,
+        state->requests[index], state->timeout,
+        [this, state](const grpc::Status& status, olama::UpsertResponse& response) {
+            UpsertDocumentResult batch;
+            int ret = parseUpsertResponse(status, response, &batch);
+            bool finished;
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                --state->inFlight;
+                if (state->warning.empty()) {
+                    state->warning = batch.warning;
+                }
+                if (ret == 0) {
+                    ++state->succeeded;
+                    state->affectedCount += batch.affectedCount;
+                } else if (!state->failed) {
+                    // 首个失败后不再发送剩余的子请求
+                    state->failed = true;
+                    state->message = batch.message;
+                    state->code = batch.code;
+                    state->statusCode = batch.statusCode;
+                }
+                finished = state->inFlight == 0 && (state->failed || state->next == state->requests.size());
+            }
+            if (state->waitForSlot) {
+                state->windowAvailable.notify_all();
+            }
+            if (!finished) {
+                if (!state->waitForSlot) {
+                    sendUpsertBatch(state);
+                }
+                return;
+            }
+            invalidateSearchCache(state->database, state->collection);
+            UpsertDocumentResult* result = state->result;
+            result->affectedCount = state->affectedCount;
+            result->warning = state->warning;
+            result->code = state->code;
+            result->statusCode = state->statusCode;
+            if (state->failed) {
+                result->success = false;
+                result->message = state->message + " (" + std::to_string(state->succeeded) + "/" +
+                    std::to_string(state->requests.size()) + " batches succeeded)";
+                state->callback(-1);
+            } else {
+                result->success = true;
+                result->message.clear();
+                state->callback(0);
+            }
+        }, nullptr, state->waitForSlot);
+    // 请求在发起时已完成序列化, 释放子请求占用的内存
+    olama::UpsertRequest().Swap(&state->requests[index]);
+}
+
 }  // namespace vectordb
@@ -27,25 +27,26 @@
 */
 
 #include "include/rpc_client.h"
+#include "include/rpc_invoke.h"
+#include "include/scoped_arena.h"
 #include "include/types/index.h"
 
 namespace vectordb {
 
-int RpcClient::rebuildIndex(const std::string& dbName, const std::string& collectionName,
-    const RebuildIndexParams* params, RebuildIndexResult* result, int timeout) {
-    olama::RebuildIndexRequest request;
-    request.set_database(dbName);
-    request.set_collection(collectionName);
+namespace {
+
+void fillRebuildIndexRequest(const std::string& dbName, const std::string& collectionName,
+    const RebuildIndexParams* params, olama::RebuildIndexRequest* request) {
+    request->set_database(dbName);
+    request->set_collection(collectionName);
     if (params != nullptr) {
-        request.set_dropbeforerebuild(params->dropBeforeRebuild);
-        request.set_throttle(static_cast<int32_t>(params->throttle));
+        request->set_dropbeforerebuild(params->dropBeforeRebuild);
+        request->set_throttle(static_cast<int32_t>(params->throttle));
     }
-    grpc::ClientContext context;
-    std::chrono::system_clock::time_point deadline = std::chrono::system_clock::now() +
-        std::chrono::milliseconds(timeout);
-    context.set_deadline(deadline);
-    olama::RebuildIndexResponse response;
-    grpc::Status status = stub_->rebuildIndex(&context, request, &response);
+}
+
+int parseRebuildIndexResponse(const grpc::Status& status, const olama::RebuildIndexResponse& response,
+    RebuildIndexResult* result) {
     if (!status.ok()) {
         result->success = false;
         result->message = "Fail to rebuild index: " + status.error_message();
@@ -62,4 +63,35 @@ int RpcClient::rebuildIndex(const std::string& dbName, const std::string& collec
     return 0;
 }
 
+}  // namespace
+
+int RpcClient::rebuildIndex(const std::string& dbName, const std::string& collectionName,
+    const RebuildIndexParams* params, RebuildIndexResult* result, int timeout) {
+    ScopedArena arena;
+    olama::RebuildIndexRequest& request = arena.create<olama::RebuildIndexRequest>();
+    fillRebuildIndexRequest(dbName, collectionName, params, &request);
+    olama::RebuildIndexResponse& response = arena.create<olama::RebuildIndexResponse>();
+    grpc::Status status = invoke(&olama::SearchEngine::Stub::rebuildIndex, request, &response, timeout);
+    return parseRebuildIndexResponse(status, response, result);
+}
+
+void RpcClient::rebuildIndexAsync(const std::string& dbName, const std::string& collectionName,
+    const RebuildIndexParams* params, RebuildIndexResult* result, AsyncCallback callback, int timeout) {
+    ScopedArena arena;
+    olama::RebuildIndexRequest& request = arena.create<olama::RebuildIndexRequest>();
+    fillRebuildIndexRequest(dbName, collectionName, params, &request);
+    invokeAsync<olama::RebuildIndexRequest, olama::RebuildIndexResponse>(
+        &olama::SearchEngine::Stub::PrepareAsyncrebuildIndex, request, timeout,
+        [result, callback](const grpc::Status& status, olama::RebuildIndexResponse& response) {
+            callback(parseRebuildIndexResponse(status, response, result));
+        });
+}
+
+std::future<int> RpcClient::rebuildIndexAsync(const std::string& dbName, const std::string& collectionName,
+    const RebuildIndexParams* params, RebuildIndexResult* result, int timeout) {
+    return toFuture([&](AsyncCallback callback) {
+        rebuildIndexAsync(dbName, collectionName, params, result, std::move(callback), timeout);
+    });
+}
+
 }  // namespace vectordb
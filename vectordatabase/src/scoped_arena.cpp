@@ -0,0 +1,112 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <memory>
+
+#include "include/scoped_arena.h"
+
+namespace vectordb {
+
+namespace {
+
+constexpr size_t kInitialBlockSize = 64 * 1024;
+
+struct ThreadBlock {
+    std::unique_ptr<char[]> data;
+    size_t size = 0;
+    // 下次借用时期望的大小, 用量超出时增长, 长期用不满时缩小
+    size_t wanted = kInitialBlockSize;
+    // 连续用量不到缓存块1/4的调用数, 及其中的最大用量
+    int smallCalls = 0;
+    size_t smallPeak = 0;
+    bool inUse = false;
+};
+
+thread_local ThreadBlock threadBlock;
+
+}  // namespace
+
+ScopedArena::ScopedArena() : arena_(borrowOptions(&borrowed_)) {}
+
+ScopedArena::~ScopedArena() {
+    if (borrowed_) {
+        ThreadBlock& block = threadBlock;
+        size_t allocated = static_cast<size_t>(arena_.SpaceAllocated());
+        size_t used = static_cast<size_t>(arena_.SpaceUsed());
+        if (allocated > block.wanted) {
+            block.wanted = std::min(kMaxCachedBlockSize, allocated);
+            block.smallCalls = 0;
+            block.smallPeak = 0;
+        } else if (used * 4 < block.size) {
+            block.smallPeak = std::max(block.smallPeak, used);
+            if (++block.smallCalls >= kShrinkAfterCalls) {
+                block.wanted = std::max(kInitialBlockSize, block.smallPeak * 2);
+                block.smallCalls = 0;
+                block.smallPeak = 0;
+            }
+        } else {
+            block.smallCalls = 0;
+            block.smallPeak = 0;
+        }
+        // arena_在析构函数体之后才释放内存, 其间本线程不会再借用该内存块
+        block.inUse = false;
+    }
+}
+
+void ScopedArena::releaseThreadCache() {
+    ThreadBlock& block = threadBlock;
+    if (block.inUse) {
+        return;
+    }
+    block.data.reset();
+    block.size = 0;
+    block.wanted = kInitialBlockSize;
+    block.smallCalls = 0;
+    block.smallPeak = 0;
+}
+
+google::protobuf::ArenaOptions ScopedArena::borrowOptions(bool* borrowed) {
+    google::protobuf::ArenaOptions options;
+    ThreadBlock& block = threadBlock;
+    if (block.inUse) {
+        *borrowed = false;
+        return options;
+    }
+    if (block.size != block.wanted) {
+        block.data.reset(new char[block.wanted]);
+        block.size = block.wanted;
+    }
+    block.inUse = true;
+    *borrowed = true;
+    options.initial_block = block.data.get();
+    options.initial_block_size = block.size;
+    return options;
+}
+
+}  // namespace vectordb
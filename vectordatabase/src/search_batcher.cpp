@@ -0,0 +1,160 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <utility>
+
+#include "include/helper.h"
+#include "include/search_batcher.h"
+
+namespace vectordb {
+
+SearchBatcher::SearchBatcher(const SearchBatchingPolicy& policy, SendFunction send)
+    : policy_(policy), send_(std::move(send)) {
+    policy_.maxBatch = std::max(1, policy_.maxBatch);
+    policy_.maxDelayUs = std::max(0, policy_.maxDelayUs);
+    timer_ = std::thread(&SearchBatcher::timerLoop, this);
+}
+
+SearchBatcher::~SearchBatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    timerCv_.notify_all();
+    timer_.join();
+    std::unique_lock<std::mutex> lock(mutex_);
+    idleCv_.wait(lock, [this] { return inFlight_ == 0; });
+}
+
+void SearchBatcher::submit(const olama::SearchRequest& shape, const float* vector, size_t dim, int timeout,
+    SearchDocumentResult* result, std::function<void(int)> callback) {
+    // 向量维度及超时时间不在shape中, 一并作为key的一部分
+    std::string key = shape.SerializeAsString();
+    key.append(reinterpret_cast<const char*>(&dim), sizeof(dim));
+    key.append(reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+
+    std::unique_ptr<Batch> full;
+    bool created = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::unique_ptr<Batch>& batch = pending_[key];
+        if (!batch) {
+            batch = std::make_unique<Batch>();
+            batch->request = shape;
+            batch->timeout = timeout;
+            batch->deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(policy_.maxDelayUs);
+            batch->request.mutable_search()->mutable_vectors()->Reserve(policy_.maxBatch);
+            created = true;
+        }
+        copyVector2Proto(vector, dim, batch->request.mutable_search()->add_vectors()->mutable_vector());
+        batch->results.push_back(result);
+        batch->callbacks.push_back(std::move(callback));
+        ++stats_.searches;
+        if (batch->results.size() >= static_cast<size_t>(policy_.maxBatch) || stopped_) {
+            full = std::move(batch);
+            pending_.erase(key);
+            ++inFlight_;
+            ++stats_.batches;
+        }
+    }
+    if (full) {
+        send(std::move(full));
+    } else if (created) {
+        timerCv_.notify_one();
+    }
+}
+
+void SearchBatcher::send(std::unique_ptr<Batch> batch) {
+    std::shared_ptr<Batch> sent(std::move(batch));
+    auto batchResult = std::make_shared<SearchDocumentResult>();
+    send_(sent->request, sent->timeout, batchResult.get(), [this, sent, batchResult](int ret) {
+        // 结果按向量在请求中的顺序返回
+        for (size_t i = 0; i < sent->results.size(); ++i) {
+            SearchDocumentResult* result = sent->results[i];
+            result->warning = batchResult->warning;
+            result->message = batchResult->message;
+            int status = ret;
+            if (ret == 0 && i >= batchResult->documents.size()) {
+                status = -1;
+                result->message = "Fail to search documents: missing result of batched search";
+            }
+            result->success = status == 0;
+            if (status == 0) {
+                result->documents.push_back(std::move(batchResult->documents[i]));
+            }
+            sent->callbacks[i](status);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        --inFlight_;
+        idleCv_.notify_all();
+    });
+}
+
+void SearchBatcher::timerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        if (pending_.empty()) {
+            if (stopped_) {
+                return;
+            }
+            timerCv_.wait(lock);
+            continue;
+        }
+        auto now = std::chrono::steady_clock::now();
+        auto earliest = std::chrono::steady_clock::time_point::max();
+        std::vector<std::unique_ptr<Batch>> expired;
+        for (auto it = pending_.begin(); it != pending_.end();) {
+            if (stopped_ || it->second->deadline <= now) {
+                expired.push_back(std::move(it->second));
+                it = pending_.erase(it);
+            } else {
+                earliest = std::min(earliest, it->second->deadline);
+                ++it;
+            }
+        }
+        if (expired.empty()) {
+            timerCv_.wait_until(lock, earliest);
+            continue;
+        }
+        inFlight_ += static_cast<int>(expired.size());
+        stats_.batches += static_cast<int64_t>(expired.size());
+        lock.unlock();
+        for (auto& batch : expired) {
+            send(std::move(batch));
+        }
+        lock.lock();
+    }
+}
+
+SearchBatchStats SearchBatcher::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+}  // namespace vectordb
@@ -0,0 +1,229 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include "include/search_cache.h"
+
+namespace vectordb {
+
+namespace {
+
+// 容器及堆分配的估算开销
+constexpr size_t kNodeOverhead = 32;
+
+size_t estimateBytes(const Field& field) {
+    size_t bytes = sizeof(Field);
+    if (field.hasValStr()) {
+        bytes += std::get<std::string>(field.oneofVal).size();
+    } else if (field.hasValStrArr()) {
+        for (const auto& str : std::get<std::vector<std::string>>(field.oneofVal)) {
+            bytes += sizeof(std::string) + str.size();
+        }
+    }
+    return bytes;
+}
+
+size_t estimateBytes(const std::vector<std::vector<Document>>& documents) {
+    size_t bytes = 0;
+    for (const auto& docs : documents) {
+        bytes += sizeof(docs);
+        for (const auto& doc : docs) {
+            bytes += sizeof(Document) + doc.id.size() + doc.vector.size() * sizeof(float);
+            for (const auto& [name, field] : doc.fields) {
+                bytes += kNodeOverhead + name.size() + estimateBytes(field);
+            }
+        }
+    }
+    return bytes;
+}
+
+std::string collectionKey(const std::string& dbName, const std::string& collectionName) {
+    std::string key;
+    key.reserve(dbName.size() + 1 + collectionName.size());
+    key.append(dbName).append(1, '/').append(collectionName);
+    return key;
+}
+
+}  // namespace
+
+uint64_t CollectionVersions::version(const std::string& dbName, const std::string& collectionName) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t version = 0;
+    auto coll = collections_.find(collectionKey(dbName, collectionName));
+    if (coll != collections_.end()) {
+        version += coll->second;
+    }
+    auto db = databases_.find(dbName);
+    if (db != databases_.end()) {
+        version += db->second;
+    }
+    return version;
+}
+
+void CollectionVersions::bump(const std::string& dbName, const std::string& collectionName) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++collections_[collectionKey(dbName, collectionName)];
+}
+
+void CollectionVersions::bump(const std::string& dbName) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++databases_[dbName];
+}
+
+SearchResultCache::SearchResultCache(const SearchCachePolicy& policy) : policy_(policy) {
+    policy_.shards = std::max(1, policy_.shards);
+    shardBytes_ = policy_.maxBytes / policy_.shards;
+    shards_.reserve(policy_.shards);
+    for (int i = 0; i < policy_.shards; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+}
+
+std::string SearchResultCache::key(const olama::SearchRequest& request) {
+    // SearchRequest中没有map字段, 相同的请求序列化结果相同
+    return request.SerializeAsString();
+}
+
+SearchResultCache::Shard& SearchResultCache::shard(const std::string& key) {
+    return *shards_[std::hash<std::string>()(key) % shards_.size()];
+}
+
+uint64_t SearchResultCache::version(const std::string& dbName, const std::string& collectionName) {
+    return versions_.version(dbName, collectionName);
+}
+
+void SearchResultCache::erase(Shard& shard, std::list<Entry>::iterator it) {
+    shard.bytes -= it->bytes;
+    shard.index.erase(it->key);
+    shard.lru.erase(it);
+}
+
+bool SearchResultCache::lookup(const std::string& key, const std::string& dbName,
+    const std::string& collectionName, SearchDocumentResult* result) {
+    uint64_t current = version(dbName, collectionName);
+    Shard& s = shard(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto found = s.index.find(key);
+    if (found == s.index.end()) {
+        ++s.stats.misses;
+        return false;
+    }
+    auto it = found->second;
+    if (it->version != current) {
+        ++s.stats.invalidations;
+        ++s.stats.misses;
+        erase(s, it);
+        return false;
+    }
+    if (policy_.ttl > 0 && std::chrono::steady_clock::now() >= it->expire) {
+        ++s.stats.expirations;
+        ++s.stats.misses;
+        erase(s, it);
+        return false;
+    }
+    s.lru.splice(s.lru.begin(), s.lru, it);
+    ++s.stats.hits;
+    result->documents.insert(result->documents.end(), it->documents.begin(), it->documents.end());
+    result->warning = it->warning;
+    result->success = true;
+    result->message.clear();
+    return true;
+}
+
+void SearchResultCache::insert(const std::string& key, const std::string& dbName,
+    const std::string& collectionName, uint64_t version, std::vector<std::vector<Document>> documents,
+    const std::string& warning) {
+    // 检索期间集合有写操作, 结果可能已过时
+    if (version != this->version(dbName, collectionName)) {
+        return;
+    }
+    size_t bytes = sizeof(Entry) + kNodeOverhead + key.size() * 2 + warning.size() + estimateBytes(documents);
+    if (bytes > shardBytes_) {
+        return;
+    }
+    Shard& s = shard(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto found = s.index.find(key);
+    if (found != s.index.end()) {
+        erase(s, found->second);
+    }
+    while (!s.lru.empty() && s.bytes + bytes > shardBytes_) {
+        ++s.stats.evictions;
+        erase(s, std::prev(s.lru.end()));
+    }
+    s.lru.emplace_front();
+    Entry& entry = s.lru.front();
+    entry.key = key;
+    entry.version = version;
+    entry.expire = std::chrono::steady_clock::now() + std::chrono::milliseconds(policy_.ttl);
+    entry.bytes = bytes;
+    entry.documents = std::move(documents);
+    entry.warning = warning;
+    s.index.emplace(entry.key, s.lru.begin());
+    s.bytes += bytes;
+    ++s.stats.inserts;
+}
+
+void SearchResultCache::invalidate(const std::string& dbName, const std::string& collectionName) {
+    // 只增加版本号, 旧条目在下次访问或被LRU淘汰时释放
+    versions_.bump(dbName, collectionName);
+}
+
+void SearchResultCache::invalidate(const std::string& dbName) {
+    versions_.bump(dbName);
+}
+
+void SearchResultCache::clear() {
+    for (auto& s : shards_) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        s->lru.clear();
+        s->index.clear();
+        s->bytes = 0;
+    }
+}
+
+SearchCacheStats SearchResultCache::stats() {
+    SearchCacheStats total;
+    for (auto& s : shards_) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        total.hits += s->stats.hits;
+        total.misses += s->stats.misses;
+        total.inserts += s->stats.inserts;
+        total.evictions += s->stats.evictions;
+        total.expirations += s->stats.expirations;
+        total.invalidations += s->stats.invalidations;
+        total.entries += s->lru.size();
+        total.bytes += s->bytes;
+    }
+    return total;
+}
+
+}  // namespace vectordb
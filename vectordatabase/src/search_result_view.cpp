@@ -0,0 +1,83 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <utility>
+
+#include "include/helper.h"
+#include "include/search_result_view.h"
+
+namespace vectordb {
+
+bool DocumentView::field(const std::string& name, Field* field) const {
+    auto it = document_->fields().find(name);
+    if (it == document_->fields().end()) {
+        return false;
+    }
+    convertProto2Field(it->second, field);
+    return true;
+}
+
+Document DocumentView::toDocument() const {
+    Document document;
+    document.id = document_->id();
+    document.vector.assign(document_->vector().begin(), document_->vector().end());
+    document.score = document_->score();
+    for (const auto& [key, value] : document_->fields()) {
+        convertProto2Field(value, &document.fields[key]);
+    }
+    return document;
+}
+
+void SearchResultView::toResult(SearchDocumentResult* result) const {
+    result->success = success;
+    result->message = message;
+    if (!response_) {
+        return;
+    }
+    result->warning = response_->warning();
+    for (const auto& resultSet : response_->results()) {
+        std::vector<Document> documents;
+        documents.reserve(resultSet.documents_size());
+        for (const auto& document : resultSet.documents()) {
+            documents.push_back(DocumentView(document).toDocument());
+        }
+        result->documents.push_back(std::move(documents));
+    }
+}
+
+google::protobuf::Arena* SearchResultView::reset() {
+    response_ = nullptr;
+    if (arena_) {
+        arena_->Reset();
+    } else {
+        arena_ = std::make_unique<google::protobuf::Arena>();
+    }
+    return arena_.get();
+}
+
+}  // namespace vectordb
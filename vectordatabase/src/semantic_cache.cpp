@@ -0,0 +1,285 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+
+#include "include/semantic_cache.h"
+
+namespace vectordb {
+
+namespace {
+
+float dot(const float* a, const float* b, size_t dim) {
+    float sum = 0;
+    for (size_t i = 0; i < dim; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+float inverseNorm(const float* vector, size_t dim) {
+    float norm = std::sqrt(dot(vector, vector, dim));
+    return norm > 0 ? 1.0f / norm : 0.0f;
+}
+
+float squaredL2(const float* a, const float* b, size_t dim) {
+    float sum = 0;
+    for (size_t i = 0; i < dim; ++i) {
+        float d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+std::string groupKey(const olama::SearchRequest& request, size_t dim) {
+    olama::SearchRequest shape;
+    shape.CopyFrom(request);
+    shape.mutable_search()->clear_vectors();
+    std::string key = shape.SerializeAsString();
+    key.append(reinterpret_cast<const char*>(&dim), sizeof(dim));
+    return key;
+}
+
+}  // namespace
+
+SemanticSearchCache::SemanticSearchCache(const SemanticCachePolicy& policy) : policy_(policy) {
+    policy_.maxEntries = std::max(1, policy_.maxEntries);
+    policy_.maxGroups = std::max(1, policy_.maxGroups);
+    policy_.hashBits = std::min(24, std::max(1, policy_.hashBits));
+}
+
+bool SemanticSearchCache::cacheable(const olama::SearchRequest& request) {
+    const olama::SearchCond& search = request.search();
+    return search.vectors_size() == 1 && search.vectors(0).vector_size() > 0 && search.documentids_size() == 0 &&
+        search.embeddingitems_size() == 0;
+}
+
+std::shared_ptr<SemanticSearchCache::Group> SemanticSearchCache::group(const std::string& key, size_t dim,
+    bool create) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = groups_.find(key);
+    if (it != groups_.end()) {
+        return it->second;
+    }
+    if (!create) {
+        return nullptr;
+    }
+    if (groups_.size() >= static_cast<size_t>(policy_.maxGroups)) {
+        groups_.erase(groups_.begin());
+    }
+    auto g = std::make_shared<Group>();
+    g->dim = dim;
+    // 相同维度的分组使用相同的超平面
+    std::mt19937 rng(static_cast<uint32_t>(dim));
+    std::normal_distribution<float> normal;
+    g->planes.resize(policy_.hashBits * dim);
+    for (auto& value : g->planes) {
+        value = normal(rng);
+    }
+    groups_.emplace(key, g);
+    return g;
+}
+
+uint32_t SemanticSearchCache::signature(const Group& group, const float* vector) const {
+    uint32_t signature = 0;
+    for (int i = 0; i < policy_.hashBits; ++i) {
+        if (dot(group.planes.data() + i * group.dim, vector, group.dim) >= 0) {
+            signature |= 1u << i;
+        }
+    }
+    return signature;
+}
+
+const SemanticSearchCache::Entry* SemanticSearchCache::nearest(Group& group, const float* vector,
+    uint64_t version) const {
+    uint32_t sig = signature(group, vector);
+    float invNorm = inverseNorm(vector, group.dim);
+    auto now = std::chrono::steady_clock::now();
+    const Entry* best = nullptr;
+    float bestScore = 0;
+    // 检查签名相同及相差1位的桶
+    for (int bit = -1; bit < policy_.hashBits; ++bit) {
+        auto bucket = group.buckets.find(bit < 0 ? sig : sig ^ (1u << bit));
+        if (bucket == group.buckets.end()) {
+            continue;
+        }
+        for (size_t index : bucket->second) {
+            const Entry& entry = group.entries[index];
+            if (entry.version != version || (policy_.ttl > 0 && now >= entry.expire)) {
+                continue;
+            }
+            float score;
+            bool matched;
+            if (policy_.metric == SemanticMetric::kCosine) {
+                score = dot(vector, entry.vector.data(), group.dim) * invNorm * entry.invNorm;
+                matched = score >= policy_.threshold;
+            } else {
+                // 以负的距离作为分数, 越大越接近
+                score = -squaredL2(vector, entry.vector.data(), group.dim);
+                matched = -score <= policy_.threshold * policy_.threshold;
+            }
+            if (matched && (best == nullptr || score > bestScore)) {
+                best = &entry;
+                bestScore = score;
+            }
+        }
+    }
+    return best;
+}
+
+bool SemanticSearchCache::sampleVerify() {
+    if (policy_.verifyRate <= 0) {
+        return false;
+    }
+    if (policy_.verifyRate >= 1) {
+        return true;
+    }
+    thread_local std::mt19937_64 rng(std::random_device{}());
+    return std::uniform_real_distribution<double>(0, 1)(rng) < policy_.verifyRate;
+}
+
+bool SemanticSearchCache::lookup(const olama::SearchRequest& request, SearchDocumentResult* result,
+    SemanticCacheProbe* probe) {
+    ++lookups_;
+    const auto& vector = request.search().vectors(0).vector();
+    size_t dim = vector.size();
+    probe->group = groupKey(request, dim);
+    probe->dbName = request.database();
+    probe->collectionName = request.collection();
+    probe->version = versions_.version(probe->dbName, probe->collectionName);
+    probe->vector.assign(vector.begin(), vector.end());
+
+    std::shared_ptr<Group> g = group(probe->group, dim, false);
+    if (!g) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(g->mutex);
+    const Entry* entry = nearest(*g, probe->vector.data(), probe->version);
+    if (entry == nullptr) {
+        return false;
+    }
+    if (sampleVerify()) {
+        ++verifications_;
+        probe->verify = true;
+        probe->cached = entry->documents;
+        return false;
+    }
+    ++hits_;
+    result->documents.push_back(entry->documents);
+    result->warning = entry->warning;
+    result->success = true;
+    result->message.clear();
+    return true;
+}
+
+void SemanticSearchCache::insert(const SemanticCacheProbe& probe, const std::vector<Document>& documents,
+    const std::string& warning) {
+    if (probe.verify) {
+        size_t ranks = std::min(probe.cached.size(), documents.size());
+        if (ranks > 0) {
+            double drift = 0;
+            for (size_t i = 0; i < ranks; ++i) {
+                drift = std::max(drift, static_cast<double>(std::fabs(probe.cached[i].score - documents[i].score)));
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            maxScoreDrift_ = std::max(maxScoreDrift_, drift);
+            totalScoreDrift_ += drift;
+            ++driftSamples_;
+        }
+    }
+    // 检索期间集合有写操作, 结果可能已过时
+    if (probe.version != versions_.version(probe.dbName, probe.collectionName)) {
+        return;
+    }
+    std::shared_ptr<Group> g = group(probe.group, probe.vector.size(), true);
+    std::lock_guard<std::mutex> lock(g->mutex);
+    size_t index;
+    if (g->entries.size() < static_cast<size_t>(policy_.maxEntries)) {
+        index = g->entries.size();
+        g->entries.emplace_back();
+    } else {
+        index = g->next;
+        g->next = (g->next + 1) % g->entries.size();
+        auto& bucket = g->buckets[g->entries[index].signature];
+        bucket.erase(std::find(bucket.begin(), bucket.end(), index));
+        if (bucket.empty()) {
+            g->buckets.erase(g->entries[index].signature);
+        }
+    }
+    Entry& entry = g->entries[index];
+    entry.vector = probe.vector;
+    entry.invNorm = inverseNorm(entry.vector.data(), g->dim);
+    entry.signature = signature(*g, entry.vector.data());
+    entry.version = probe.version;
+    entry.expire = std::chrono::steady_clock::now() + std::chrono::milliseconds(policy_.ttl);
+    entry.documents = documents;
+    entry.warning = warning;
+    g->buckets[entry.signature].push_back(index);
+    ++inserts_;
+}
+
+void SemanticSearchCache::invalidate(const std::string& dbName, const std::string& collectionName) {
+    versions_.bump(dbName, collectionName);
+}
+
+void SemanticSearchCache::invalidate(const std::string& dbName) {
+    versions_.bump(dbName);
+}
+
+void SemanticSearchCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    groups_.clear();
+}
+
+SemanticCacheStats SemanticSearchCache::stats() {
+    SemanticCacheStats stats;
+    stats.lookups = lookups_;
+    stats.hits = hits_;
+    stats.verifications = verifications_;
+    stats.inserts = inserts_;
+    stats.hitRate = stats.lookups > 0 ? static_cast<double>(stats.hits) / stats.lookups : 0;
+    std::vector<std::shared_ptr<Group>> groups;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats.maxScoreDrift = maxScoreDrift_;
+        stats.meanScoreDrift = driftSamples_ > 0 ? totalScoreDrift_ / driftSamples_ : 0;
+        for (const auto& [key, group] : groups_) {
+            groups.push_back(group);
+        }
+    }
+    for (const auto& group : groups) {
+        std::lock_guard<std::mutex> lock(group->mutex);
+        stats.entries += group->entries.size();
+    }
+    return stats;
+}
+
+}  // namespace vectordb
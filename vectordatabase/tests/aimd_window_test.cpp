@@ -0,0 +1,85 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include "include/aimd_window.h"
+
+namespace vectordb {
+
+TEST(AimdWindowTest, IncreasePerRound) {
+    AimdWindow window(2, 1, 4, 0.5);
+    EXPECT_FALSE(window.onSuccess());
+    EXPECT_TRUE(window.onSuccess());
+    EXPECT_DOUBLE_EQ(window.value(), 3);
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_FALSE(window.onSuccess());
+    }
+    EXPECT_TRUE(window.onSuccess());
+    EXPECT_DOUBLE_EQ(window.value(), 4);
+    // 已达上限
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_FALSE(window.onSuccess());
+    }
+    EXPECT_DOUBLE_EQ(window.value(), 4);
+}
+
+TEST(AimdWindowTest, DecreaseOncePerRound) {
+    AimdWindow window(16, 1, 16, 0.5);
+    auto sendTime = std::chrono::steady_clock::now();
+    EXPECT_TRUE(window.onOverload(sendTime));
+    EXPECT_DOUBLE_EQ(window.value(), 8);
+    // 上次缩小之前发出的请求
+    EXPECT_FALSE(window.onOverload(sendTime));
+    EXPECT_DOUBLE_EQ(window.value(), 8);
+    EXPECT_TRUE(window.onOverload(std::chrono::steady_clock::now()));
+    EXPECT_DOUBLE_EQ(window.value(), 4);
+}
+
+TEST(AimdWindowTest, Bounds) {
+    AimdWindow window(100, 2, 10, 0.1);
+    EXPECT_DOUBLE_EQ(window.value(), 10);
+    EXPECT_TRUE(window.onOverload(std::chrono::steady_clock::now()));
+    EXPECT_DOUBLE_EQ(window.value(), 2);
+    EXPECT_FALSE(window.onOverload(std::chrono::steady_clock::now()));
+    EXPECT_DOUBLE_EQ(window.value(), 2);
+}
+
+// 缩小后的小数窗口按整数部分计一轮
+TEST(AimdWindowTest, FractionalWindow) {
+    AimdWindow window(5, 1, 8, 0.5);
+    EXPECT_TRUE(window.onOverload(std::chrono::steady_clock::now()));
+    EXPECT_DOUBLE_EQ(window.value(), 2.5);
+    EXPECT_FALSE(window.onSuccess());
+    EXPECT_TRUE(window.onSuccess());
+    EXPECT_DOUBLE_EQ(window.value(), 3.5);
+}
+
+}  // namespace vectordb
@@ -0,0 +1,165 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "include/buffered_writer.h"
+#include "tests/fake_search_engine.h"
+
+namespace vectordb {
+
+namespace {
+
+// 记录服务端收到的各请求的文档数
+struct UpsertRecorder {
+    std::mutex mutex;
+    std::vector<int> batchSizes;
+
+    void install(FakeSearchEngine* service) {
+        service->onUpsert = [this](grpc::ServerContext*, const olama::UpsertRequest& request,
+            olama::UpsertResponse* response) {
+            std::lock_guard<std::mutex> lock(mutex);
+            batchSizes.push_back(request.documents_size());
+            response->set_affectedcount(request.documents_size());
+            return grpc::Status::OK;
+        };
+    }
+
+    std::vector<int> sizes() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return batchSizes;
+    }
+};
+
+Document makeDocument(int i, size_t fieldBytes = 0) {
+    Document doc;
+    doc.id = "buffered_" + std::to_string(i);
+    doc.vector = {0.1f * i, 0.2f, 0.3f};
+    if (fieldBytes > 0) {
+        doc.fields["segment"] = Field(std::string(fieldBytes, 'a'));
+    }
+    return doc;
+}
+
+bool ready(std::future<int>& future, int ms) {
+    return future.wait_for(std::chrono::milliseconds(ms)) == std::future_status::ready;
+}
+
+}  // namespace
+
+TEST(BufferedWriterTest, FlushesAtMaxDocs) {
+    FakeSearchEngine service;
+    UpsertRecorder recorder;
+    recorder.install(&service);
+    FakeServer server(&service);
+    RpcClient client(server.url(), "username", "key", nullptr);
+
+    BufferedWriterOption option;
+    option.maxDocs = 3;
+    option.maxDelay = 60000;
+    BufferedWriter writer(&client, "db", "collection", option);
+    std::future<int> first = writer.write(makeDocument(0));
+    std::future<int> second = writer.write(makeDocument(1));
+    EXPECT_FALSE(ready(first, 100));
+    std::future<int> third = writer.write(makeDocument(2));
+    ASSERT_TRUE(ready(first, 5000));
+    EXPECT_EQ(first.get(), 0);
+    EXPECT_EQ(second.get(), 0);
+    EXPECT_EQ(third.get(), 0);
+    EXPECT_EQ(recorder.sizes(), std::vector<int>({3}));
+}
+
+TEST(BufferedWriterTest, FlushesAtMaxBytes) {
+    FakeSearchEngine service;
+    UpsertRecorder recorder;
+    recorder.install(&service);
+    FakeServer server(&service);
+    RpcClient client(server.url(), "username", "key", nullptr);
+
+    BufferedWriterOption option;
+    option.maxBytes = 1000;
+    option.maxDelay = 60000;
+    BufferedWriter writer(&client, "db", "collection", option);
+    std::future<int> first = writer.write(makeDocument(0, 600));
+    EXPECT_FALSE(ready(first, 100));
+    std::future<int> second = writer.write(makeDocument(1, 600));
+    ASSERT_TRUE(ready(first, 5000));
+    EXPECT_EQ(first.get(), 0);
+    EXPECT_EQ(second.get(), 0);
+    EXPECT_EQ(recorder.sizes(), std::vector<int>({2}));
+}
+
+// 未达到文档数及字节数阈值的文档在maxDelay后由定时线程发送
+TEST(BufferedWriterTest, FlushesAfterMaxDelay) {
+    FakeSearchEngine service;
+    UpsertRecorder recorder;
+    recorder.install(&service);
+    FakeServer server(&service);
+    RpcClient client(server.url(), "username", "key", nullptr);
+
+    BufferedWriterOption option;
+    option.maxDelay = 100;
+    BufferedWriter writer(&client, "db", "collection", option);
+    auto start = std::chrono::steady_clock::now();
+    std::future<int> future = writer.write(makeDocument(0));
+    ASSERT_TRUE(ready(future, 5000));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(90));
+    EXPECT_EQ(future.get(), 0);
+    EXPECT_EQ(recorder.sizes(), std::vector<int>({1}));
+}
+
+// 析构时发送缓冲中的文档并等待请求完成
+TEST(BufferedWriterTest, DestructorFlushes) {
+    FakeSearchEngine service;
+    UpsertRecorder recorder;
+    recorder.install(&service);
+    FakeServer server(&service);
+    RpcClient client(server.url(), "username", "key", nullptr);
+
+    BufferedWriterOption option;
+    option.maxDelay = 60000;
+    std::vector<std::future<int>> futures;
+    {
+        BufferedWriter writer(&client, "db", "collection", option);
+        futures.push_back(writer.write(makeDocument(0)));
+        futures.push_back(writer.write(makeDocument(1)));
+    }
+    for (auto& future : futures) {
+        ASSERT_TRUE(ready(future, 0));
+        EXPECT_EQ(future.get(), 0);
+    }
+    EXPECT_EQ(recorder.sizes(), std::vector<int>({2}));
+}
+
+}  // namespace vectordb
@@ -0,0 +1,217 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "include/bulk_importer.h"
+
+namespace vectordb {
+
+namespace {
+
+std::string tempPath(const std::string& name) {
+    return testing::TempDir() + name;
+}
+
+void writeFile(const std::string& path, const std::string& content) {
+    std::ofstream out(path, std::ios::binary);
+    out.write(content.data(), content.size());
+}
+
+template <typename T>
+void appendRaw(std::string* out, const T& value) {
+    out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// float32 npy文件的文件头, 数据由调用方追加
+std::string npyHeader(const std::string& shape) {
+    std::string header = "{'descr': '<f4', 'fortran_order': False, 'shape': " + shape + ", }";
+    header.append(64 - (10 + header.size() + 1) % 64, ' ');
+    header.push_back('\n');
+    std::string content("\x93NUMPY\x01\x00", 8);
+    appendRaw(&content, static_cast<uint16_t>(header.size()));
+    content += header;
+    return content;
+}
+
+}  // namespace
+
+TEST(BulkImporterTest, ReadFvecs) {
+    std::string content;
+    for (int row = 0; row < 3; ++row) {
+        appendRaw(&content, static_cast<int32_t>(2));
+        appendRaw(&content, row + 0.5f);
+        appendRaw(&content, row + 0.25f);
+    }
+    std::string path = tempPath("importer_test.fvecs");
+    writeFile(path, content);
+
+    VectorFileReader reader;
+    ASSERT_EQ(reader.open(path), 0) << reader.message();
+    EXPECT_EQ(reader.rows(), 3);
+    EXPECT_EQ(reader.dim(), 2);
+    google::protobuf::RepeatedField<float> vector;
+    reader.appendRow(2, &vector);
+    ASSERT_EQ(vector.size(), 2);
+    EXPECT_FLOAT_EQ(vector[0], 2.5f);
+    EXPECT_FLOAT_EQ(vector[1], 2.25f);
+
+    writeFile(path, content.substr(0, content.size() - 1));
+    EXPECT_NE(reader.open(path), 0);
+    std::remove(path.c_str());
+}
+
+TEST(BulkImporterTest, FvecsMiddleRowDimensionMismatch) {
+    // 中间的12字节是维度为1的一行加上维度为0的一行, 文件长度仍为行长度的整数倍, 首尾两行维度正确
+    std::string content;
+    appendRaw(&content, static_cast<int32_t>(2));
+    appendRaw(&content, 1.0f);
+    appendRaw(&content, 2.0f);
+    appendRaw(&content, static_cast<int32_t>(1));
+    appendRaw(&content, 3.0f);
+    appendRaw(&content, static_cast<int32_t>(0));
+    appendRaw(&content, static_cast<int32_t>(2));
+    appendRaw(&content, 4.0f);
+    appendRaw(&content, 5.0f);
+    std::string path = tempPath("importer_mismatch_test.fvecs");
+    writeFile(path, content);
+
+    VectorFileReader reader;
+    ASSERT_EQ(reader.open(path), 0) << reader.message();
+    EXPECT_EQ(reader.rows(), 3);
+    google::protobuf::RepeatedField<float> vector;
+    EXPECT_EQ(reader.appendRow(0, &vector), 0);
+    EXPECT_EQ(reader.appendRow(1, &vector), -1);
+    EXPECT_EQ(vector.size(), 2);
+    EXPECT_EQ(reader.appendRow(2, &vector), 0);
+    EXPECT_EQ(vector.size(), 4);
+    std::remove(path.c_str());
+}
+
+TEST(BulkImporterTest, ReadBvecs) {
+    std::string content;
+    appendRaw(&content, static_cast<int32_t>(3));
+    content += std::string("\x01\x02\xff", 3);
+    std::string path = tempPath("importer_test.bvecs");
+    writeFile(path, content);
+
+    VectorFileReader reader;
+    ASSERT_EQ(reader.open(path), 0) << reader.message();
+    EXPECT_EQ(reader.rows(), 1);
+    google::protobuf::RepeatedField<float> vector;
+    reader.appendRow(0, &vector);
+    ASSERT_EQ(vector.size(), 3);
+    EXPECT_FLOAT_EQ(vector[2], 255.0f);
+    std::remove(path.c_str());
+}
+
+TEST(BulkImporterTest, ReadNpy) {
+    std::string content = npyHeader("(2, 3)");
+    for (int i = 0; i < 6; ++i) {
+        appendRaw(&content, static_cast<float>(i));
+    }
+    std::string path = tempPath("importer_test.npy");
+    writeFile(path, content);
+
+    VectorFileReader reader;
+    ASSERT_EQ(reader.open(path), 0) << reader.message();
+    EXPECT_EQ(reader.rows(), 2);
+    EXPECT_EQ(reader.dim(), 3);
+    google::protobuf::RepeatedField<float> vector;
+    reader.appendRow(1, &vector);
+    ASSERT_EQ(vector.size(), 3);
+    EXPECT_FLOAT_EQ(vector[0], 3.0f);
+    EXPECT_FLOAT_EQ(vector[2], 5.0f);
+
+    std::string fortran = content;
+    fortran.replace(fortran.find("False"), 5, "True ");
+    writeFile(path, fortran);
+    EXPECT_NE(reader.open(path), 0);
+    std::remove(path.c_str());
+}
+
+TEST(BulkImporterTest, NpyShapeOverflow) {
+    std::string path = tempPath("importer_overflow_test.npy");
+    VectorFileReader reader;
+    // rows * rowStride在size_t中回绕为0, 不能通过长度检查
+    std::string content = npyHeader("(2305843009213693952, 2)");
+    appendRaw(&content, 1.0f);
+    writeFile(path, content);
+    EXPECT_NE(reader.open(path), 0);
+    EXPECT_EQ(reader.rows(), 0);
+
+    // dim * sizeof(float)回绕
+    content = npyHeader("(1, 4611686018427387905)");
+    appendRaw(&content, 1.0f);
+    writeFile(path, content);
+    EXPECT_NE(reader.open(path), 0);
+
+    content = npyHeader("(3, 2)");
+    for (int i = 0; i < 5; ++i) {
+        appendRaw(&content, static_cast<float>(i));
+    }
+    writeFile(path, content);
+    EXPECT_NE(reader.open(path), 0);
+    appendRaw(&content, 5.0f);
+    writeFile(path, content);
+    ASSERT_EQ(reader.open(path), 0) << reader.message();
+    EXPECT_EQ(reader.rows(), 3);
+    std::remove(path.c_str());
+}
+
+TEST(BulkImporterTest, ParseSidecarLine) {
+    olama::Document doc;
+    std::string message;
+    ASSERT_EQ(parseSidecarLine(R"({"id": "a\"1é", "page": 12, "score": -1.5, "tags": ["x", "y"],)"
+                               R"( "ok": true, "none": null})",
+                  "id", &doc, &message),
+        0)
+        << message;
+    EXPECT_EQ(doc.id(), "a\"1\xc3\xa9");
+    EXPECT_EQ(doc.fields().at("page").val_u64(), 12);
+    EXPECT_DOUBLE_EQ(doc.fields().at("score").val_double(), -1.5);
+    EXPECT_EQ(doc.fields().at("tags").val_str_arr().str_arr_size(), 2);
+    EXPECT_EQ(doc.fields().at("ok").val_u64(), 1);
+    EXPECT_EQ(doc.fields().count("none"), 0);
+
+    doc.Clear();
+    ASSERT_EQ(parseSidecarLine("{\"key\": 42}\r", "key", &doc, &message), 0) << message;
+    EXPECT_EQ(doc.id(), "42");
+
+    EXPECT_NE(parseSidecarLine("{\"page\": 1}", "id", &doc, &message), 0);
+    EXPECT_NE(parseSidecarLine("{\"id\": \"a\", \"meta\": {}}", "id", &doc, &message), 0);
+    EXPECT_NE(parseSidecarLine("{\"id\": \"a\"", "id", &doc, &message), 0);
+}
+
+}  // namespace vectordb
@@ -0,0 +1,161 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+
+#include "include/bulk_writer.h"
+#include "tests/fake_search_engine.h"
+
+namespace vectordb {
+
+namespace {
+
+Document makeDocument(int i) {
+    Document doc;
+    doc.id = "bulk_" + std::to_string(i);
+    doc.vector = {0.1f * i, 0.2f, 0.3f};
+    return doc;
+}
+
+}  // namespace
+
+// 同时进行的请求数不超过maxInFlight
+TEST(BulkWriterTest, BoundsInFlightRequests) {
+    FakeSearchEngine service;
+    std::atomic<int> active{0};
+    std::atomic<int> maxActive{0};
+    service.onUpsert = [&](grpc::ServerContext*, const olama::UpsertRequest& request,
+        olama::UpsertResponse* response) {
+        int now = ++active;
+        int seen = maxActive.load();
+        while (now > seen && !maxActive.compare_exchange_weak(seen, now)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        --active;
+        response->set_affectedcount(request.documents_size());
+        return grpc::Status::OK;
+    };
+    FakeServer server(&service);
+    RpcClient client(server.url(), "username", "key", nullptr);
+
+    BulkWriterOption option;
+    option.batchDocs = 1;
+    option.workerNum = 4;
+    option.maxInFlight = 2;
+    BulkWriter writer(&client, "db", "collection", option);
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_EQ(writer.write(makeDocument(i)), 0);
+    }
+    BulkWriterStats stats;
+    EXPECT_EQ(writer.close(&stats), 0) << stats.message;
+    EXPECT_EQ(stats.documents, 20);
+    EXPECT_EQ(stats.batches, 20);
+    EXPECT_EQ(stats.affectedCount, 20);
+    EXPECT_LE(maxActive.load(), 2);
+}
+
+// 请求未完成且待处理批次达到maxQueuedBatches时write()阻塞
+TEST(BulkWriterTest, WriteBlocksWhenQueueIsFull) {
+    FakeSearchEngine service;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    service.onUpsert = [released](grpc::ServerContext*, const olama::UpsertRequest& request,
+        olama::UpsertResponse* response) {
+        released.wait();
+        response->set_affectedcount(request.documents_size());
+        return grpc::Status::OK;
+    };
+    FakeServer server(&service);
+    RpcClient client(server.url(), "username", "key", nullptr);
+
+    BulkWriterOption option;
+    option.batchDocs = 1;
+    option.workerNum = 1;
+    option.maxInFlight = 1;
+    option.maxQueuedBatches = 1;
+    BulkWriter writer(&client, "db", "collection", option);
+    std::atomic<int> written{0};
+    std::thread producer([&]() {
+        for (int i = 0; i < 5; ++i) {
+            writer.write(makeDocument(i));
+            ++written;
+        }
+    });
+    // 一个请求在途, 工作线程等待发送窗口, 队列中一个批次, 之后的write()阻塞
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_LT(written.load(), 5);
+    release.set_value();
+    producer.join();
+    BulkWriterStats stats;
+    EXPECT_EQ(writer.close(&stats), 0) << stats.message;
+    EXPECT_EQ(stats.documents, 5);
+}
+
+// 失败的请求计入统计, close()返回非0并带有首个失败请求的错误信息
+TEST(BulkWriterTest, ReportsFailedBatches) {
+    FakeSearchEngine service;
+    std::atomic<int> received{0};
+    service.onUpsert = [&](grpc::ServerContext*, const olama::UpsertRequest& request,
+        olama::UpsertResponse* response) {
+        if (++received == 2) {
+            response->set_code(1);
+            response->set_msg("disk full");
+        } else {
+            response->set_affectedcount(request.documents_size());
+        }
+        return grpc::Status::OK;
+    };
+    FakeServer server(&service);
+    RpcClient client(server.url(), "username", "key", nullptr);
+
+    BulkWriterOption option;
+    option.batchDocs = 2;
+    option.workerNum = 1;
+    option.maxInFlight = 1;
+    BulkWriter writer(&client, "db", "collection", option);
+    for (int i = 0; i < 6; ++i) {
+        ASSERT_EQ(writer.write(makeDocument(i)), 0);
+    }
+    BulkWriterStats stats;
+    EXPECT_NE(writer.close(&stats), 0);
+    EXPECT_EQ(stats.batches, 3);
+    EXPECT_EQ(stats.failedBatches, 1);
+    EXPECT_EQ(stats.failedDocuments, 2);
+    EXPECT_EQ(stats.documents, 4);
+    EXPECT_NE(stats.message.find("disk full"), std::string::npos) << stats.message;
+    EXPECT_EQ(writer.write(makeDocument(6)), -1);
+}
+
+}  // namespace vectordb
@@ -0,0 +1,74 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include "include/channel_pool.h"
+
+namespace vectordb {
+
+TEST(ChannelPoolTest, RoundRobin) {
+    ChannelPool pool("http://127.0.0.1:1", "username", "key", 3);
+    ASSERT_EQ(pool.size(), 3);
+    std::vector<grpc::Channel*> channels;
+    for (int i = 0; i < 6; ++i) {
+        channels.push_back(pool.acquire().channel());
+    }
+    EXPECT_NE(channels[0], channels[1]);
+    EXPECT_NE(channels[1], channels[2]);
+    EXPECT_NE(channels[0], channels[2]);
+    EXPECT_EQ(channels[0], channels[3]);
+    EXPECT_EQ(channels[1], channels[4]);
+}
+
+TEST(ChannelPoolTest, LeastOutstanding) {
+    ChannelPool pool("127.0.0.1:1", "username", "key", 2, 1000, ChannelSelectPolicy::kLeastOutstanding);
+    ChannelPool::Lease busy = pool.acquire();
+    ChannelPool::Lease busy2 = pool.acquire();
+    ChannelPool::Lease busy3 = pool.acquire();
+    ASSERT_EQ(busy.channel(), busy3.channel());
+    {
+        ChannelPool::Lease next = pool.acquire();
+        EXPECT_EQ(next.channel(), busy2.channel());
+    }
+    std::vector<int64_t> outstanding = pool.outstanding();
+    EXPECT_EQ(outstanding[0] + outstanding[1], 3);
+}
+
+TEST(ChannelPoolTest, LeaseReleasesOnMove) {
+    ChannelPool pool("127.0.0.1:1", "username", "key", 1);
+    {
+        ChannelPool::Lease lease = pool.acquire();
+        ChannelPool::Lease moved = std::move(lease);
+        EXPECT_EQ(lease.stub(), nullptr);
+        EXPECT_EQ(pool.outstanding()[0], 1);
+    }
+    EXPECT_EQ(pool.outstanding()[0], 0);
+}
+
+}  // namespace vectordb
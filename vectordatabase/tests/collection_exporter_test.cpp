@@ -0,0 +1,149 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "include/collection_exporter.h"
+#include "include/helper.h"
+
+namespace vectordb {
+
+TEST(CollectionExporterTest, SplitFilters) {
+    std::vector<std::string> filters = CollectionExporter::splitFilters("page", 0, 99, 4);
+    ASSERT_EQ(filters.size(), 4);
+    EXPECT_EQ(filters[0], "page >= 0 and page < 25");
+    EXPECT_EQ(filters[3], "page >= 75 and page <= 99");
+
+    filters = CollectionExporter::splitFilters("page", 10, 12, 8);
+    ASSERT_EQ(filters.size(), 3);
+    EXPECT_EQ(filters[2], "page >= 12 and page <= 12");
+
+    filters = CollectionExporter::splitFilters("page", 0, UINT64_MAX, 2);
+    ASSERT_EQ(filters.size(), 2);
+    EXPECT_EQ(filters[1], "page >= 9223372036854775808 and page <= 18446744073709551615");
+
+    EXPECT_TRUE(CollectionExporter::splitFilters("page", 5, 4, 2).empty());
+}
+
+namespace {
+
+// 按runToFile的格式写入: 文件头后依次为4字节小端长度 + olama::Document序列化内容
+void writeExportFile(const std::string& path, const std::vector<Document>& documents) {
+    std::ofstream out(path, std::ios::binary);
+    out << "VDBEXP01";
+    olama::Document protoDoc;
+    std::string serialized;
+    for (const auto& document : documents) {
+        protoDoc.Clear();
+        convertDocument2Proto(document, &protoDoc);
+        protoDoc.SerializeToString(&serialized);
+        uint32_t len = static_cast<uint32_t>(serialized.size());
+        char header[4] = {static_cast<char>(len), static_cast<char>(len >> 8), static_cast<char>(len >> 16),
+            static_cast<char>(len >> 24)};
+        out.write(header, sizeof(header));
+        out.write(serialized.data(), serialized.size());
+    }
+}
+
+}  // namespace
+
+TEST(CollectionExporterTest, ReadExportFile) {
+    std::vector<Document> documents(3);
+    for (size_t i = 0; i < documents.size(); ++i) {
+        documents[i].id = "doc" + std::to_string(i);
+        documents[i].vector = {0.5f * i, 1.0f, -2.25f};
+        documents[i].fields["page"] = Field(static_cast<uint64_t>(i));
+        documents[i].fields["title"] = Field(std::string("title") + std::to_string(i));
+    }
+    documents[1].fields["tags"] = Field(std::vector<std::string>{"a", "b"});
+    // 超过255字节的记录检查长度的高位字节
+    documents[2].fields["text"] = Field(std::string(1000, 'x'));
+    std::string path = testing::TempDir() + "collection_exporter_read_test.bin";
+    writeExportFile(path, documents);
+
+    std::vector<Document> read;
+    std::string message;
+    ASSERT_EQ(readExportFile(path, [&](Document&& document) {
+        read.push_back(std::move(document));
+        return 0;
+    }, &message), 0) << message;
+    ASSERT_EQ(read.size(), documents.size());
+    for (size_t i = 0; i < documents.size(); ++i) {
+        EXPECT_EQ(read[i].id, documents[i].id);
+        EXPECT_EQ(read[i].vector, documents[i].vector);
+        ASSERT_EQ(read[i].fields.size(), documents[i].fields.size());
+        EXPECT_EQ(read[i].fields.at("page").getValU64(), i);
+        EXPECT_EQ(read[i].fields.at("title").getValStr(), documents[i].fields.at("title").getValStr());
+    }
+    EXPECT_EQ(read[1].fields.at("tags").getValStrArr(), (std::vector<std::string>{"a", "b"}));
+    EXPECT_EQ(read[2].fields.at("text").getValStr().size(), 1000);
+
+    // 回调返回非0时停止读取, 与CollectionExporter::run一样返回非0
+    int calls = 0;
+    EXPECT_NE(readExportFile(path, [&](Document&&) { return ++calls == 2 ? 1 : 0; }, &message), 0);
+    EXPECT_EQ(calls, 2);
+    EXPECT_EQ(message, "read stopped by callback");
+    std::remove(path.c_str());
+}
+
+TEST(CollectionExporterTest, ReadInvalidExportFile) {
+    std::string path = testing::TempDir() + "collection_exporter_test.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "VDBEXP01" << std::string("\x10\x00\x00\x00", 4) << "short";
+    }
+    std::string message;
+    int documents = 0;
+    EXPECT_NE(readExportFile(path, [&](Document&&) { return ++documents, 0; }, &message), 0);
+    EXPECT_EQ(documents, 0);
+    EXPECT_FALSE(message.empty());
+
+    // 长度超过剩余字节数时不分配缓冲区
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "VDBEXP01" << std::string("\xff\xff\xff\xff", 4) << "short";
+    }
+    documents = 0;
+    EXPECT_NE(readExportFile(path, [&](Document&&) { return ++documents, 0; }, &message), 0);
+    EXPECT_EQ(documents, 0);
+    EXPECT_EQ(message, "truncated export file: " + path);
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "not an export file";
+    }
+    EXPECT_NE(readExportFile(path, [&](Document&&) { return 0; }, &message), 0);
+    std::remove(path.c_str());
+}
+
+}  // namespace vectordb
@@ -0,0 +1,122 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include "include/columnar_result.h"
+
+namespace vectordb {
+
+namespace {
+
+olama::Document* addDocument(olama::SearchResult* resultSet, const std::string& id, float score,
+    const std::vector<float>& vector) {
+    olama::Document* document = resultSet->add_documents();
+    document->set_id(id);
+    document->set_score(score);
+    document->mutable_vector()->Add(vector.begin(), vector.end());
+    return document;
+}
+
+}  // namespace
+
+TEST(ColumnarResultTest, FillsColumns) {
+    olama::SearchResponse response;
+    response.set_warning("w");
+    olama::SearchResult* first = response.add_results();
+    olama::Document* a = addDocument(first, "a", 0.9f, {1, 2});
+    (*a->mutable_fields())["title"].set_val_str("x");
+    olama::Document* bc = addDocument(first, "bc", 0.8f, {3, 4});
+    (*bc->mutable_fields())["page"].set_val_u64(7);
+    (*bc->mutable_fields())["title"].set_val_u64(1);
+    olama::Document* d = addDocument(first, "", 0.7f, {5, 6});
+    (*d->mutable_fields())["title"].set_val_str("yz");
+    response.add_results();
+
+    ColumnarSearchResult result;
+    fillColumnarResult(response, {"title", "page", "missing"}, &result);
+    EXPECT_TRUE(result.success);
+    EXPECT_EQ(result.warning, "w");
+    ASSERT_EQ(result.results.size(), 2u);
+    EXPECT_EQ(result.results[1].size, 0u);
+
+    const ColumnarResultSet& set = result.results[0];
+    ASSERT_EQ(set.size, 3u);
+    EXPECT_EQ(set.ids, "abc");
+    EXPECT_EQ(set.id(1), "bc");
+    EXPECT_EQ(set.id(2), "");
+    EXPECT_EQ(set.scores, (std::vector<float>{0.9f, 0.8f, 0.7f}));
+    ASSERT_EQ(set.dim, 2u);
+    EXPECT_EQ(set.vectors, (std::vector<float>{1, 2, 3, 4, 5, 6}));
+    EXPECT_FLOAT_EQ(set.vector(2)[1], 6);
+
+    // 类型取自首个包含该字段的文档, 类型不同的值无效
+    const FieldColumn* title = set.field("title");
+    ASSERT_NE(title, nullptr);
+    EXPECT_EQ(title->type, ColumnType::kString);
+    EXPECT_EQ(title->valid, (std::vector<uint8_t>{1, 0, 1}));
+    EXPECT_EQ(title->str(0), "x");
+    EXPECT_EQ(title->str(1), "");
+    EXPECT_EQ(title->str(2), "yz");
+
+    // 之前缺少该字段的文档被补齐
+    const FieldColumn* page = set.field("page");
+    ASSERT_NE(page, nullptr);
+    EXPECT_EQ(page->type, ColumnType::kU64);
+    EXPECT_EQ(page->valid, (std::vector<uint8_t>{0, 1, 0}));
+    EXPECT_EQ(page->u64s, (std::vector<uint64_t>{0, 7, 0}));
+
+    const FieldColumn* missing = set.field("missing");
+    ASSERT_NE(missing, nullptr);
+    EXPECT_EQ(missing->type, ColumnType::kNone);
+    EXPECT_EQ(missing->valid.size(), 3u);
+    EXPECT_EQ(set.field("other"), nullptr);
+}
+
+TEST(ColumnarResultTest, VectorsOnlyWhenReturned) {
+    olama::SearchResponse response;
+    olama::SearchResult* resultSet = response.add_results();
+    addDocument(resultSet, "a", 1, {});
+    addDocument(resultSet, "b", 1, {1, 2, 3});
+
+    ColumnarSearchResult result;
+    fillColumnarResult(response, {}, &result);
+    const ColumnarResultSet& set = result.results[0];
+    ASSERT_EQ(set.dim, 3u);
+    // 缺少向量的文档补0
+    EXPECT_EQ(set.vectors, (std::vector<float>{0, 0, 0, 1, 2, 3}));
+
+    olama::SearchResponse noVectors;
+    addDocument(noVectors.add_results(), "a", 1, {});
+    ColumnarSearchResult other;
+    fillColumnarResult(noVectors, {}, &other);
+    EXPECT_EQ(other.results[0].dim, 0u);
+    EXPECT_TRUE(other.results[0].vector(0).empty());
+}
+
+}  // namespace vectordb
@@ -0,0 +1,138 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "include/concurrency_limiter.h"
+
+namespace vectordb {
+
+TEST(ConcurrencyLimiterTest, RejectWhenDeadlineExceeded) {
+    ConcurrencyLimitOption option;
+    option.initialLimit = 2;
+    ConcurrencyLimiter limiter(option);
+    auto deadline = std::chrono::system_clock::now() + std::chrono::milliseconds(10);
+    EXPECT_TRUE(limiter.acquire(deadline));
+    EXPECT_TRUE(limiter.acquire(deadline));
+    EXPECT_FALSE(limiter.acquire(deadline));
+    EXPECT_FALSE(limiter.tryAcquire());
+
+    ConcurrencyLimiterStats stats = limiter.stats();
+    EXPECT_EQ(stats.inFlight, 2);
+    EXPECT_EQ(stats.accepted, 2);
+    EXPECT_EQ(stats.rejected, 2);
+    EXPECT_EQ(stats.queued, 0);
+}
+
+TEST(ConcurrencyLimiterTest, WaiterWakesOnRelease) {
+    ConcurrencyLimitOption option;
+    option.initialLimit = 1;
+    ConcurrencyLimiter limiter(option);
+    ASSERT_TRUE(limiter.tryAcquire());
+    std::thread releaser([&limiter] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        limiter.release(false, std::chrono::steady_clock::now());
+    });
+    EXPECT_TRUE(limiter.acquire(std::chrono::system_clock::now() + std::chrono::seconds(5)));
+    releaser.join();
+}
+
+TEST(ConcurrencyLimiterTest, QueueFull) {
+    ConcurrencyLimitOption option;
+    option.initialLimit = 1;
+    option.maxQueue = 0;
+    ConcurrencyLimiter limiter(option);
+    ASSERT_TRUE(limiter.tryAcquire());
+    EXPECT_FALSE(limiter.acquire(std::chrono::system_clock::now() + std::chrono::seconds(5)));
+}
+
+TEST(ConcurrencyLimiterTest, AdditiveIncreaseMultiplicativeDecrease) {
+    ConcurrencyLimitOption option;
+    option.initialLimit = 10;
+    option.minLimit = 2;
+    option.backoffRatio = 0.5;
+    option.latencyThreshold = 100;
+    ConcurrencyLimiter limiter(option);
+
+    ASSERT_TRUE(limiter.tryAcquire());
+    limiter.release(true, std::chrono::steady_clock::now());
+    EXPECT_DOUBLE_EQ(limiter.stats().limit, 5);
+
+    // 延迟超过阈值视为过载
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    ASSERT_TRUE(limiter.tryAcquire());
+    limiter.release(false, std::chrono::steady_clock::now() - std::chrono::milliseconds(120));
+    EXPECT_DOUBLE_EQ(limiter.stats().limit, 2.5);
+
+    // 接近上限时每一轮成功响应使上限加1
+    ASSERT_TRUE(limiter.tryAcquire());
+    ASSERT_TRUE(limiter.tryAcquire());
+    limiter.release(false, std::chrono::steady_clock::now());
+    limiter.release(false, std::chrono::steady_clock::now());
+    EXPECT_DOUBLE_EQ(limiter.stats().limit, 3.5);
+    EXPECT_EQ(limiter.stats().overloaded, 2);
+
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(limiter.tryAcquire());
+        limiter.release(true, std::chrono::steady_clock::now());
+    }
+    EXPECT_DOUBLE_EQ(limiter.stats().limit, 2);
+}
+
+TEST(ConcurrencyLimiterTest, BackOffOncePerRound) {
+    ConcurrencyLimitOption option;
+    option.initialLimit = 16;
+    option.backoffRatio = 0.5;
+    ConcurrencyLimiter limiter(option);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(limiter.tryAcquire());
+    }
+    // 同一轮发出的请求都过载时只降低一次
+    for (int i = 0; i < 8; ++i) {
+        limiter.release(true, start);
+    }
+    EXPECT_DOUBLE_EQ(limiter.stats().limit, 8);
+    EXPECT_EQ(limiter.stats().overloaded, 8);
+
+    ASSERT_TRUE(limiter.tryAcquire());
+    limiter.release(true, std::chrono::steady_clock::now());
+    EXPECT_DOUBLE_EQ(limiter.stats().limit, 4);
+}
+
+TEST(ConcurrencyLimiterTest, GroupByCollection) {
+    ConcurrencyLimitOption option;
+    ConcurrencyLimiterGroup group(option);
+    EXPECT_EQ(group.get("db/a"), group.get("db/a"));
+    EXPECT_NE(group.get("db/a"), group.get("db/b"));
+    EXPECT_EQ(group.stats().size(), 2);
+}
+
+}  // namespace vectordb
@@ -0,0 +1,85 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include "include/document_batch_builder.h"
+
+namespace vectordb {
+
+TEST(DocumentBatchBuilderTest, BuildsRequest) {
+    DocumentBatchBuilder builder("db", "coll");
+    float vector[] = {0.1f, 0.2f, 0.3f};
+    builder.addDocument("0001").setVector(vector, 3).addFieldStr("bookName", "西游记").addFieldU64("page", 21);
+    builder.addDocument("0002").setVector({0.4f, 0.5f, 0.6f}).addFieldDouble("score", 0.5)
+        .addFieldStrArr("tag", {"孙悟空", "唐僧"});
+
+    const olama::UpsertRequest& request = builder.request();
+    EXPECT_EQ(request.database(), "db");
+    EXPECT_EQ(request.collection(), "coll");
+    EXPECT_TRUE(request.buildindex());
+    ASSERT_EQ(builder.size(), 2);
+    EXPECT_EQ(request.documents(0).vector(2), 0.3f);
+    EXPECT_EQ(request.documents(0).fields().at("page").val_u64(), 21);
+    EXPECT_EQ(request.documents(1).fields().at("tag").val_str_arr().str_arr(1), "唐僧");
+    EXPECT_EQ(builder.byteSize(), request.ByteSizeLong());
+
+    builder.clear();
+    EXPECT_EQ(builder.size(), 0);
+    EXPECT_EQ(builder.byteSize(), builder.request().ByteSizeLong());
+    EXPECT_EQ(builder.status(), 0);
+}
+
+TEST(DocumentBatchBuilderTest, SetterBeforeAddDocument) {
+    DocumentBatchBuilder builder("db", "coll");
+    size_t emptySize = builder.byteSize();
+    builder.addFieldU64("page", 1).setVector({0.1f, 0.2f}).addFieldStrArr("tag", {"a"});
+    EXPECT_NE(builder.status(), 0);
+    EXPECT_EQ(builder.message(), "DocumentBatchBuilder: addDocument must be called before addFieldU64");
+    EXPECT_EQ(builder.size(), 0);
+    EXPECT_EQ(builder.byteSize(), emptySize);
+
+    // 之后的文档照常构建, 错误保留到clear
+    builder.addDocument("0001").addFieldStr("text", "a");
+    EXPECT_EQ(builder.size(), 1);
+    EXPECT_NE(builder.status(), 0);
+    builder.clear();
+    EXPECT_EQ(builder.status(), 0);
+    EXPECT_TRUE(builder.message().empty());
+}
+
+TEST(DocumentBatchBuilderTest, Arena) {
+    google::protobuf::Arena arena;
+    DocumentBatchBuilder builder("db", "coll", false, &arena);
+    builder.addDocument("0001").addFieldStr("text", std::string(256, 'a'));
+    EXPECT_EQ(builder.request().GetArena(), &arena);
+    EXPECT_FALSE(builder.request().buildindex());
+    EXPECT_EQ(builder.byteSize(), builder.request().ByteSizeLong());
+}
+
+}  // namespace vectordb
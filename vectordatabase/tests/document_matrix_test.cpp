@@ -0,0 +1,161 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "include/helper.h"
+#include "include/rpc_client.h"
+
+namespace vectordb {
+
+TEST(DocumentMatrixTest, RowWithStride) {
+    // 每行3维, 行间隔4个float, 每行末尾为填充
+    float buffer[] = {1, 2, 3, -1, 4, 5, 6, -1, 7, 8, 9, -1};
+    VectorMatrixView padded{buffer, 3, 3, 4};
+    EXPECT_EQ(padded.row(0), buffer);
+    EXPECT_EQ(padded.row(1), buffer + 4);
+    EXPECT_EQ(padded.row(2)[0], 7);
+
+    VectorMatrixView dense{buffer, 4, 3};
+    EXPECT_EQ(dense.row(1), buffer + 3);
+    EXPECT_EQ(dense.row(3)[2], -1);
+}
+
+TEST(DocumentMatrixTest, CopyVector2Proto) {
+    float buffer[] = {1, 2, 3, -1, 4, 5, 6, -1};
+    VectorMatrixView matrix{buffer, 2, 3, 4};
+    google::protobuf::RepeatedField<float> vector;
+    copyVector2Proto(matrix.row(1), matrix.dim, &vector);
+    EXPECT_EQ(std::vector<float>(vector.begin(), vector.end()), (std::vector<float>{4, 5, 6}));
+
+    // 追加到已有内容之后
+    copyVector2Proto(matrix.row(0), matrix.dim, &vector);
+    EXPECT_EQ(std::vector<float>(vector.begin(), vector.end()), (std::vector<float>{4, 5, 6, 1, 2, 3}));
+
+    copyVector2Proto(nullptr, 0, &vector);
+    EXPECT_EQ(vector.size(), 6);
+}
+
+TEST(DocumentMatrixTest, IdSpan) {
+    std::vector<std::string> ids = {"a", "b", "c"};
+    IdSpan all = ids;
+    EXPECT_EQ(all.size, 3u);
+    EXPECT_EQ(all[2], "c");
+    IdSpan tail(ids.data() + 1, 2);
+    EXPECT_EQ(tail[0], "b");
+}
+
+// 行数不一致时在发送请求前失败, 不需要连接服务端
+TEST(DocumentMatrixTest, UpsertRowCountMismatch) {
+    ClientOption option;
+    option.lazyConnect = true;
+    RpcClient client("127.0.0.1:1", "username", "key", &option);
+    float buffer[] = {1, 2, 3, 4, 5, 6};
+    VectorMatrixView vectors{buffer, 2, 3};
+    const std::string kMessage = "Fail to upsert documents: ids, vectors and fields must have the same number of rows";
+
+    std::vector<std::string> ids = {"a"};
+    UpsertDocumentResult result;
+    EXPECT_EQ(client.upsert("db", "collection", ids, vectors, nullptr, nullptr, &result), -1);
+    EXPECT_FALSE(result.success);
+    EXPECT_EQ(result.message, kMessage);
+
+    ids.push_back("b");
+    std::vector<std::unordered_map<std::string, Field>> fields(3);
+    UpsertDocumentResult fieldsResult;
+    EXPECT_EQ(client.upsert("db", "collection", ids, vectors, &fields, nullptr, &fieldsResult), -1);
+    EXPECT_EQ(fieldsResult.message, kMessage);
+
+    UpsertDocumentResult asyncResult;
+    EXPECT_EQ(client.upsertAsync("db", "collection", IdSpan(ids.data(), 1), vectors, nullptr, nullptr,
+        &asyncResult).get(), -1);
+    EXPECT_EQ(asyncResult.message, kMessage);
+}
+
+// SearchResultView及ColumnarSearchResult不支持重排, 在发送请求前失败
+TEST(DocumentMatrixTest, RerankRejectedForViews) {
+    ClientOption option;
+    option.lazyConnect = true;
+    RpcClient client("127.0.0.1:1", "username", "key", &option);
+    float buffer[] = {1, 2, 3};
+    VectorMatrixView vectors{buffer, 1, 3};
+    SearchDocumentParams params;
+    params.limit = 10;
+    params.rerank = std::make_unique<RerankParams>();
+
+    SearchResultView view;
+    EXPECT_EQ(client.search("db", "collection", vectors, &params, &view), -1);
+    EXPECT_FALSE(view.success);
+    EXPECT_NE(view.message.find("rerank is not supported"), std::string::npos);
+
+    ColumnarSearchResult columnar;
+    EXPECT_EQ(client.searchAsync("db", "collection", vectors, &params, &columnar).get(), -1);
+    EXPECT_FALSE(columnar.success);
+    EXPECT_NE(columnar.message.find("rerank is not supported"), std::string::npos);
+}
+
+// 行间隔小于维度或数据为空时在发送请求前失败
+TEST(DocumentMatrixTest, InvalidMatrix) {
+    ClientOption option;
+    option.lazyConnect = true;
+    RpcClient client("127.0.0.1:1", "username", "key", &option);
+    float buffer[] = {1, 2, 3, 4, 5, 6};
+    VectorMatrixView overlapped{buffer, 2, 3, 2};
+    VectorMatrixView null{nullptr, 2, 3};
+    const std::string kUpsertMessage =
+        "Fail to upsert documents: vectors must have non-null data and a stride of 0 or at least dim";
+    const std::string kSearchMessage =
+        "Fail to search documents: vectors must have non-null data and a stride of 0 or at least dim";
+
+    std::vector<std::string> ids = {"a", "b"};
+    UpsertDocumentResult upsertResult;
+    EXPECT_EQ(client.upsert("db", "collection", ids, overlapped, nullptr, nullptr, &upsertResult), -1);
+    EXPECT_EQ(upsertResult.message, kUpsertMessage);
+    UpsertDocumentResult nullResult;
+    EXPECT_EQ(client.upsertAsync("db", "collection", ids, null, nullptr, nullptr, &nullResult).get(), -1);
+    EXPECT_EQ(nullResult.message, kUpsertMessage);
+
+    SearchDocumentParams params;
+    params.limit = 10;
+    SearchDocumentResult searchResult;
+    EXPECT_EQ(client.search("db", "collection", overlapped, &params, &searchResult), -1);
+    EXPECT_EQ(searchResult.message, kSearchMessage);
+    SearchResultView view;
+    EXPECT_EQ(client.searchAsync("db", "collection", null, &params, &view).get(), -1);
+    EXPECT_EQ(view.message, kSearchMessage);
+    ColumnarSearchResult columnar;
+    EXPECT_EQ(client.search("db", "collection", null, &params, &columnar), -1);
+    EXPECT_EQ(columnar.message, kSearchMessage);
+}
+
+}  // namespace vectordb
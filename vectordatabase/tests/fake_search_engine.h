@@ -0,0 +1,96 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <grpcpp/grpcpp.h>
+
+#include "proto/olama.grpc.pb.h"
+
+namespace vectordb {
+
+// 进程内的SearchEngine服务, 用于不依赖真实服务端的测试; 未设置处理函数的方法返回UNIMPLEMENTED
+// 处理函数在服务端线程中并发执行
+class FakeSearchEngine : public olama::SearchEngine::Service {
+  public:
+    template <typename Request, typename Response>
+    using Handler = std::function<grpc::Status(grpc::ServerContext*, const Request&, Response*)>;
+
+    Handler<olama::CountRequest, olama::CountResponse> onCount;
+    Handler<olama::UpsertRequest, olama::UpsertResponse> onUpsert;
+
+    grpc::Status count(grpc::ServerContext* context, const olama::CountRequest* request,
+        olama::CountResponse* response) override {
+        return call(onCount, context, *request, response);
+    }
+
+    grpc::Status upsert(grpc::ServerContext* context, const olama::UpsertRequest* request,
+        olama::UpsertResponse* response) override {
+        return call(onUpsert, context, *request, response);
+    }
+
+  private:
+    template <typename Request, typename Response>
+    static grpc::Status call(const Handler<Request, Response>& handler, grpc::ServerContext* context,
+        const Request& request, Response* response) {
+        if (!handler) {
+            return grpc::Status(grpc::StatusCode::UNIMPLEMENTED, "not implemented by FakeSearchEngine");
+        }
+        return handler(context, request, response);
+    }
+};
+
+// 在本机随机端口上启动FakeSearchEngine, 析构时关闭服务端并取消未完成的调用
+class FakeServer {
+  public:
+    explicit FakeServer(FakeSearchEngine* service) {
+        grpc::ServerBuilder builder;
+        builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(), &port_);
+        builder.RegisterService(service);
+        server_ = builder.BuildAndStart();
+    }
+
+    ~FakeServer() {
+        server_->Shutdown(std::chrono::system_clock::now() + std::chrono::milliseconds(100));
+    }
+
+    std::string url() const {
+        return "127.0.0.1:" + std::to_string(port_);
+    }
+
+  private:
+    int port_ = 0;
+    std::unique_ptr<grpc::Server> server_;
+};
+
+}  // namespace vectordb
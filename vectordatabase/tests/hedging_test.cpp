@@ -0,0 +1,166 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include "include/hedging.h"
+#include "include/rpc_client.h"
+#include "tests/fake_search_engine.h"
+
+namespace vectordb {
+
+namespace {
+
+// 等待客户端取消调用, 返回是否在超时前被取消
+bool waitForCancel(grpc::ServerContext* context) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!context->IsCancelled() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return context->IsCancelled();
+}
+
+ClientOption hedgingOption() {
+    ClientOption option;
+    option.hedging.enabled = true;
+    option.hedging.delay = 20;
+    return option;
+}
+
+}  // namespace
+
+TEST(LatencyTrackerTest, NotEnoughSamples) {
+    LatencyTracker tracker;
+    EXPECT_EQ(tracker.percentile(0.95), -1);
+    tracker.add(100);
+    EXPECT_EQ(tracker.percentile(0.95, 10), -1);
+    EXPECT_EQ(tracker.percentile(0.95, 1), 100);
+}
+
+TEST(LatencyTrackerTest, Percentile) {
+    LatencyTracker tracker(1000);
+    for (int i = 1; i <= 100; ++i) {
+        tracker.add(i);
+    }
+    EXPECT_EQ(tracker.percentile(0.5), 50);
+    EXPECT_EQ(tracker.percentile(0.95), 95);
+    EXPECT_EQ(tracker.percentile(1.0), 100);
+}
+
+TEST(LatencyTrackerTest, WindowEvictsOldSamples) {
+    LatencyTracker tracker(10);
+    for (int i = 0; i < 10; ++i) {
+        tracker.add(1000);
+    }
+    for (int i = 0; i < 10; ++i) {
+        tracker.add(1);
+    }
+    EXPECT_EQ(tracker.sampleCount(), 10);
+    EXPECT_EQ(tracker.percentile(0.99), 1);
+}
+
+// 首个请求超过delay未返回, 对冲请求先成功, 首个请求被取消
+TEST(HedgedCallTest, HedgeWinsAndCancelsPrimary) {
+    FakeSearchEngine service;
+    std::atomic<int> calls{0};
+    std::promise<bool> primaryCancelled;
+    service.onCount = [&](grpc::ServerContext* context, const olama::CountRequest&, olama::CountResponse* response) {
+        if (calls++ == 0) {
+            primaryCancelled.set_value(waitForCancel(context));
+            return grpc::Status(grpc::StatusCode::CANCELLED, "primary cancelled");
+        }
+        response->set_count(2);
+        return grpc::Status::OK;
+    };
+    FakeServer server(&service);
+    ClientOption option = hedgingOption();
+    RpcClient client(server.url(), "username", "key", &option);
+
+    CountResult result;
+    EXPECT_EQ(client.count("db", "collection", nullptr, &result, 3000), 0);
+    EXPECT_EQ(result.count, 2);
+    std::future<bool> cancelled = primaryCancelled.get_future();
+    ASSERT_EQ(cancelled.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_TRUE(cancelled.get());
+    EXPECT_EQ(calls.load(), 2);
+}
+
+// 对冲请求发出后首个请求先返回, 使用首个请求的结果并取消对冲请求
+TEST(HedgedCallTest, PrimaryWinsAfterHedgeIsSent) {
+    FakeSearchEngine service;
+    std::atomic<int> calls{0};
+    std::promise<bool> hedgeCancelled;
+    service.onCount = [&](grpc::ServerContext* context, const olama::CountRequest&, olama::CountResponse* response) {
+        if (calls++ == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            response->set_count(1);
+            return grpc::Status::OK;
+        }
+        hedgeCancelled.set_value(waitForCancel(context));
+        return grpc::Status(grpc::StatusCode::CANCELLED, "hedge cancelled");
+    };
+    FakeServer server(&service);
+    ClientOption option = hedgingOption();
+    RpcClient client(server.url(), "username", "key", &option);
+
+    CountResult result;
+    EXPECT_EQ(client.count("db", "collection", nullptr, &result, 3000), 0);
+    EXPECT_EQ(result.count, 1);
+    std::future<bool> cancelled = hedgeCancelled.get_future();
+    ASSERT_EQ(cancelled.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_TRUE(cancelled.get());
+}
+
+// 所有请求均失败时返回最后一个失败请求的状态
+TEST(HedgedCallTest, AllAttemptsFail) {
+    FakeSearchEngine service;
+    std::atomic<int> calls{0};
+    service.onCount = [&](grpc::ServerContext*, const olama::CountRequest&, olama::CountResponse*) {
+        if (calls++ == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            return grpc::Status(grpc::StatusCode::UNAVAILABLE, "primary failed");
+        }
+        return grpc::Status(grpc::StatusCode::INTERNAL, "hedge failed");
+    };
+    FakeServer server(&service);
+    ClientOption option = hedgingOption();
+    RpcClient client(server.url(), "username", "key", &option);
+
+    CountResult result;
+    EXPECT_NE(client.count("db", "collection", nullptr, &result, 3000), 0);
+    EXPECT_FALSE(result.success);
+    EXPECT_NE(result.message.find("primary failed"), std::string::npos) << result.message;
+    EXPECT_EQ(calls.load(), 2);
+}
+
+}  // namespace vectordb
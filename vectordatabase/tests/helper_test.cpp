@@ -0,0 +1,118 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include "include/helper.h"
+
+namespace vectordb {
+
+namespace {
+
+Document makeDocument(const std::string& id, const std::vector<float>& vector,
+    const std::string& key, const std::string& value) {
+    Document doc;
+    doc.id = id;
+    doc.vector = vector;
+    doc.fields[key] = Field(value);
+    return doc;
+}
+
+}  // namespace
+
+TEST(HelperTest, CoalesceReplace) {
+    std::vector<Document> documents = {
+        makeDocument("a", {1.0f}, "x", "1"),
+        makeDocument("b", {2.0f}, "x", "2"),
+        makeDocument("a", {3.0f}, "y", "3"),
+    };
+    std::deque<Document> merged;
+    std::vector<const Document*> result = coalesceDocuments(documents, CoalescePolicy::kReplace, &merged);
+    ASSERT_EQ(result.size(), 2);
+    EXPECT_EQ(result[0], &documents[2]);
+    EXPECT_EQ(result[1], &documents[1]);
+    EXPECT_TRUE(merged.empty());
+
+    result = coalesceDocuments(documents, CoalescePolicy::kNone, &merged);
+    EXPECT_EQ(result.size(), 3);
+}
+
+TEST(HelperTest, CoalesceMergeFields) {
+    std::vector<Document> documents = {
+        makeDocument("a", {1.0f}, "x", "1"),
+        makeDocument("a", {}, "y", "2"),
+        makeDocument("a", {}, "x", "3"),
+    };
+    std::deque<Document> merged;
+    std::vector<const Document*> result = coalesceDocuments(documents, CoalescePolicy::kMergeFields, &merged);
+    ASSERT_EQ(result.size(), 1);
+    EXPECT_EQ(result[0]->fields.at("x").getValStr(), "3");
+    EXPECT_EQ(result[0]->fields.at("y").getValStr(), "2");
+    EXPECT_EQ(result[0]->vector, std::vector<float>{1.0f});
+}
+
+TEST(HelperTest, MergeDocumentFields) {
+    olama::Document earlier;
+    convertDocument2Proto(makeDocument("a", {1.0f, 2.0f}, "x", "1"), &earlier);
+    (*earlier.mutable_fields())["y"].set_val_u64(7);
+    olama::Document latest;
+    convertDocument2Proto(makeDocument("a", {}, "x", "2"), &latest);
+
+    mergeDocumentFields(earlier, &latest);
+    EXPECT_EQ(latest.fields().at("x").val_str(), "2");
+    EXPECT_EQ(latest.fields().at("y").val_u64(), 7);
+    EXPECT_EQ(latest.vector_size(), 2);
+}
+
+TEST(HelperTest, ConvertDocumentByMove) {
+    std::string payload(1024, 'p');
+    Document doc = makeDocument("a", {1.0f, 2.0f}, "text", payload);
+    doc.fields["tags"] = Field(std::vector<std::string>{"x", "y"});
+    olama::Document protoDoc;
+    convertDocument2Proto(std::move(doc), &protoDoc);
+    EXPECT_EQ(protoDoc.id(), "a");
+    EXPECT_EQ(protoDoc.fields().at("text").val_str(), payload);
+    EXPECT_EQ(protoDoc.fields().at("tags").val_str_arr().str_arr_size(), 2);
+    EXPECT_EQ(protoDoc.vector_size(), 2);
+    EXPECT_TRUE(doc.fields["text"].getValStr().empty());
+}
+
+TEST(HelperTest, CoalesceOwnedMergeFields) {
+    std::vector<Document> documents = {
+        makeDocument("a", {1.0f}, "x", "1"),
+        makeDocument("b", {2.0f}, "x", "2"),
+        makeDocument("a", {}, "y", "3"),
+    };
+    std::vector<Document*> result = coalesceOwnedDocuments(&documents, CoalescePolicy::kMergeFields);
+    ASSERT_EQ(result.size(), 2);
+    EXPECT_EQ(result[0], &documents[2]);
+    EXPECT_EQ(result[0]->fields.at("x").getValStr(), "1");
+    EXPECT_EQ(result[0]->vector, std::vector<float>{1.0f});
+}
+
+}  // namespace vectordb
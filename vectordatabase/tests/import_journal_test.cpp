@@ -0,0 +1,79 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "include/import_journal.h"
+
+namespace vectordb {
+
+TEST(ImportJournalTest, ResumeFromJournal) {
+    std::string path = testing::TempDir() + "import_journal_test.log";
+    std::remove(path.c_str());
+    {
+        ImportJournal journal;
+        ASSERT_EQ(journal.open(path, "rows=300"), 0) << journal.message();
+        EXPECT_EQ(journal.markStarted(0, 100), 0);
+        EXPECT_EQ(journal.markStarted(100, 200), 0);
+        EXPECT_EQ(journal.markAcked(0, 100, 100), 0);
+        EXPECT_EQ(journal.markStarted(200, 300), 0);
+        EXPECT_EQ(journal.markAcked(200, 300, 98), 0);
+    }
+    // 模拟写入一半时进程退出
+    {
+        std::ofstream out(path, std::ios::app);
+        out << "A 100 2";
+    }
+
+    ImportJournal journal;
+    ASSERT_EQ(journal.open(path, "rows=300"), 0) << journal.message();
+    EXPECT_TRUE(journal.acked(0, 100));
+    EXPECT_TRUE(journal.acked(20, 50));
+    EXPECT_FALSE(journal.acked(100, 200));
+    EXPECT_FALSE(journal.acked(50, 150));
+    EXPECT_TRUE(journal.started(100, 200));
+    EXPECT_FALSE(journal.started(0, 100));
+    EXPECT_EQ(journal.ackedRows(), 200);
+    EXPECT_EQ(journal.affectedCount(), 198);
+
+    EXPECT_EQ(journal.markAcked(100, 200, 100), 0);
+    EXPECT_TRUE(journal.acked(0, 300));
+    EXPECT_FALSE(journal.started(0, 300));
+    journal.close();
+
+    ASSERT_EQ(journal.open(path, "rows=300"), 0);
+    EXPECT_EQ(journal.ackedRows(), 300);
+    EXPECT_NE(journal.open(path, "rows=400"), 0);
+    std::remove(path.c_str());
+}
+
+}  // namespace vectordb
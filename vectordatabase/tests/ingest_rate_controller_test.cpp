@@ -0,0 +1,139 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include <grpcpp/grpcpp.h>
+
+#include "include/ingest_rate_controller.h"
+
+namespace vectordb {
+
+namespace {
+
+UpsertDocumentResult succeeded() {
+    UpsertDocumentResult result;
+    result.success = true;
+    return result;
+}
+
+std::chrono::steady_clock::time_point sentAgo(int ms) {
+    return std::chrono::steady_clock::now() - std::chrono::milliseconds(ms);
+}
+
+}  // namespace
+
+TEST(IngestRateControllerTest, Throttled) {
+    UpsertDocumentResult result = succeeded();
+    EXPECT_FALSE(IngestRateController::throttled(0, result));
+    result.warning = "write pressure too high";
+    EXPECT_TRUE(IngestRateController::throttled(0, result));
+
+    result = UpsertDocumentResult();
+    result.success = false;
+    result.statusCode = grpc::StatusCode::RESOURCE_EXHAUSTED;
+    EXPECT_TRUE(IngestRateController::throttled(-1, result));
+    result.statusCode = grpc::StatusCode::INVALID_ARGUMENT;
+    EXPECT_FALSE(IngestRateController::throttled(-1, result));
+
+    result.statusCode = 0;
+    result.code = 1;
+    result.message = "Fail to upsert documents: vector dimension mismatch";
+    EXPECT_FALSE(IngestRateController::throttled(-1, result));
+    result.message = "Fail to upsert documents: Too Many Requests";
+    EXPECT_TRUE(IngestRateController::throttled(-1, result));
+}
+
+TEST(IngestRateControllerTest, AdditiveIncreaseMultiplicativeDecrease) {
+    IngestRateOption option;
+    option.maxInFlight = 8;
+    option.initialInFlight = 2;
+    IngestRateController controller(option);
+    EXPECT_EQ(controller.window(), 2);
+
+    // 每轮window个成功响应后窗口加1
+    for (int i = 0; i < 2; ++i) {
+        controller.onResponse(0, succeeded(), sentAgo(10));
+    }
+    EXPECT_EQ(controller.window(), 3);
+    for (int i = 0; i < 100; ++i) {
+        controller.onResponse(0, succeeded(), sentAgo(10));
+    }
+    EXPECT_EQ(controller.window(), 8);
+
+    UpsertDocumentResult warned = succeeded();
+    warned.warning = "slow down";
+    EXPECT_TRUE(controller.onResponse(0, warned, sentAgo(10)));
+    EXPECT_EQ(controller.window(), 4);
+    controller.onResponse(0, warned, std::chrono::steady_clock::now());
+    controller.onResponse(0, warned, std::chrono::steady_clock::now());
+    controller.onResponse(0, warned, std::chrono::steady_clock::now());
+    EXPECT_EQ(controller.window(), 1);
+
+    IngestRateStats stats = controller.stats();
+    EXPECT_EQ(stats.throttled, 4);
+    EXPECT_EQ(stats.decreases, 3);
+}
+
+TEST(IngestRateControllerTest, LatencyIncrease) {
+    IngestRateOption option;
+    option.maxInFlight = 8;
+    option.initialInFlight = 8;
+    IngestRateController controller(option);
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_FALSE(controller.onResponse(0, succeeded(), sentAgo(10)));
+    }
+    bool throttled = false;
+    for (int i = 0; i < 10 && !throttled; ++i) {
+        throttled = controller.onResponse(0, succeeded(), sentAgo(50));
+    }
+    EXPECT_TRUE(throttled);
+    EXPECT_LT(controller.window(), 8);
+}
+
+TEST(IngestRateControllerTest, IgnoresStaleSignals) {
+    IngestRateOption option;
+    option.maxInFlight = 16;
+    option.initialInFlight = 16;
+    IngestRateController controller(option);
+    UpsertDocumentResult result;
+    result.success = false;
+    result.statusCode = grpc::StatusCode::UNAVAILABLE;
+    // 同一轮发出的请求都失败时只缩小一次
+    auto sendTime = sentAgo(10);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(controller.onResponse(-1, result, sendTime));
+    }
+    EXPECT_EQ(controller.window(), 8);
+    controller.onResponse(-1, result, std::chrono::steady_clock::now());
+    EXPECT_EQ(controller.window(), 4);
+}
+
+}  // namespace vectordb
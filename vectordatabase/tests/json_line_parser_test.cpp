@@ -0,0 +1,154 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "include/json_line_parser.h"
+
+namespace vectordb {
+
+namespace {
+
+int parseLine(const std::string& line, olama::Document* doc, std::string* message = nullptr) {
+    JsonLineParser parser(line);
+    int ret = parser.parse("id", doc);
+    if (message != nullptr) {
+        *message = parser.message();
+    }
+    return ret;
+}
+
+}  // namespace
+
+TEST(JsonLineParserTest, Escapes) {
+    olama::Document doc;
+    std::string message;
+    ASSERT_EQ(parseLine(R"({"id": "a\"b\\c\/d", "s": "\b\f\n\r\t", "e": "\u00e9\u4E2D"})", &doc, &message), 0)
+        << message;
+    EXPECT_EQ(doc.id(), "a\"b\\c/d");
+    EXPECT_EQ(doc.fields().at("s").val_str(), "\b\f\n\r\t");
+    EXPECT_EQ(doc.fields().at("e").val_str(), "\xc3\xa9\xe4\xb8\xad");
+
+    EXPECT_NE(parseLine(R"({"id": "a\x"})", &doc, &message), 0);
+    EXPECT_EQ(message, "invalid escape \\x");
+    EXPECT_NE(parseLine(R"({"id": "\u00g0"})", &doc, &message), 0);
+    EXPECT_EQ(message, "invalid \\u escape");
+    EXPECT_NE(parseLine(R"({"id": "\u00)", &doc, &message), 0);
+    EXPECT_EQ(message, "truncated \\u escape");
+}
+
+TEST(JsonLineParserTest, SurrogatePairs) {
+    olama::Document doc;
+    std::string message;
+    ASSERT_EQ(parseLine(R"({"id": "\ud83d\ude00", "s": "x\uD834\uDD1Ey"})", &doc, &message), 0) << message;
+    EXPECT_EQ(doc.id(), "\xf0\x9f\x98\x80");
+    EXPECT_EQ(doc.fields().at("s").val_str(), "x\xf0\x9d\x84\x9ey");
+
+    // 高位代理后必须紧跟低位代理, 单独的低位代理同样无效
+    EXPECT_NE(parseLine(R"({"id": "\ud83d"})", &doc, &message), 0);
+    EXPECT_EQ(message, "invalid surrogate pair");
+    EXPECT_NE(parseLine(R"({"id": "\ud83dx"})", &doc, &message), 0);
+    EXPECT_EQ(message, "invalid surrogate pair");
+    EXPECT_NE(parseLine(R"({"id": "\ud83d\u0041"})", &doc, &message), 0);
+    EXPECT_EQ(message, "invalid surrogate pair");
+    EXPECT_NE(parseLine(R"({"id": "\ude00"})", &doc, &message), 0);
+    EXPECT_EQ(message, "invalid surrogate pair");
+}
+
+TEST(JsonLineParserTest, Values) {
+    olama::Document doc;
+    std::string message;
+    ASSERT_EQ(parseLine(R"( { "id" : 7 , "u": 18446744073709551615, "big": 18446744073709551616, "d": 1e3,)"
+                        R"( "t": true, "f": false, "n": null, "arr": [], "tags": ["x", "y"] } )",
+                  &doc, &message),
+        0)
+        << message;
+    EXPECT_EQ(doc.id(), "7");
+    EXPECT_EQ(doc.fields().at("u").val_u64(), UINT64_MAX);
+    EXPECT_DOUBLE_EQ(doc.fields().at("big").val_double(), 18446744073709551616.0);
+    EXPECT_DOUBLE_EQ(doc.fields().at("d").val_double(), 1000.0);
+    EXPECT_EQ(doc.fields().at("t").val_u64(), 1);
+    EXPECT_EQ(doc.fields().at("f").val_u64(), 0);
+    EXPECT_EQ(doc.fields().count("n"), 0);
+    EXPECT_EQ(doc.fields().at("arr").val_str_arr().str_arr_size(), 0);
+    EXPECT_EQ(doc.fields().at("tags").val_str_arr().str_arr(1), "y");
+
+    JsonLineParser parser("{\"key\": \"k\", \"id\": 1}");
+    ASSERT_EQ(parser.parse("key", &doc), 0) << parser.message();
+    EXPECT_EQ(doc.id(), "k");
+    EXPECT_EQ(doc.fields().at("id").val_u64(), 1);
+}
+
+TEST(JsonLineParserTest, MalformedLines) {
+    olama::Document doc;
+    std::string message;
+    EXPECT_NE(parseLine("", &doc, &message), 0);
+    EXPECT_EQ(message, "expected '{'");
+    EXPECT_NE(parseLine(R"({"id" "a"})", &doc, &message), 0);
+    EXPECT_EQ(message, "expected ':' after \"id\"");
+    EXPECT_NE(parseLine(R"({"id": "a",})", &doc, &message), 0);
+    EXPECT_EQ(message, "expected string");
+    EXPECT_NE(parseLine(R"({"id": "a" "b": 1})", &doc, &message), 0);
+    EXPECT_EQ(message, "expected ',' or '}'");
+    EXPECT_NE(parseLine(R"({"id": "a"} x)", &doc, &message), 0);
+    EXPECT_EQ(message, "unexpected trailing characters");
+    EXPECT_NE(parseLine(R"({"id": "a)", &doc, &message), 0);
+    EXPECT_EQ(message, "unterminated string");
+    EXPECT_NE(parseLine(R"({"id": "a", "b": 1.2.3})", &doc, &message), 0);
+    EXPECT_EQ(message, "invalid number 1.2.3");
+    EXPECT_NE(parseLine(R"({"id": "a", "b": tru})", &doc, &message), 0);
+    EXPECT_EQ(message, "invalid value");
+    EXPECT_NE(parseLine(R"({"id": "a", "b": })", &doc, &message), 0);
+    EXPECT_EQ(message, "invalid value");
+    EXPECT_NE(parseLine(R"({"b": 1})", &doc, &message), 0);
+    EXPECT_EQ(message, "missing \"id\"");
+    EXPECT_NE(parseLine(R"({"id": -1})", &doc, &message), 0);
+    EXPECT_EQ(message, "id must be a string or a non-negative integer");
+    EXPECT_NE(parseLine(R"({"id": 1.5})", &doc, &message), 0);
+    EXPECT_EQ(message, "id must be a string or a non-negative integer");
+}
+
+TEST(JsonLineParserTest, RejectsNestedValues) {
+    olama::Document doc;
+    std::string message;
+    EXPECT_NE(parseLine(R"({"id": "a", "meta": {"k": 1}})", &doc, &message), 0);
+    EXPECT_EQ(message, "nested objects are not supported");
+    EXPECT_NE(parseLine(R"({"id": "a", "meta": {}})", &doc, &message), 0);
+    EXPECT_EQ(message, "nested objects are not supported");
+    EXPECT_NE(parseLine(R"({"id": {"k": 1}})", &doc, &message), 0);
+    EXPECT_NE(parseLine(R"({"id": "a", "arr": [["x"]]})", &doc, &message), 0);
+    EXPECT_EQ(message, "only arrays of strings are supported");
+    EXPECT_NE(parseLine(R"({"id": "a", "arr": [{"k": "x"}]})", &doc, &message), 0);
+    EXPECT_EQ(message, "only arrays of strings are supported");
+    EXPECT_NE(parseLine(R"({"id": "a", "arr": ["x", 1]})", &doc, &message), 0);
+    EXPECT_EQ(message, "only arrays of strings are supported");
+}
+
+}  // namespace vectordb
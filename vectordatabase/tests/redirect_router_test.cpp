@@ -0,0 +1,80 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include "include/redirect_router.h"
+
+namespace vectordb {
+
+TEST(RedirectRouterTest, LearnAndRoute) {
+    RedirectRouter router("http://127.0.0.1:1", "username", "key", 1, 1000, ChannelSelectPolicy::kRoundRobin);
+    EXPECT_EQ(router.route("db/coll"), nullptr);
+
+    router.learn("db/coll", "http://127.0.0.1:2");
+    std::shared_ptr<ChannelPool> pool = router.route("db/coll");
+    ASSERT_NE(pool, nullptr);
+    EXPECT_EQ(router.routes().at("db/coll"), "127.0.0.1:2");
+
+    // 同一节点的集合共用连接池
+    router.learn("db/other", "127.0.0.1:2");
+    EXPECT_EQ(router.route("db/other"), pool);
+    EXPECT_EQ(router.route("db/unknown"), nullptr);
+}
+
+TEST(RedirectRouterTest, IgnoresDefaultTarget) {
+    RedirectRouter router("127.0.0.1:1", "username", "key", 1, 1000, ChannelSelectPolicy::kRoundRobin);
+    router.learn("db/coll", "http://127.0.0.1:1/");
+    EXPECT_EQ(router.route("db/coll"), nullptr);
+
+    router.learn("db/coll", "127.0.0.1:2");
+    ASSERT_NE(router.route("db/coll"), nullptr);
+    // redirect回默认地址时清除路由
+    router.learn("db/coll", "127.0.0.1:1");
+    EXPECT_EQ(router.route("db/coll"), nullptr);
+}
+
+TEST(RedirectRouterTest, Invalidate) {
+    RedirectRouter router("127.0.0.1:1", "username", "key", 1, 1000, ChannelSelectPolicy::kRoundRobin);
+    router.learn("db/a", "127.0.0.1:2");
+    router.learn("db/b", "127.0.0.1:2");
+    std::shared_ptr<ChannelPool> pool = router.route("db/a");
+
+    router.invalidate("db/a");
+    EXPECT_EQ(router.route("db/a"), nullptr);
+    EXPECT_EQ(router.route("db/b"), pool);
+
+    router.invalidate("db/b");
+    EXPECT_TRUE(router.routes().empty());
+    // 释放后重新学习会创建新的连接池, 旧连接池仍由持有者保持有效
+    router.learn("db/a", "127.0.0.1:2");
+    EXPECT_NE(router.route("db/a"), pool);
+    EXPECT_EQ(pool->size(), 1);
+}
+
+}  // namespace vectordb
@@ -0,0 +1,139 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "include/rerank.h"
+#include "include/types/consts.h"
+
+namespace vectordb {
+
+namespace {
+
+Document makeDocument(const std::string& id, const std::vector<float>& vector, float score = 0) {
+    Document document;
+    document.id = id;
+    document.vector = vector;
+    document.score = score;
+    return document;
+}
+
+std::vector<std::string> ids(const std::vector<Document>& documents) {
+    std::vector<std::string> result;
+    for (const auto& document : documents) {
+        result.push_back(document.id);
+    }
+    return result;
+}
+
+}  // namespace
+
+TEST(RerankTest, KernelsMatchScalar) {
+    std::string name = distanceKernelName();
+    EXPECT_TRUE(name == "avx512" || name == "avx2" || name == "neon" || name == "scalar") << name;
+    // 覆盖SIMD主循环及各种长度的尾部
+    for (size_t dim : {1, 3, 7, 8, 15, 16, 17, 31, 33, 64, 100, 768}) {
+        std::vector<float> a(dim);
+        std::vector<float> b(dim);
+        double l2 = 0;
+        double ip = 0;
+        for (size_t i = 0; i < dim; ++i) {
+            a[i] = std::sin(static_cast<float>(i));
+            b[i] = std::cos(static_cast<float>(i) * 0.5f);
+            l2 += (a[i] - b[i]) * (a[i] - b[i]);
+            ip += a[i] * b[i];
+        }
+        EXPECT_NEAR(l2Squared(a.data(), b.data(), dim), l2, 1e-3 * (1 + l2)) << dim;
+        EXPECT_NEAR(innerProduct(a.data(), b.data(), dim), ip, 1e-3 * (1 + std::fabs(ip))) << dim;
+    }
+}
+
+TEST(RerankTest, L2Ascending) {
+    std::vector<float> query = {0, 0};
+    std::vector<Document> documents = {
+        makeDocument("far", {3, 4}),
+        makeDocument("none", {}),
+        makeDocument("near", {1, 0}),
+        makeDocument("mid", {1, 1}),
+    };
+    rerankDocuments(query.data(), query.size(), L2, 3, &documents);
+    EXPECT_EQ(ids(documents), (std::vector<std::string>{"near", "mid", "far"}));
+    EXPECT_FLOAT_EQ(documents[0].score, 1);
+    EXPECT_FLOAT_EQ(documents[2].score, 25);
+}
+
+TEST(RerankTest, InnerProductAndCosineDescending) {
+    std::vector<float> query = {1, 0};
+    std::vector<Document> documents = {
+        makeDocument("long", {10, 10}),
+        makeDocument("aligned", {1, 0}),
+        makeDocument("opposite", {-1, 0}),
+    };
+    rerankDocuments(query.data(), query.size(), IP, 10, &documents);
+    EXPECT_EQ(ids(documents), (std::vector<std::string>{"long", "aligned", "opposite"}));
+
+    rerankDocuments(query.data(), query.size(), COSINE, 2, &documents);
+    EXPECT_EQ(ids(documents), (std::vector<std::string>{"aligned", "long"}));
+    EXPECT_FLOAT_EQ(documents[0].score, 1);
+    EXPECT_NEAR(documents[1].score, std::sqrt(0.5f), 1e-6);
+}
+
+TEST(RerankTest, DocumentsWithoutVectorsKeepOrder) {
+    std::vector<float> query = {0, 0};
+    std::vector<Document> documents = {
+        makeDocument("b", {}, 0.5f),
+        makeDocument("x", {2, 0}),
+        makeDocument("a", {1}, 0.9f),
+    };
+    rerankDocuments(query.data(), query.size(), L2, 10, &documents);
+    EXPECT_EQ(ids(documents), (std::vector<std::string>{"x", "b", "a"}));
+    EXPECT_FLOAT_EQ(documents[1].score, 0.5f);
+}
+
+TEST(RerankTest, UnsupportedMetric) {
+    EXPECT_TRUE(rerankMetricSupported(L2));
+    EXPECT_TRUE(rerankMetricSupported(IP));
+    EXPECT_TRUE(rerankMetricSupported(COSINE));
+    EXPECT_FALSE(rerankMetricSupported("l2"));
+    EXPECT_FALSE(rerankMetricSupported("HAMMING"));
+
+    std::vector<float> query = {0, 0};
+    std::vector<Document> documents = {
+        makeDocument("far", {3, 4}, 0.1f),
+        makeDocument("near", {1, 0}, 0.2f),
+    };
+    EXPECT_EQ(rerankDocuments(query.data(), query.size(), "HAMMING", 1, &documents), -1);
+    EXPECT_EQ(ids(documents), (std::vector<std::string>{"far", "near"}));
+    EXPECT_FLOAT_EQ(documents[0].score, 0.1f);
+}
+
+}  // namespace vectordb
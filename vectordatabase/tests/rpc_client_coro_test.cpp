@@ -0,0 +1,227 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "include/rpc_client_coro.h"
+
+#if !(__cplusplus >= 202002L && __has_include(<coroutine>))
+#error "rpc_client_coro_test.cpp must be compiled with C++20"
+#endif
+
+namespace vectordb {
+
+namespace {
+
+// 立即开始执行、结束后自动销毁的协程, 测试通过std::promise等待其完成
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() {
+            return {};
+        }
+        std::suspend_never initial_suspend() noexcept {
+            return {};
+        }
+        std::suspend_never final_suspend() noexcept {
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception() {
+            std::terminate();
+        }
+    };
+};
+
+DetachedTask awaitTwice(RpcAwaitable first, RpcAwaitable second, std::promise<int>* done) {
+    int ret = co_await std::move(first);
+    ret += co_await std::move(second);
+    done->set_value(ret);
+}
+
+DetachedTask awaitOne(RpcAwaitable op, std::promise<int>* done) {
+    done->set_value(co_await std::move(op));
+}
+
+DetachedTask awaitInlineLoop(int times, std::promise<int>* done) {
+    int sum = 0;
+    for (int i = 0; i < times; ++i) {
+        sum += co_await RpcAwaitable([](AsyncCallback cb) { cb(1); }, nullptr);
+    }
+    done->set_value(sum);
+}
+
+std::vector<Document> makeDocuments() {
+    return {
+        {"coro_0001", {0.2143f, 0.51f, 0.223f}, {{"bookName", Field("西游记")}}},
+        {"coro_0002", {0.256f, 0.687f, 0.2451f}, {{"bookName", Field("三国演义")}}}
+    };
+}
+
+DetachedTask upsertThenSearch(CoroRpcClient* client, std::promise<int>* done) {
+    std::string dbName = "test_db5";
+    std::string collectionName = "test_collection2";
+    std::vector<Document> documents = makeDocuments();
+    UpsertDocumentResult upsertResult;
+    int ret = co_await client->upsert(dbName, collectionName, documents, nullptr, &upsertResult);
+    if (ret != 0) {
+        done->set_value(ret);
+        co_return;
+    }
+
+    SearchDocumentParams params;
+    params.limit = 2;
+    params.retrieveVector = false;
+    SearchDocumentResult searchResult;
+    std::vector<std::vector<float>> vectors = {{0.2143f, 0.51f, 0.223f}};
+    ret = co_await client->search(dbName, collectionName, {}, vectors, {}, &params, &searchResult);
+    if (ret == 0 && searchResult.documents.empty()) {
+        ret = -1;
+    }
+    done->set_value(ret);
+}
+
+}  // namespace
+
+// 回调在start返回前就同步执行: 协程不挂起, 在co_await处直接继续执行
+TEST(RpcClientCoroTest, CompletesBeforeStartReturns) {
+    // start在回调返回后仍会访问自身捕获的状态, 与异步接口发起调用后的收尾工作相同
+    auto touched = std::make_shared<int>(0);
+    auto completeInline = [touched](int ret) {
+        return RpcAwaitable([touched, ret](AsyncCallback cb) {
+            cb(ret);
+            ++*touched;
+        }, nullptr);
+    };
+    std::promise<int> done;
+    awaitTwice(completeInline(1), completeInline(2), &done);
+    EXPECT_EQ(done.get_future().get(), 3);
+    EXPECT_EQ(*touched, 2);
+}
+
+// 回调在其他线程执行, 与start的返回产生竞争
+TEST(RpcClientCoroTest, CompletesOnAnotherThread) {
+    std::mutex mutex;
+    std::vector<std::thread> threads;
+    auto onThread = [&mutex, &threads](int ret) {
+        return RpcAwaitable([&mutex, &threads, ret](AsyncCallback cb) {
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.emplace_back([cb, ret]() { cb(ret); });
+        }, nullptr);
+    };
+    for (int i = 0; i < 100; ++i) {
+        std::promise<int> done;
+        std::future<int> future = done.get_future();
+        awaitTwice(onThread(i), onThread(1), &done);
+        EXPECT_EQ(future.get(), i + 1);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// 调用未同步完成时由执行器恢复协程, 同步完成时协程直接继续执行, 不经过执行器
+TEST(RpcClientCoroTest, ExecutorResumesCoroutine) {
+    std::atomic<int> resumed{0};
+    CoroExecutor executor = [&resumed](std::coroutine_handle<> handle) {
+        ++resumed;
+        handle.resume();
+    };
+    std::promise<AsyncCallback> pending;
+    std::future<AsyncCallback> pendingCallback = pending.get_future();
+    std::promise<int> done;
+    std::future<int> future = done.get_future();
+    awaitTwice(RpcAwaitable([](AsyncCallback cb) { cb(0); }, executor),
+        RpcAwaitable([&pending](AsyncCallback cb) { pending.set_value(std::move(cb)); }, executor), &done);
+    std::thread completer([callback = pendingCallback.get()]() { callback(2); });
+    EXPECT_EQ(future.get(), 2);
+    completer.join();
+    EXPECT_EQ(resumed.load(), 1);
+}
+
+// 同步完成的调用不在回调内恢复协程, 循环co_await不会使栈增长
+TEST(RpcClientCoroTest, InlineCompletionsDoNotGrowStack) {
+    std::promise<int> done;
+    awaitInlineLoop(1000000, &done);
+    EXPECT_EQ(done.get_future().get(), 1000000);
+}
+
+// 参数在调用包装函数时完成序列化, co_await前临时对象已被销毁
+TEST(RpcClientCoroTest, TemporaryArgumentsOutliveCall) {
+    ClientOption option;
+    option.lazyConnect = true;
+    RpcClient client("127.0.0.1:1", "username", "key", &option);
+    CoroRpcClient coClient(&client);
+    UpsertDocumentResult result;
+    std::promise<int> done;
+    std::future<int> future = done.get_future();
+    awaitOne(coClient.upsert("db", "collection", makeDocuments(), nullptr, &result, 100), &done);
+    EXPECT_NE(future.get(), 0);
+    EXPECT_FALSE(result.success);
+}
+
+// 调用完成前销毁CoroRpcClient, 完成队列线程上仍能通过执行器恢复协程
+TEST(RpcClientCoroTest, ClientDestroyedDuringCall) {
+    ClientOption option;
+    option.lazyConnect = true;
+    RpcClient client("127.0.0.1:1", "username", "key", &option);
+    auto resumed = std::make_shared<std::atomic<int>>(0);
+    RebuildIndexResult first;
+    RebuildIndexResult second;
+    std::promise<int> done;
+    std::future<int> future = done.get_future();
+    {
+        CoroRpcClient coClient(&client, [resumed](std::coroutine_handle<> handle) {
+            ++*resumed;
+            handle.resume();
+        });
+        awaitTwice(coClient.rebuildIndex("db", "collection", nullptr, &first, 100),
+            coClient.rebuildIndex("db", "collection", nullptr, &second, 100), &done);
+    }
+    EXPECT_NE(future.get(), 0);
+    EXPECT_EQ(resumed->load(), 2);
+}
+
+TEST(RpcClientCoroTest, UpsertAndSearch) {
+    RpcClient client("url", "username", "key", nullptr);
+    CoroRpcClient coClient(&client);
+    std::promise<int> done;
+    std::future<int> future = done.get_future();
+    upsertThenSearch(&coClient, &done);
+    EXPECT_EQ(future.get(), 0);
+}
+
+}  // namespace vectordb
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <chrono>
 
 #include "include/rpc_client.h"
 #include "tests/rpc_client_test_base.h"
@@ -95,6 +96,31 @@ TEST_F(RpcClientTestBase, DropCollection) {
     EXPECT_FALSE(found);
 }
 
+// 不等待warmup的结果时调用立即返回, 连接在后台建立
+TEST(RpcClientWarmupTest, ReturnsWithoutWaiting) {
+    ClientOption option;
+    option.lazyConnect = true;
+    RpcClient client("127.0.0.1:1", "username", "key", &option);
+    auto start = std::chrono::steady_clock::now();
+    client.warmup(3000);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(1000));
+    EXPECT_FALSE(client.warmup(100).get());
+}
+
+TEST_F(RpcClientTestBase, WarmupCollections) {
+    WarmupResult result;
+    std::vector<std::pair<std::string, std::string>> collections = {
+        {"test_db5", "test_collection2"},
+        {"test_db5", "non_existent_collection"}
+    };
+    int status = client.warmup(collections, &result).get();
+    std::cout << result.message << std::endl;
+
+    EXPECT_NE(status, 0);
+    ASSERT_EQ(result.failedCollections.size(), 1);
+    EXPECT_EQ(result.failedCollections[0], "test_db5/non_existent_collection");
+}
+
 // 边界条件测试 - 删除不存在的集合
 TEST_F(RpcClientTestBase, DropNonExistentCollection) {
     DropCollectionResult result;
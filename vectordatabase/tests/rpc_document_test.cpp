@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 
 #include "include/rpc_client.h"
+#include "include/bulk_writer.h"
+#include "include/buffered_writer.h"
+#include "include/document_batch_builder.h"
 #include "tests/rpc_client_test_base.h"
 
 namespace vectordb {
@@ -73,6 +76,137 @@ TEST_F(RpcClientTestBase, UpsertDocument) {
     EXPECT_GT(result.affectedCount, 0);
 }
 
+TEST(RpcClientTest, UpsertDocumentBatched) {
+    ClientOption option;
+    option.maxBatchBytes = 1024;
+    option.maxBatchParallelism = 2;
+    RpcClient batchClient("url", "username", "key", &option);
+    std::vector<Document> documents;
+    for (int i = 0; i < 20; ++i) {
+        Document doc;
+        doc.id = "batch_" + std::to_string(i);
+        doc.vector = {0.1f * i, 0.2f, 0.3f};
+        doc.fields["segment"] = Field(std::string(200, 'a' + i));
+        documents.push_back(doc);
+    }
+    UpsertDocumentResult result;
+    int status = batchClient.upsert("test_db5", "test_collection2", documents, nullptr, &result);
+    std::cout << result.message << std::endl;
+
+    EXPECT_EQ(status, 0);
+    EXPECT_EQ(result.affectedCount, 20);
+}
+
+TEST(RpcClientTest, UpsertDocumentBatchedWaitsForConcurrencySlot) {
+    ClientOption option;
+    option.maxBatchBytes = 64;
+    option.maxBatchParallelism = 4;
+    option.concurrencyLimit.enabled = true;
+    option.concurrencyLimit.initialLimit = 1;
+    option.concurrencyLimit.maxLimit = 1;
+    RpcClient limitedClient("url", "username", "key", &option);
+    std::vector<Document> documents;
+    for (int i = 0; i < 6; ++i) {
+        Document doc;
+        doc.id = "limited_" + std::to_string(i);
+        doc.vector = {0.1f * i, 0.2f, 0.3f};
+        documents.push_back(doc);
+    }
+    // 拆分后的子请求与单个请求的同步写入一样在超时前等待并发额度, 而不是立即失败
+    UpsertDocumentResult result;
+    int status = limitedClient.upsert("test_db5", "test_collection2", documents, nullptr, &result, 5000);
+    std::cout << result.message << std::endl;
+
+    EXPECT_EQ(status, 0);
+    EXPECT_EQ(result.affectedCount, 6);
+    EXPECT_EQ(limitedClient.getConcurrencyLimiterStats()["test_db5/test_collection2"].rejected, 0u);
+}
+
+TEST(RpcClientTest, UpsertDocumentBatchedInvalidatesSearchCache) {
+    ClientOption option;
+    option.maxBatchBytes = 64;
+    option.searchCache.enabled = true;
+    RpcClient cacheClient("url", "username", "key", &option);
+    SearchDocumentParams params;
+    params.limit = 1;
+    SearchDocumentResult before;
+    EXPECT_EQ(cacheClient.search("test_db5", "test_collection2", {}, {{0.1f, 0.2f, 0.3f}}, {}, &params, &before), 0);
+
+    std::vector<Document> documents;
+    for (int i = 0; i < 4; ++i) {
+        Document doc;
+        doc.id = "cache_" + std::to_string(i);
+        doc.vector = {0.1f * i, 0.2f, 0.3f};
+        documents.push_back(doc);
+    }
+    UpsertDocumentResult result;
+    EXPECT_EQ(cacheClient.upsert("test_db5", "test_collection2", documents, nullptr, &result), 0);
+
+    // 拆分为多个子请求的写入同样需要失效缓存, 之后的检索不能命中旧结果
+    SearchDocumentResult after;
+    EXPECT_EQ(cacheClient.search("test_db5", "test_collection2", {}, {{0.1f, 0.2f, 0.3f}}, {}, &params, &after), 0);
+    SearchCacheStats stats = cacheClient.getSearchCacheStats();
+    EXPECT_EQ(stats.hits, 0);
+    EXPECT_EQ(stats.misses, 2);
+}
+
+TEST_F(RpcClientTestBase, BulkWriteDocuments) {
+    BulkWriterOption option;
+    option.batchDocs = 50;
+    option.maxInFlight = 2;
+    BulkWriter writer(&client, "test_db5", "test_collection2", option);
+    for (int i = 0; i < 500; ++i) {
+        Document doc;
+        doc.id = "bulk_" + std::to_string(i);
+        doc.vector = {0.001f * i, 0.2f, 0.3f};
+        doc.fields["page"] = Field(static_cast<uint64_t>(i));
+        EXPECT_EQ(writer.write(std::move(doc)), 0);
+    }
+    BulkWriterStats stats;
+    int status = writer.close(&stats);
+    std::cout << stats.message << std::endl;
+    std::cout << stats.docsPerSecond << " docs/s, " << stats.bytesPerSecond << " bytes/s" << std::endl;
+
+    EXPECT_EQ(status, 0);
+    EXPECT_EQ(stats.documents, 500);
+    EXPECT_EQ(stats.batches, 10);
+}
+
+TEST_F(RpcClientTestBase, BufferedWriteDocuments) {
+    BufferedWriterOption option;
+    option.maxDocs = 16;
+    option.maxDelay = 20;
+    BufferedWriter writer(&client, "test_db5", "test_collection2", option);
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 40; ++i) {
+        Document doc;
+        doc.id = "buffered_" + std::to_string(i);
+        doc.vector = {0.01f * i, 0.2f, 0.3f};
+        futures.push_back(writer.write(doc));
+    }
+    EXPECT_EQ(writer.flush(), 0);
+    for (auto& future : futures) {
+        EXPECT_EQ(future.get(), 0);
+    }
+}
+
+TEST_F(RpcClientTestBase, UpsertDocumentBatchBuilder) {
+    DocumentBatchBuilder builder("test_db5", "test_collection2");
+    for (int i = 0; i < 10; ++i) {
+        builder.addDocument("builder_" + std::to_string(i))
+            .setVector({0.1f * i, 0.2f, 0.3f})
+            .addFieldStr("bookName", "西游记")
+            .addFieldU64("page", static_cast<uint64_t>(i));
+    }
+    ASSERT_EQ(builder.status(), 0) << builder.message();
+    UpsertDocumentResult result;
+    int status = client.upsert(builder.request(), &result);
+    std::cout << result.message << std::endl;
+
+    EXPECT_EQ(status, 0);
+    EXPECT_EQ(result.affectedCount, 10);
+}
+
 TEST_F(RpcClientTestBase, QueryDocument) {
     QueryDocumentResult result;
     std::vector<std::string> documentIds;
@@ -106,6 +240,21 @@ TEST_F(RpcClientTestBase, SearchDocument) {
 }
 
 
+TEST_F(RpcClientTestBase, SearchDocumentMatrix) {
+    SearchDocumentResult result;
+    SearchDocumentParams* params = new SearchDocumentParams();
+    params->retrieveVector = false;
+    params->limit = 10;
+    // 两行三维向量, 每行后有一个填充元素
+    float buffer[] = {0.3123f, 0.43f, 0.213f, 0.0f, 0.233f, 0.12f, 0.97f, 0.0f};
+    VectorMatrixView vectors{buffer, 2, 3, 4};
+    int status = client.search("test_db5", "test_collection2", vectors, params, &result);
+    std::cout << result.message << std::endl;
+    EXPECT_EQ(status, 0);
+
+    ASSERT_EQ(result.documents.size(), 2);
+}
+
 TEST_F(RpcClientTestBase, SearchDocumentById) {
     SearchDocumentResult result;
     SearchDocumentParams* params = new SearchDocumentParams();
@@ -122,6 +271,35 @@ TEST_F(RpcClientTestBase, SearchDocumentById) {
     ASSERT_GT(result.documents.size(), 0);
 }
 
+TEST_F(RpcClientTestBase, SearchDocumentAsync) {
+    SearchDocumentParams* params = new SearchDocumentParams();
+    params->retrieveVector = false;
+    params->limit = 10;
+    std::vector<std::vector<float>> vectors = {
+        {0.3123, 0.43, 0.213}
+    };
+    std::vector<SearchDocumentResult> results(8);
+    std::vector<std::future<int>> futures;
+    for (auto& result : results) {
+        futures.push_back(client.searchAsync("test_db5", "test_collection2", {}, vectors, {}, params, &result));
+    }
+    for (size_t i = 0; i < futures.size(); ++i) {
+        EXPECT_EQ(futures[i].get(), 0);
+        ASSERT_FALSE(results[i].documents.empty());
+    }
+}
+
+TEST_F(RpcClientTestBase, QueryDocumentAsyncCallback) {
+    QueryDocumentResult result;
+    QueryDocumentParams* params = new QueryDocumentParams();
+    params->limit = 100;
+    std::promise<int> done;
+    client.queryAsync("test_db5", "test_collection2", {}, params, &result,
+        [&done](int status) { done.set_value(status); });
+    EXPECT_EQ(done.get_future().get(), 0);
+    EXPECT_GT(result.documents.size(), 0);
+}
+
 TEST_F(RpcClientTestBase, DeleteDocument) {
     DeleteDocumentResult result;
     DeleteDocumentParams* deleteParams = new DeleteDocumentParams();
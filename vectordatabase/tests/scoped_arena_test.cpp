@@ -0,0 +1,117 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include "include/scoped_arena.h"
+#include "proto/olama.pb.h"
+
+namespace vectordb {
+
+TEST(ScopedArenaTest, ReusesThreadBlock) {
+    const void* first = nullptr;
+    {
+        ScopedArena arena;
+        olama::SearchRequest& request = arena.create<olama::SearchRequest>();
+        EXPECT_EQ(request.GetArena(), arena.get());
+        first = &request;
+    }
+    {
+        ScopedArena arena;
+        olama::SearchRequest& request = arena.create<olama::SearchRequest>();
+        EXPECT_EQ(static_cast<const void*>(&request), first);
+    }
+}
+
+TEST(ScopedArenaTest, Nested) {
+    ScopedArena outer;
+    olama::SearchRequest& request = outer.create<olama::SearchRequest>();
+    request.set_database("outer");
+    {
+        ScopedArena inner;
+        olama::SearchRequest& nested = inner.create<olama::SearchRequest>();
+        nested.set_database("inner");
+        EXPECT_NE(static_cast<void*>(&nested), static_cast<void*>(&request));
+    }
+    EXPECT_EQ(request.database(), "outer");
+}
+
+TEST(ScopedArenaTest, GrowsWithUsage) {
+    {
+        ScopedArena arena;
+        olama::SearchRequest& request = arena.create<olama::SearchRequest>();
+        for (int i = 0; i < 1000; ++i) {
+            request.mutable_search()->add_vectors()->mutable_vector()->Resize(128, 0.5f);
+        }
+    }
+    ScopedArena arena;
+    EXPECT_GE(arena.get()->SpaceAllocated(), 1000 * 128 * sizeof(float));
+}
+
+TEST(ScopedArenaTest, ShrinksAfterSmallCalls) {
+    {
+        ScopedArena arena;
+        olama::SearchRequest& request = arena.create<olama::SearchRequest>();
+        for (int i = 0; i < 1000; ++i) {
+            request.mutable_search()->add_vectors()->mutable_vector()->Resize(128, 0.5f);
+        }
+    }
+    for (int i = 0; i < ScopedArena::kShrinkAfterCalls; ++i) {
+        ScopedArena arena;
+        arena.create<olama::SearchRequest>().set_database("db");
+    }
+    ScopedArena arena;
+    EXPECT_LT(arena.get()->SpaceAllocated(), 1000 * 128 * sizeof(float));
+}
+
+TEST(ScopedArenaTest, CachedBlockIsCapped) {
+    {
+        ScopedArena arena;
+        olama::SearchRequest& request = arena.create<olama::SearchRequest>();
+        for (int i = 0; i < 4000; ++i) {
+            request.mutable_search()->add_vectors()->mutable_vector()->Resize(128, 0.5f);
+        }
+    }
+    ScopedArena arena;
+    EXPECT_LE(arena.get()->SpaceAllocated(), ScopedArena::kMaxCachedBlockSize);
+}
+
+TEST(ScopedArenaTest, ReleaseThreadCache) {
+    {
+        ScopedArena arena;
+        olama::SearchRequest& request = arena.create<olama::SearchRequest>();
+        for (int i = 0; i < 1000; ++i) {
+            request.mutable_search()->add_vectors()->mutable_vector()->Resize(128, 0.5f);
+        }
+    }
+    ScopedArena::releaseThreadCache();
+    ScopedArena arena;
+    EXPECT_LT(arena.get()->SpaceAllocated(), 1000 * 128 * sizeof(float));
+}
+
+}  // namespace vectordb
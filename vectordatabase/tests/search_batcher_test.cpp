@@ -0,0 +1,136 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <future>
+#include <mutex>
+#include <vector>
+
+#include "include/search_batcher.h"
+
+namespace vectordb {
+
+namespace {
+
+struct SentBatch {
+    olama::SearchRequest request;
+    SearchDocumentResult* result;
+    std::function<void(int)> done;
+};
+
+}  // namespace
+
+TEST(SearchBatcherTest, MergesSameShape) {
+    std::mutex mutex;
+    std::vector<SentBatch> sent;
+    // 析构时发送的批次立即失败, 避免等待未完成的请求
+    bool completeOnSend = false;
+    std::vector<SearchDocumentResult> results(4);
+    std::vector<int> statuses(4, 1);
+    SearchBatchingPolicy policy;
+    policy.enabled = true;
+    policy.maxBatch = 3;
+    policy.maxDelayUs = 60 * 1000 * 1000;
+    SearchBatcher batcher(policy, [&](const olama::SearchRequest& request, int, SearchDocumentResult* result,
+                                      std::function<void(int)> done) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (completeOnSend) {
+            done(-1);
+            return;
+        }
+        sent.push_back({request, result, std::move(done)});
+    });
+
+    olama::SearchRequest shape;
+    shape.set_collection("c");
+    shape.mutable_search()->set_limit(5);
+    olama::SearchRequest other = shape;
+    other.mutable_search()->set_filter("page > 1");
+
+    float vectors[4][2] = {{0, 0}, {1, 1}, {2, 2}, {3, 3}};
+    batcher.submit(shape, vectors[0], 2, 1000, &results[0], [&](int ret) { statuses[0] = ret; });
+    batcher.submit(other, vectors[1], 2, 1000, &results[1], [&](int ret) { statuses[1] = ret; });
+    batcher.submit(shape, vectors[2], 2, 1000, &results[2], [&](int ret) { statuses[2] = ret; });
+    batcher.submit(shape, vectors[3], 2, 1000, &results[3], [&](int ret) { statuses[3] = ret; });
+
+    std::vector<SentBatch> batches;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_EQ(sent.size(), 1);
+        batches.swap(sent);
+    }
+    const olama::SearchCond& cond = batches[0].request.search();
+    ASSERT_EQ(cond.vectors_size(), 3);
+    EXPECT_EQ(cond.limit(), 5);
+    EXPECT_FLOAT_EQ(cond.vectors(1).vector(0), 2);
+
+    // 按向量顺序分发结果
+    for (int i = 0; i < 3; ++i) {
+        Document doc;
+        doc.id = std::to_string(i);
+        batches[0].result->documents.push_back({doc});
+    }
+    batches[0].done(0);
+    EXPECT_EQ(statuses[0], 0);
+    EXPECT_EQ(statuses[1], 1);
+    EXPECT_EQ(results[2].documents[0][0].id, "1");
+    EXPECT_EQ(results[3].documents[0][0].id, "2");
+
+    SearchBatchStats stats = batcher.stats();
+    EXPECT_EQ(stats.searches, 4);
+    EXPECT_EQ(stats.batches, 1);
+    std::lock_guard<std::mutex> lock(mutex);
+    completeOnSend = true;
+}
+
+TEST(SearchBatcherTest, SendsAfterDelay) {
+    std::mutex mutex;
+    std::vector<SentBatch> sent;
+    SearchBatchingPolicy policy;
+    policy.enabled = true;
+    policy.maxDelayUs = 1000;
+    SearchBatcher batcher(policy, [&](const olama::SearchRequest& request, int, SearchDocumentResult* result,
+                                      std::function<void(int)> done) {
+        done(-1);
+        std::lock_guard<std::mutex> lock(mutex);
+        sent.push_back({request, result, nullptr});
+    });
+    olama::SearchRequest shape;
+    float vector[1] = {1};
+    SearchDocumentResult result;
+    std::promise<int> promise;
+    batcher.submit(shape, vector, 1, 1000, &result, [&](int ret) { promise.set_value(ret); });
+    std::future<int> future = promise.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(future.get(), -1);
+    EXPECT_FALSE(result.success);
+}
+
+}  // namespace vectordb
@@ -0,0 +1,159 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "include/search_cache.h"
+
+namespace vectordb {
+
+namespace {
+
+olama::SearchRequest makeRequest(const std::string& collection, float value) {
+    olama::SearchRequest request;
+    request.set_database("db");
+    request.set_collection(collection);
+    request.mutable_search()->set_limit(10);
+    request.mutable_search()->add_vectors()->add_vector(value);
+    return request;
+}
+
+std::vector<std::vector<Document>> makeDocuments(const std::string& id, size_t padding = 0) {
+    Document doc;
+    doc.id = id;
+    doc.score = 0.5f;
+    doc.fields["text"] = Field(std::string(padding, 'x'));
+    return {{doc}};
+}
+
+}  // namespace
+
+TEST(SearchResultCacheTest, HitAppendsCachedDocuments) {
+    SearchCachePolicy policy;
+    policy.enabled = true;
+    SearchResultCache cache(policy);
+    std::string key = SearchResultCache::key(makeRequest("c", 1));
+
+    SearchDocumentResult result;
+    EXPECT_FALSE(cache.lookup(key, "db", "c", &result));
+    cache.insert(key, "db", "c", cache.version("db", "c"), makeDocuments("a"), "w");
+
+    result.documents.push_back({});
+    ASSERT_TRUE(cache.lookup(key, "db", "c", &result));
+    EXPECT_TRUE(result.success);
+    EXPECT_EQ(result.warning, "w");
+    ASSERT_EQ(result.documents.size(), 2u);
+    ASSERT_EQ(result.documents[1].size(), 1u);
+    EXPECT_EQ(result.documents[1][0].id, "a");
+
+    // 向量或参数不同的请求不会命中
+    SearchDocumentResult other;
+    EXPECT_FALSE(cache.lookup(SearchResultCache::key(makeRequest("c", 2)), "db", "c", &other));
+
+    SearchCacheStats stats = cache.stats();
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.misses, 2);
+    EXPECT_EQ(stats.entries, 1);
+    EXPECT_GT(stats.bytes, 0);
+}
+
+TEST(SearchResultCacheTest, WritesInvalidateCollection) {
+    SearchCachePolicy policy;
+    policy.enabled = true;
+    SearchResultCache cache(policy);
+    std::string keyA = SearchResultCache::key(makeRequest("a", 1));
+    std::string keyB = SearchResultCache::key(makeRequest("b", 1));
+    cache.insert(keyA, "db", "a", cache.version("db", "a"), makeDocuments("1"), "");
+    cache.insert(keyB, "db", "b", cache.version("db", "b"), makeDocuments("2"), "");
+
+    cache.invalidate("db", "a");
+    SearchDocumentResult result;
+    EXPECT_FALSE(cache.lookup(keyA, "db", "a", &result));
+    EXPECT_TRUE(cache.lookup(keyB, "db", "b", &result));
+
+    cache.invalidate("db");
+    EXPECT_FALSE(cache.lookup(keyB, "db", "b", &result));
+    EXPECT_EQ(cache.stats().invalidations, 2);
+
+    // 检索期间发生写操作, 结果不写入缓存
+    uint64_t version = cache.version("db", "a");
+    cache.invalidate("db", "a");
+    cache.insert(keyA, "db", "a", version, makeDocuments("1"), "");
+    EXPECT_FALSE(cache.lookup(keyA, "db", "a", &result));
+}
+
+TEST(SearchResultCacheTest, Expires) {
+    SearchCachePolicy policy;
+    policy.enabled = true;
+    policy.ttl = 20;
+    SearchResultCache cache(policy);
+    std::string key = SearchResultCache::key(makeRequest("c", 1));
+    cache.insert(key, "db", "c", cache.version("db", "c"), makeDocuments("a"), "");
+
+    SearchDocumentResult result;
+    EXPECT_TRUE(cache.lookup(key, "db", "c", &result));
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    EXPECT_FALSE(cache.lookup(key, "db", "c", &result));
+    EXPECT_EQ(cache.stats().expirations, 1);
+}
+
+TEST(SearchResultCacheTest, EvictsLeastRecentlyUsed) {
+    SearchCachePolicy policy;
+    policy.enabled = true;
+    policy.shards = 1;
+    policy.maxBytes = 2500;
+    SearchResultCache cache(policy);
+    std::vector<std::string> keys;
+    for (int i = 0; i < 3; ++i) {
+        keys.push_back(SearchResultCache::key(makeRequest("c", i)));
+    }
+    cache.insert(keys[0], "db", "c", 0, makeDocuments("0", 600), "");
+    cache.insert(keys[1], "db", "c", 0, makeDocuments("1", 600), "");
+    SearchDocumentResult result;
+    ASSERT_TRUE(cache.lookup(keys[0], "db", "c", &result));
+
+    // 超出内存上限时淘汰最久未使用的keys[1]
+    cache.insert(keys[2], "db", "c", 0, makeDocuments("2", 600), "");
+    EXPECT_TRUE(cache.lookup(keys[0], "db", "c", &result));
+    EXPECT_FALSE(cache.lookup(keys[1], "db", "c", &result));
+    EXPECT_TRUE(cache.lookup(keys[2], "db", "c", &result));
+    SearchCacheStats stats = cache.stats();
+    EXPECT_EQ(stats.evictions, 1);
+    EXPECT_LE(stats.bytes, 2500);
+
+    // 单个结果超过上限时不缓存
+    cache.insert(keys[1], "db", "c", 0, makeDocuments("1", 4000), "");
+    EXPECT_FALSE(cache.lookup(keys[1], "db", "c", &result));
+}
+
+}  // namespace vectordb
@@ -0,0 +1,80 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include "include/search_result_view.h"
+
+namespace vectordb {
+
+TEST(SearchResultViewTest, DocumentView) {
+    olama::Document document;
+    document.set_id("doc-1");
+    document.set_score(0.75f);
+    document.add_vector(1.0f);
+    document.add_vector(2.0f);
+    (*document.mutable_fields())["page"].set_val_u64(3);
+    (*document.mutable_fields())["title"].set_val_str("hello");
+
+    DocumentView view(document);
+    EXPECT_EQ(view.id(), "doc-1");
+    EXPECT_FLOAT_EQ(view.score(), 0.75f);
+    // id和向量直接引用响应中的数据
+    EXPECT_EQ(view.id().data(), document.id().data());
+    ASSERT_EQ(view.vector().size, 2u);
+    EXPECT_EQ(view.vector().data, document.vector().data());
+    EXPECT_FLOAT_EQ(view.vector()[1], 2.0f);
+
+    Field field;
+    EXPECT_TRUE(view.hasField("page"));
+    ASSERT_TRUE(view.field("page", &field));
+    EXPECT_EQ(field.getValU64(), 3u);
+    EXPECT_FALSE(view.hasField("missing"));
+    EXPECT_FALSE(view.field("missing", &field));
+
+    Document converted = view.toDocument();
+    EXPECT_EQ(converted.id, "doc-1");
+    EXPECT_EQ(converted.vector, (std::vector<float>{1.0f, 2.0f}));
+    EXPECT_EQ(converted.fields.at("title").getValStr(), "hello");
+}
+
+TEST(SearchResultViewTest, EmptyView) {
+    SearchResultView view;
+    EXPECT_EQ(view.size(), 0u);
+    EXPECT_TRUE(view.warning().empty());
+    EXPECT_EQ(view.response(), nullptr);
+
+    SearchDocumentResult result;
+    view.message = "not searched";
+    view.toResult(&result);
+    EXPECT_FALSE(result.success);
+    EXPECT_EQ(result.message, "not searched");
+    EXPECT_TRUE(result.documents.empty());
+}
+
+}  // namespace vectordb
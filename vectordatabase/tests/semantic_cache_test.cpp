@@ -0,0 +1,170 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "include/semantic_cache.h"
+
+namespace vectordb {
+
+namespace {
+
+olama::SearchRequest makeRequest(const std::vector<float>& vector, const std::string& filter = "") {
+    olama::SearchRequest request;
+    request.set_database("db");
+    request.set_collection("c");
+    request.mutable_search()->set_limit(10);
+    request.mutable_search()->set_filter(filter);
+    auto* values = request.mutable_search()->add_vectors()->mutable_vector();
+    values->Add(vector.begin(), vector.end());
+    return request;
+}
+
+std::vector<Document> makeDocuments(const std::string& id, float score) {
+    Document doc;
+    doc.id = id;
+    doc.score = score;
+    return {doc};
+}
+
+// 查询未命中时以documents写入缓存
+bool lookupOrInsert(SemanticSearchCache* cache, const olama::SearchRequest& request,
+    const std::vector<Document>& documents, SearchDocumentResult* result) {
+    SemanticCacheProbe probe;
+    if (cache->lookup(request, result, &probe)) {
+        return true;
+    }
+    cache->insert(probe, documents, "");
+    return false;
+}
+
+}  // namespace
+
+TEST(SemanticSearchCacheTest, Cacheable) {
+    EXPECT_TRUE(SemanticSearchCache::cacheable(makeRequest({1, 0})));
+    olama::SearchRequest multi = makeRequest({1, 0});
+    multi.mutable_search()->add_vectors()->add_vector(1);
+    EXPECT_FALSE(SemanticSearchCache::cacheable(multi));
+    olama::SearchRequest ids;
+    ids.mutable_search()->add_documentids("a");
+    EXPECT_FALSE(SemanticSearchCache::cacheable(ids));
+}
+
+TEST(SemanticSearchCacheTest, ServesNearbyVectors) {
+    SemanticCachePolicy policy;
+    policy.enabled = true;
+    policy.verifyRate = 0;
+    SemanticSearchCache cache(policy);
+
+    SearchDocumentResult result;
+    EXPECT_FALSE(lookupOrInsert(&cache, makeRequest({1, 0, 0, 0}), makeDocuments("a", 1), &result));
+    // 仅末位有差异的向量命中
+    ASSERT_TRUE(lookupOrInsert(&cache, makeRequest({1, 0.001f, 0, 0}), makeDocuments("b", 1), &result));
+    ASSERT_EQ(result.documents.size(), 1u);
+    EXPECT_EQ(result.documents[0][0].id, "a");
+    EXPECT_TRUE(result.success);
+
+    // 方向不同或过滤条件不同时不命中
+    EXPECT_FALSE(lookupOrInsert(&cache, makeRequest({0, 1, 0, 0}), makeDocuments("c", 1), &result));
+    EXPECT_FALSE(lookupOrInsert(&cache, makeRequest({1, 0, 0, 0}, "a=1"), makeDocuments("d", 1), &result));
+
+    SemanticCacheStats stats = cache.stats();
+    EXPECT_EQ(stats.lookups, 4);
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_DOUBLE_EQ(stats.hitRate, 0.25);
+    EXPECT_EQ(stats.entries, 3);
+}
+
+TEST(SemanticSearchCacheTest, L2Threshold) {
+    SemanticCachePolicy policy;
+    policy.enabled = true;
+    policy.metric = SemanticMetric::kL2;
+    policy.threshold = 0.1f;
+    policy.verifyRate = 0;
+    SemanticSearchCache cache(policy);
+
+    SearchDocumentResult result;
+    EXPECT_FALSE(lookupOrInsert(&cache, makeRequest({1, 1}), makeDocuments("a", 1), &result));
+    EXPECT_TRUE(lookupOrInsert(&cache, makeRequest({1.05f, 1}), makeDocuments("b", 1), &result));
+    // 方向相同但距离超过阈值
+    EXPECT_FALSE(lookupOrInsert(&cache, makeRequest({2, 2}), makeDocuments("c", 1), &result));
+}
+
+TEST(SemanticSearchCacheTest, InvalidatedByWrites) {
+    SemanticCachePolicy policy;
+    policy.enabled = true;
+    policy.verifyRate = 0;
+    SemanticSearchCache cache(policy);
+
+    SearchDocumentResult result;
+    lookupOrInsert(&cache, makeRequest({1, 0}), makeDocuments("a", 1), &result);
+    cache.invalidate("db", "c");
+    EXPECT_FALSE(lookupOrInsert(&cache, makeRequest({1, 0}), makeDocuments("b", 1), &result));
+    EXPECT_TRUE(lookupOrInsert(&cache, makeRequest({1, 0}), makeDocuments("c", 1), &result));
+    EXPECT_EQ(result.documents.back()[0].id, "b");
+}
+
+TEST(SemanticSearchCacheTest, VerificationTracksScoreDrift) {
+    SemanticCachePolicy policy;
+    policy.enabled = true;
+    policy.verifyRate = 1;
+    SemanticSearchCache cache(policy);
+
+    SearchDocumentResult result;
+    lookupOrInsert(&cache, makeRequest({1, 0}), makeDocuments("a", 0.9f), &result);
+    // 抽样校验的检索不使用缓存结果, 以实际结果更新缓存
+    EXPECT_FALSE(lookupOrInsert(&cache, makeRequest({1, 0.01f}), makeDocuments("a", 0.8f), &result));
+    EXPECT_FALSE(lookupOrInsert(&cache, makeRequest({1, 0.01f}), makeDocuments("a", 0.8f), &result));
+
+    SemanticCacheStats stats = cache.stats();
+    EXPECT_EQ(stats.hits, 0);
+    EXPECT_EQ(stats.verifications, 2);
+    EXPECT_NEAR(stats.maxScoreDrift, 0.1, 1e-6);
+    EXPECT_NEAR(stats.meanScoreDrift, 0.05, 1e-6);
+}
+
+TEST(SemanticSearchCacheTest, ReplacesOldestEntries) {
+    SemanticCachePolicy policy;
+    policy.enabled = true;
+    policy.verifyRate = 0;
+    policy.maxEntries = 2;
+    SemanticSearchCache cache(policy);
+
+    SearchDocumentResult result;
+    lookupOrInsert(&cache, makeRequest({1, 0, 0}), makeDocuments("x", 1), &result);
+    lookupOrInsert(&cache, makeRequest({0, 1, 0}), makeDocuments("y", 1), &result);
+    lookupOrInsert(&cache, makeRequest({0, 0, 1}), makeDocuments("z", 1), &result);
+    EXPECT_EQ(cache.stats().entries, 2);
+    EXPECT_FALSE(lookupOrInsert(&cache, makeRequest({1, 0, 0}), makeDocuments("x", 1), &result));
+    EXPECT_TRUE(lookupOrInsert(&cache, makeRequest({0, 0, 1}), makeDocuments("z", 1), &result));
+}
+
+}  // namespace vectordb
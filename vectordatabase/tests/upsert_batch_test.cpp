@@ -0,0 +1,168 @@
+/*
+  *Copyright (c) 2024, Tencent. All rights reserved.
+  *
+  *Redistribution and use in source and binary forms, with or without
+  *modification, are permitted provided that the following conditions are met:
+  *
+  *  * Redistributions of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  *  * Redistributions in binary form must reproduce the above copyright
+  *    notice, this list of conditions and the following disclaimer in the
+  *    documentation and/or other materials provided with the distribution.
+  *  * Neither the name of elasticfaiss nor the names of its contributors may be used
+  *    to endorse or promote products derived from this software without
+  *    specific prior written permission.
+  *
+  *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+  *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+  *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+  *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+  *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+  *THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "include/rpc_client.h"
+#include "tests/fake_search_engine.h"
+
+namespace vectordb {
+
+namespace {
+
+// 记录服务端收到的upsert请求
+struct UpsertRecorder {
+    std::mutex mutex;
+    std::vector<olama::UpsertRequest> requests;
+
+    void install(FakeSearchEngine* service) {
+        service->onUpsert = [this](grpc::ServerContext*, const olama::UpsertRequest& request,
+            olama::UpsertResponse* response) {
+            std::lock_guard<std::mutex> lock(mutex);
+            requests.push_back(request);
+            response->set_affectedcount(request.documents_size());
+            return grpc::Status::OK;
+        };
+    }
+};
+
+Document makeDocument(int i, size_t fieldBytes) {
+    Document doc;
+    doc.id = "doc_" + std::to_string(i);
+    doc.vector = {0.1f * i, 0.2f, 0.3f};
+    doc.fields["segment"] = Field(std::string(fieldBytes, 'a'));
+    return doc;
+}
+
+}  // namespace
+
+// 按maxBatchBytes拆分请求, 超过上限的单个文档独占一个请求
+TEST(UpsertBatchTest, SplitsAtMaxBatchBytes) {
+    FakeSearchEngine service;
+    UpsertRecorder recorder;
+    recorder.install(&service);
+    FakeServer server(&service);
+    ClientOption option;
+    option.maxBatchBytes = 1024;
+    RpcClient client(server.url(), "username", "key", &option);
+
+    std::vector<Document> documents;
+    for (int i = 0; i < 20; ++i) {
+        documents.push_back(makeDocument(i, 200));
+    }
+    documents.push_back(makeDocument(20, 4096));
+    UpsertDocumentResult result;
+    ASSERT_EQ(client.upsert("db", "collection", documents, nullptr, &result), 0) << result.message;
+    EXPECT_EQ(result.affectedCount, 21);
+
+    std::set<std::string> ids;
+    int oversized = 0;
+    for (const auto& request : recorder.requests) {
+        EXPECT_GT(request.documents_size(), 0);
+        if (request.ByteSizeLong() > 1024) {
+            ++oversized;
+            ASSERT_EQ(request.documents_size(), 1);
+            EXPECT_EQ(request.documents(0).id(), "doc_20");
+        }
+        for (const auto& doc : request.documents()) {
+            ids.insert(doc.id());
+        }
+    }
+    EXPECT_EQ(oversized, 1);
+    EXPECT_GT(recorder.requests.size(), 2u);
+    EXPECT_EQ(ids.size(), 21u);
+}
+
+// maxBatchBytes不大于0时不拆分
+TEST(UpsertBatchTest, NoSplitWithoutBudget) {
+    FakeSearchEngine service;
+    UpsertRecorder recorder;
+    recorder.install(&service);
+    FakeServer server(&service);
+    ClientOption option;
+    option.maxBatchBytes = 0;
+    RpcClient client(server.url(), "username", "key", &option);
+
+    std::vector<Document> documents;
+    for (int i = 0; i < 10; ++i) {
+        documents.push_back(makeDocument(i, 1024));
+    }
+    UpsertDocumentResult result;
+    ASSERT_EQ(client.upsert("db", "collection", documents, nullptr, &result), 0) << result.message;
+    ASSERT_EQ(recorder.requests.size(), 1u);
+    EXPECT_EQ(recorder.requests[0].documents_size(), 10);
+}
+
+// 首个失败的子请求之后不再发送剩余的子请求, 错误信息中带有成功的子请求数
+TEST(UpsertBatchTest, StopsAtFirstFailure) {
+    FakeSearchEngine service;
+    std::mutex mutex;
+    int received = 0;
+    service.onUpsert = [&](grpc::ServerContext*, const olama::UpsertRequest& request,
+        olama::UpsertResponse* response) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (++received == 2) {
+            response->set_code(1);
+            response->set_msg("disk full");
+        } else {
+            response->set_affectedcount(request.documents_size());
+        }
+        return grpc::Status::OK;
+    };
+    FakeServer server(&service);
+    ClientOption option;
+    option.maxBatchBytes = 64;
+    option.maxBatchParallelism = 1;
+    RpcClient client(server.url(), "username", "key", &option);
+
+    std::vector<Document> documents;
+    for (int i = 0; i < 5; ++i) {
+        documents.push_back(makeDocument(i, 100));
+    }
+    UpsertDocumentResult result;
+    EXPECT_NE(client.upsert("db", "collection", documents, nullptr, &result), 0);
+    EXPECT_FALSE(result.success);
+    EXPECT_EQ(result.affectedCount, 1);
+    EXPECT_NE(result.message.find("disk full"), std::string::npos) << result.message;
+    EXPECT_NE(result.message.find("(1/5 batches succeeded)"), std::string::npos) << result.message;
+    EXPECT_EQ(received, 2);
+
+    // 异步接口同样在首个失败后停止
+    received = 0;
+    UpsertDocumentResult asyncResult;
+    EXPECT_NE(client.upsertAsync("db", "collection", documents, nullptr, &asyncResult).get(), 0);
+    EXPECT_NE(asyncResult.message.find("(1/5 batches succeeded)"), std::string::npos) << asyncResult.message;
+    EXPECT_EQ(received, 2);
+}
+
+}  // namespace vectordb